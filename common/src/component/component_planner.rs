@@ -53,6 +53,25 @@ impl CollectSkipper {
         true
     }
 
+    /// Returns the number of instructions still to be skipped.
+    pub fn pending(&self) -> u64 {
+        if self.skipping {
+            self.skip.saturating_sub(self.skipped)
+        } else {
+            0
+        }
+    }
+
+    /// Marks `count` instructions as skipped without seeing them, used when the collection
+    /// resumes from a chunk checkpoint placed after them.
+    ///
+    /// # Arguments
+    /// * `count` - The number of instructions already skipped, at most `pending()`.
+    pub fn fast_forward(&mut self, count: u64) {
+        debug_assert!(count <= self.pending());
+        self.skipped += count;
+    }
+
     #[inline(always)]
     pub fn should_skip_query(&mut self, apply: bool) -> bool {
         if !self.skipping {
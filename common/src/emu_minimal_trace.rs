@@ -1,8 +1,13 @@
 //! Emulator trace
 
-use std::fmt::{Debug, Formatter};
+use std::{
+    any::Any,
+    fmt::{Debug, Formatter},
+    ops::Deref,
+    sync::Arc,
+};
 
-use zisk_core::REGS_IN_MAIN_TOTAL_NUMBER;
+use zisk_core::{ZiskOperationType, REGS_IN_MAIN_TOTAL_NUMBER};
 
 /// Trace data at the beginning of the program execution: pc, sp, c and step.
 #[repr(C)]
@@ -26,6 +31,24 @@ impl Default for EmuTraceStart {
     }
 }
 
+/// Number of operation types counted by an `EmuChunkCheckpoint`, all the ones written to the
+/// operation bus.
+pub const CHECKPOINT_OP_TYPES: usize = ZiskOperationType::FcallParam as usize;
+
+/// Snapshot of the replay of a chunk taken during the count phase, so the collection can resume
+/// the chunk from it instead of replaying it from the first step.
+#[derive(Debug, Clone)]
+pub struct EmuChunkCheckpoint {
+    /// Emulator state at the checkpoint
+    pub state: EmuTraceStart,
+    /// Number of steps of the chunk before the checkpoint
+    pub chunk_steps: u64,
+    /// Index of the next memory read of the chunk
+    pub mem_reads_index: usize,
+    /// Operations written to the operation bus before the checkpoint, by operation type
+    pub op_counts: [u64; CHECKPOINT_OP_TYPES],
+}
+
 /// Trace data of a complete program execution (start, steps, and end) or of a segment of a program
 /// execution (also includes last_state).
 #[repr(C)]
@@ -38,7 +61,7 @@ pub struct EmuTrace {
     /// Number of steps executed
     pub steps: u64,
     /// Memory reads
-    pub mem_reads: Vec<u64>,
+    pub mem_reads: MemReads,
 
     /// If the `end` flag is true, the program executed completely.
     /// This does not mean that the program ended successfully; it could have found an error condition
@@ -69,3 +92,112 @@ impl Debug for EmuTrace {
             .finish()
     }
 }
+
+/// Memory reads of an `EmuTrace`.
+///
+/// The emulator generates them into an owned vector. The assembly runner leaves them where the
+/// assembly emulator wrote them, in its shared memory, and the trace borrows them from there.
+#[derive(Clone)]
+pub enum MemReads {
+    /// Memory reads owned by the trace
+    Owned(Vec<u64>),
+    /// Memory reads borrowed from a memory mapping
+    Mapped(MappedMemReads),
+}
+
+/// Memory reads borrowed from a memory mapping, which `owner` keeps mapped and unmodified while
+/// any trace borrows from it.
+#[derive(Clone)]
+pub struct MappedMemReads {
+    ptr: *const u64,
+    len: usize,
+    owner: Arc<dyn Any + Send + Sync>,
+}
+
+// SAFETY: the memory reads are never modified while borrowed, see `MemReads::from_mapping`
+unsafe impl Send for MappedMemReads {}
+unsafe impl Sync for MappedMemReads {}
+
+impl MemReads {
+    /// Creates memory reads that borrow `len` values at `ptr` from a mapping.
+    ///
+    /// # Safety
+    /// `ptr` must be aligned and point to `len` initialized values that stay mapped and are not
+    /// modified while `owner` is alive.
+    pub unsafe fn from_mapping(
+        owner: Arc<dyn Any + Send + Sync>,
+        ptr: *const u64,
+        len: usize,
+    ) -> Self {
+        if len == 0 {
+            return MemReads::Owned(Vec::new());
+        }
+        MemReads::Mapped(MappedMemReads { ptr, len, owner })
+    }
+
+    /// Returns `true` if the memory reads are borrowed from a mapping.
+    pub fn is_mapped(&self) -> bool {
+        matches!(self, MemReads::Mapped(_))
+    }
+
+    /// Returns the owner of the mapping the memory reads are borrowed from, if any.
+    pub fn mapping_owner(&self) -> Option<&Arc<dyn Any + Send + Sync>> {
+        match self {
+            MemReads::Owned(_) => None,
+            MemReads::Mapped(mapped) => Some(&mapped.owner),
+        }
+    }
+
+    /// Returns the owned memory reads, copying them out of the mapping first if they are borrowed.
+    #[inline(always)]
+    pub fn to_mut(&mut self) -> &mut Vec<u64> {
+        if let MemReads::Mapped(mapped) = self {
+            *self = MemReads::Owned(mapped.to_vec());
+        }
+        match self {
+            MemReads::Owned(mem_reads) => mem_reads,
+            MemReads::Mapped(_) => unreachable!(),
+        }
+    }
+}
+
+impl MappedMemReads {
+    #[inline(always)]
+    fn as_slice(&self) -> &[u64] {
+        // SAFETY: see `MemReads::from_mapping`
+        unsafe { std::slice::from_raw_parts(self.ptr, self.len) }
+    }
+}
+
+impl Deref for MappedMemReads {
+    type Target = [u64];
+
+    #[inline(always)]
+    fn deref(&self) -> &[u64] {
+        self.as_slice()
+    }
+}
+
+impl Default for MemReads {
+    fn default() -> Self {
+        MemReads::Owned(Vec::new())
+    }
+}
+
+impl From<Vec<u64>> for MemReads {
+    fn from(mem_reads: Vec<u64>) -> Self {
+        MemReads::Owned(mem_reads)
+    }
+}
+
+impl Deref for MemReads {
+    type Target = [u64];
+
+    #[inline(always)]
+    fn deref(&self) -> &[u64] {
+        match self {
+            MemReads::Owned(mem_reads) => mem_reads,
+            MemReads::Mapped(mapped) => mapped.as_slice(),
+        }
+    }
+}
@@ -28,12 +28,53 @@ struct ExecutorStatsEntry {
     timestamp: Instant,
 }
 
+/// Memory and time of the persisted operation bus streams, to compare collecting the secondary
+/// instances from the recorded streams against emulating the chunks again.
+#[derive(Debug, Default, Clone)]
+pub struct OperationBusStreamStats {
+    /// Number of chunks whose operation bus payloads were recorded.
+    pub recorded_chunks: u64,
+    /// Number of recorded payloads.
+    pub recorded_payloads: u64,
+    /// Memory used by the recorded streams, in bytes.
+    pub recorded_bytes: u64,
+    /// Number of chunks collected from their recorded stream.
+    pub replayed_chunks: u64,
+    /// Time spent collecting chunks from their recorded stream, in nanoseconds.
+    pub replay_duration: u64,
+    /// Number of chunks collected emulating them again.
+    pub emulated_chunks: u64,
+    /// Time spent collecting chunks emulating them again, in nanoseconds.
+    pub emulate_duration: u64,
+}
+
+/// Overlap between the collection of the secondary instances and the computation of their witness
+/// when it is streamed, i.e. started as soon as each instance is collected.
+#[derive(Debug, Default, Clone)]
+pub struct StreamingWitnessStats {
+    /// Number of instances whose witness was computed while collecting.
+    pub streamed_instances: u64,
+    /// Number of instances left to `calculate_witness`, because no trace buffer was left or
+    /// because they were completed once the collection had ended.
+    pub unstreamed_instances: u64,
+    /// Wall time of the collection, in nanoseconds.
+    pub collect_duration: u64,
+    /// Time spent by the workers computing witnesses, in nanoseconds.
+    pub witness_duration: u64,
+    /// Part of `witness_duration` before the collection ended, in nanoseconds.
+    pub overlap_duration: u64,
+    /// Time spent taking trace buffers from the pool for the streamed instances, in nanoseconds.
+    pub buffer_wait_duration: u64,
+}
+
 #[derive(Debug, Clone)]
 pub struct ExecutorStats {
     start_time: Instant,
     last_id: u64,
     stats: Vec<ExecutorStatsEntry>,
     pub witness_stats: HashMap<usize, Stats>,
+    pub op_bus_stream_stats: OperationBusStreamStats,
+    pub streaming_witness_stats: StreamingWitnessStats,
 }
 
 impl Default for ExecutorStats {
@@ -49,6 +90,8 @@ impl ExecutorStats {
             last_id: 0,
             stats: Vec::new(),
             witness_stats: HashMap::new(),
+            op_bus_stream_stats: OperationBusStreamStats::default(),
+            streaming_witness_stats: StreamingWitnessStats::default(),
         }
     }
 
@@ -57,6 +100,8 @@ impl ExecutorStats {
         self.last_id = 0;
         self.stats.clear();
         self.witness_stats.clear();
+        self.op_bus_stream_stats = OperationBusStreamStats::default();
+        self.streaming_witness_stats = StreamingWitnessStats::default();
     }
 
     pub fn add_stat(
@@ -250,4 +295,50 @@ impl ExecutorStatsHandle {
             stats.witness_duration = duration;
         }
     }
+
+    pub fn add_op_bus_stream_recorded(&self, payloads: usize, bytes: usize) {
+        let stats = &mut self.inner.lock().unwrap().op_bus_stream_stats;
+        stats.recorded_chunks += 1;
+        stats.recorded_payloads += payloads as u64;
+        stats.recorded_bytes += bytes as u64;
+    }
+
+    pub fn add_op_bus_stream_collected(&self, replayed: bool, duration: u64) {
+        let stats = &mut self.inner.lock().unwrap().op_bus_stream_stats;
+        if replayed {
+            stats.replayed_chunks += 1;
+            stats.replay_duration += duration;
+        } else {
+            stats.emulated_chunks += 1;
+            stats.emulate_duration += duration;
+        }
+    }
+
+    pub fn get_op_bus_stream_stats(&self) -> OperationBusStreamStats {
+        self.inner.lock().unwrap().op_bus_stream_stats.clone()
+    }
+
+    pub fn add_streaming_witness_buffer_wait(&self, duration: u64) {
+        self.inner.lock().unwrap().streaming_witness_stats.buffer_wait_duration += duration;
+    }
+
+    pub fn add_streaming_witness(
+        &self,
+        instances: u64,
+        unstreamed_instances: u64,
+        collect_duration: u64,
+        witness_duration: u64,
+        overlap_duration: u64,
+    ) {
+        let stats = &mut self.inner.lock().unwrap().streaming_witness_stats;
+        stats.streamed_instances += instances;
+        stats.unstreamed_instances += unstreamed_instances;
+        stats.collect_duration += collect_duration;
+        stats.witness_duration += witness_duration;
+        stats.overlap_duration += overlap_duration;
+    }
+
+    pub fn get_streaming_witness_stats(&self) -> StreamingWitnessStats {
+        self.inner.lock().unwrap().streaming_witness_stats.clone()
+    }
 }
@@ -4,6 +4,7 @@
 use std::fs::{self, File};
 use std::io::{BufReader, Read};
 use std::path::{Path, PathBuf};
+use std::time::SystemTime;
 
 use crate::io::ZiskIO;
 
@@ -23,6 +24,12 @@ impl ZiskFileStdin {
         let file = File::open(&path_buf)?;
         Ok(ZiskFileStdin { path: path_buf, reader: BufReader::new(file) })
     }
+
+    /// Returns the modification time and size of the file, `None` if they can't be read.
+    pub fn stamp(&self) -> Option<(SystemTime, u64)> {
+        let metadata = fs::metadata(&self.path).ok()?;
+        Some((metadata.modified().ok()?, metadata.len()))
+    }
 }
 
 impl ZiskIO for ZiskFileStdin {
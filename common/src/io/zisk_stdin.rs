@@ -1,5 +1,6 @@
 use crate::io::{ZiskFileStdin, ZiskMemoryStdin, ZiskNullStdin};
 use std::path::Path;
+use std::time::SystemTime;
 
 use anyhow::Result;
 
@@ -108,4 +109,18 @@ impl ZiskStdin {
     pub fn from_vec(data: Vec<u8>) -> Self {
         Self { io: ZiskIOVariant::Memory(ZiskMemoryStdin::new(data)) }
     }
+
+    /// Returns `true` if the input is read from a file, whose content can change between reads.
+    pub fn is_file(&self) -> bool {
+        matches!(self.io, ZiskIOVariant::File(_))
+    }
+
+    /// Returns the modification time and size of the input file, `None` if the stdin isn't
+    /// file-based or they can't be read.
+    pub fn file_stamp(&self) -> Option<(SystemTime, u64)> {
+        match &self.io {
+            ZiskIOVariant::File(file_stdin) => file_stdin.stamp(),
+            _ => None,
+        }
+    }
 }
@@ -227,10 +227,9 @@ impl AsmRunnerMO {
         assert!(response.trace_len <= response.allocated_len);
 
         mem_planner.set_completed();
-        // Wait for mem_align_plans, this mem_align_plans are calculated in rust from
-        // counters calculated in C++
-        let mut mem_align_plans = mem_planner.wait_mem_align_plans();
+        // Wait for count and plan, mem_align_plans are also calculated in C++ on plan phase
         mem_planner.wait();
+        mem_planner.report_telemetry();
 
         // Add to executor stats
         #[cfg(feature = "stats")]
@@ -247,7 +246,7 @@ impl AsmRunnerMO {
             ExecutorStatsEvent::Begin,
         );
 
-        let plans = mem_planner.collect_plans(&mut mem_align_plans);
+        let plans = mem_planner.collect_plans();
 
         #[cfg(feature = "save_mem_plans")]
         save_plans(&plans, "mem_plans_cpp.txt");
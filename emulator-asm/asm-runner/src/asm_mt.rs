@@ -1,9 +1,11 @@
 use std::fmt::Debug;
+use std::sync::Arc;
 use zisk_common::EmuTrace;
 use zisk_common::EmuTraceStart;
+use zisk_common::MemReads;
 use zisk_core::{REGS_IN_MAIN_FROM, REGS_IN_MAIN_TO, REGS_IN_MAIN_TOTAL_NUMBER};
 
-use crate::AsmShmemHeader;
+use crate::{AsmShmemHeader, ShmemMapping};
 
 #[repr(C)]
 #[derive(Debug)]
@@ -38,21 +40,34 @@ pub struct AsmMTChunk {
 impl AsmMTChunk {
     /// Create an `OutputChunk` from a pointer.
     ///
+    /// The memory reads are borrowed in place from `mapping` when given, which must be the mapping
+    /// `mapped_ptr` points into, or copied out of the shared memory otherwise.
+    ///
     /// # Safety
     /// This function is unsafe because it reads from a raw pointer in shared memory.
-    pub fn to_emu_trace(mapped_ptr: &mut *const AsmMTChunk) -> EmuTrace {
+    pub fn to_emu_trace(
+        mapped_ptr: &mut *const AsmMTChunk,
+        mapping: Option<&Arc<ShmemMapping>>,
+    ) -> EmuTrace {
         // Read chunk data
         let chunk = unsafe { std::ptr::read(*mapped_ptr) };
         *mapped_ptr = unsafe { mapped_ptr.add(1) };
 
-        // Convert mem_reads into a Vec<u64> without copying
-        let mem_reads_ptr = *mapped_ptr as *mut u64;
+        let mem_reads_ptr = *mapped_ptr as *const u64;
         let mem_reads_len = chunk.mem_reads_size as usize;
-        let mem_reads =
-            unsafe { std::slice::from_raw_parts(mem_reads_ptr, mem_reads_len).to_vec() };
+        let mem_reads = match mapping {
+            // SAFETY: the region is not written again while the mapping is borrowed
+            Some(mapping) => unsafe {
+                MemReads::from_mapping(mapping.clone(), mem_reads_ptr, mem_reads_len)
+            },
+            None => {
+                unsafe { std::slice::from_raw_parts(mem_reads_ptr, mem_reads_len).to_vec() }.into()
+            }
+        };
 
         // Advance the pointer after reading memory reads
-        *mapped_ptr = unsafe { (*mapped_ptr as *mut u64).add(mem_reads_len) as *const AsmMTChunk };
+        *mapped_ptr =
+            unsafe { (*mapped_ptr as *const u64).add(mem_reads_len) as *const AsmMTChunk };
 
         let mut registers = [0u64; REGS_IN_MAIN_TOTAL_NUMBER];
         registers[REGS_IN_MAIN_FROM..].copy_from_slice(&chunk.registers[..REGS_IN_MAIN_TO]);
@@ -21,6 +21,12 @@ pub trait Task: Send + Sync + 'static {
     fn execute(self) -> Self::Output;
 }
 
+/// Environment variable that makes the MT runner copy the memory reads of every chunk out of the
+/// shared memory, as it did before they were borrowed in place. It is meant for comparing the
+/// peak resident memory and ingest time of both modes on the same build, from the summary logged
+/// at the end of each execution.
+pub const ASM_MT_COPY_MEM_READS_ENV: &str = "ZISK_ASM_MT_COPY_MEM_READS";
+
 pub type TaskFactory<'a, T> = Box<dyn Fn(ChunkId, Arc<EmuTrace>) -> T + Send + Sync + 'a>;
 
 pub enum MinimalTraces {
@@ -95,6 +101,17 @@ impl AsmRunnerMT {
         let mut sem_chunk_done = NamedSemaphore::create(sem_chunk_done_name.clone(), 0)
             .map_err(|e| AsmRunError::SemaphoreError(sem_chunk_done_name.clone(), e))?;
 
+        // The memory reads of the traces are borrowed in place, so the region can't be written
+        // again until the traces of the previous execution are dropped
+        if preloaded.output_shmem.is_borrowed() {
+            return Err(AsmRunError::SharedMemoryBorrowed(AsmService::MT.as_str().to_string()))
+                .context("Minimal traces must be dropped before a new execution");
+        }
+
+        let copy_mem_reads = std::env::var(ASM_MT_COPY_MEM_READS_ENV)
+            .map(|value| value != "0" && !value.is_empty())
+            .unwrap_or(false);
+
         let start_time = Instant::now();
 
         let handle = std::thread::spawn(move || {
@@ -120,6 +137,7 @@ impl AsmRunnerMT {
 
         let mut emu_traces = Vec::new();
         let mut handles = Vec::new();
+        let mut ingest_time = Duration::ZERO;
 
         let __stats = _stats.clone();
 
@@ -162,7 +180,11 @@ impl AsmRunnerMT {
                         };
                     }
 
-                    let emu_trace = Arc::new(AsmMTChunk::to_emu_trace(&mut data_ptr));
+                    let ingest_start = Instant::now();
+                    let mapping = (!copy_mem_reads).then(|| preloaded.output_shmem.share_mapping());
+                    let emu_trace =
+                        Arc::new(AsmMTChunk::to_emu_trace(&mut data_ptr, mapping.as_ref()));
+                    ingest_time += ingest_start.elapsed();
                     let should_exit = emu_trace.end;
 
                     let task = task_factory(chunk_id, emu_trace.clone());
@@ -207,6 +229,20 @@ impl AsmRunnerMT {
         let mhz = (total_steps as f64 / start_time.elapsed().as_secs_f64()) / 1_000_000.0;
         info!("··· Assembly execution speed: {:.2} MHz", mhz);
 
+        let mem_reads_bytes = emu_traces.iter().map(|x| x.mem_reads.len() * 8).sum::<usize>();
+        info!(
+            "··· Memory reads {} shared memory: {} MB in {:?}",
+            if copy_mem_reads { "copied from" } else { "read in place from" },
+            mem_reads_bytes >> 20,
+            ingest_time
+        );
+
+        // Peak resident memory of the process so far, ru_maxrss is in KB on Linux
+        let mut usage: libc::rusage = unsafe { std::mem::zeroed() };
+        if unsafe { libc::getrusage(libc::RUSAGE_SELF, &mut usage) } == 0 {
+            info!("··· Peak resident memory: {} MB", usage.ru_maxrss >> 10);
+        }
+
         // Wait for the assembly emulator to complete writing the trace
         let response = handle
             .join()
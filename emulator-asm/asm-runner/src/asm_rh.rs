@@ -1,7 +1,12 @@
 use std::fmt::Debug;
 
+use rayon::prelude::*;
+
 use crate::{AsmSharedMemory, AsmShmemHeader};
 
+/// Number of counters scanned by each task when extracting the executed instructions.
+const EXECUTED_SCAN_BLOCK: usize = 1 << 16;
+
 #[repr(C)]
 #[derive(Debug, Default)]
 pub struct AsmRHHeader {
@@ -23,11 +28,37 @@ pub struct AsmRHData {
     pub steps: u64,
     pub bios_inst_count: Vec<u64>,
     pub prog_inst_count: Vec<u64>,
+
+    /// Non-zero counters of `bios_inst_count`, as (index, count) pairs sorted by index.
+    pub bios_executed: Vec<(u32, u64)>,
+
+    /// Non-zero counters of `prog_inst_count`, as (index, count) pairs sorted by index.
+    pub prog_executed: Vec<(u32, u64)>,
 }
 
 impl AsmRHData {
     pub fn new(steps: u64, bios_inst_count: Vec<u64>, prog_inst_count: Vec<u64>) -> Self {
-        AsmRHData { steps, bios_inst_count, prog_inst_count }
+        let bios_executed = Self::executed(&bios_inst_count);
+        let prog_executed = Self::executed(&prog_inst_count);
+        AsmRHData { steps, bios_inst_count, prog_inst_count, bios_executed, prog_executed }
+    }
+
+    /// Returns the non-zero counters of a dense histogram with their index, scanning it in
+    /// parallel blocks. Only a fraction of the instructions of a large ROM are executed, so the
+    /// result is much smaller than the histogram.
+    fn executed(inst_count: &[u64]) -> Vec<(u32, u64)> {
+        inst_count
+            .par_chunks(EXECUTED_SCAN_BLOCK)
+            .enumerate()
+            .flat_map_iter(|(block, counters)| {
+                let first = block * EXECUTED_SCAN_BLOCK;
+                counters
+                    .iter()
+                    .enumerate()
+                    .filter(|(_, &count)| count != 0)
+                    .map(move |(idx, &count)| ((first + idx) as u32, count))
+            })
+            .collect()
     }
 }
 
@@ -53,11 +84,7 @@ impl AsmRHData {
             let prog_data_ptr = prog_data_ptr.add(1);
             let prog_inst_count = Vec::from_raw_parts(prog_data_ptr, prog_len, prog_len);
 
-            AsmRHData {
-                steps: asm_shared_memory.map_header().steps,
-                bios_inst_count,
-                prog_inst_count,
-            }
+            AsmRHData::new(asm_shared_memory.map_header().steps, bios_inst_count, prog_inst_count)
         }
     }
 }
@@ -5,7 +5,7 @@ use crate::{AsmRHData, AsmRHHeader, AsmRunError, AsmService, AsmServices, AsmSha
 use anyhow::{Context, Result};
 use named_sem::NamedSemaphore;
 use std::sync::atomic::{fence, Ordering};
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 pub struct PreloadedRH {
     pub output_shmem: AsmSharedMemory<AsmRHHeader>,
@@ -39,18 +39,26 @@ use zisk_common::ExecutorStatsEvent;
 // This struct is used to run the assembly code in a separate process and generate the ROM histogram.
 pub struct AsmRunnerRH {
     pub asm_rowh_output: AsmRHData,
+
+    /// Time when the assembly service signaled the end of the execution.
+    pub execution_end: Instant,
+
+    /// Time when the histogram was ready to be used.
+    pub ready_time: Instant,
 }
 
 impl Drop for AsmRunnerRH {
     fn drop(&mut self) {
-        // Forget all mem_reads Vec<u64> before unmapping
-        std::mem::forget(std::mem::take(&mut self.asm_rowh_output));
+        // Forget the counter Vec<u64> that live in shared memory before unmapping
+        let asm_rowh_output = std::mem::take(&mut self.asm_rowh_output);
+        std::mem::forget(asm_rowh_output.bios_inst_count);
+        std::mem::forget(asm_rowh_output.prog_inst_count);
     }
 }
 
 impl AsmRunnerRH {
-    pub fn new(asm_rowh_output: AsmRHData) -> Self {
-        AsmRunnerRH { asm_rowh_output }
+    pub fn new(asm_rowh_output: AsmRHData, execution_end: Instant) -> Self {
+        AsmRunnerRH { asm_rowh_output, execution_end, ready_time: Instant::now() }
     }
 
     pub fn run(
@@ -84,12 +92,12 @@ impl AsmRunnerRH {
         let asm_services = AsmServices::new(world_rank, local_rank, base_port);
         asm_services.send_rom_histogram_request(max_steps)?;
 
-        loop {
+        let execution_end = loop {
             match sem_chunk_done.timed_wait(Duration::from_secs(10)) {
                 Ok(()) => {
                     // Synchronize with memory changes from the C++ side
                     fence(Ordering::Acquire);
-                    break;
+                    break Instant::now();
                 }
                 Err(named_sem::Error::WaitFailed(e))
                     if e.kind() == std::io::ErrorKind::Interrupted =>
@@ -103,7 +111,7 @@ impl AsmRunnerRH {
                         .context("Child process returned error");
                 }
             }
-        }
+        };
 
         if asm_shared_memory.is_none() {
             *asm_shared_memory =
@@ -117,6 +125,6 @@ impl AsmRunnerRH {
         #[cfg(feature = "stats")]
         _stats.add_stat(0, parent_stats_id, "ASM_RH_RUNNER", 0, ExecutorStatsEvent::End);
 
-        Ok(AsmRunnerRH::new(asm_rowh_output))
+        Ok(AsmRunnerRH::new(asm_rowh_output, execution_end))
     }
 }
@@ -9,6 +9,8 @@ pub struct PreloadedRH {}
 // This struct is used to run the assembly code in a separate process and generate the ROM histogram.
 pub struct AsmRunnerRH {
     pub asm_rowh_output: AsmRHData,
+    pub execution_end: std::time::Instant,
+    pub ready_time: std::time::Instant,
 }
 
 unsafe impl Send for AsmRunnerRH {}
@@ -20,6 +20,8 @@ pub enum AsmRunError {
     ServiceError(#[source] anyhow::Error),
     #[error("Arc unwrap failed")]
     ArcUnwrap,
+    #[error("Shared memory '{0}' is still borrowed by the minimal traces of a previous execution")]
+    SharedMemoryBorrowed(String),
 }
 
 #[derive(Debug, Clone)]
@@ -133,6 +135,9 @@ impl AsmRunnerOptions {
         }
 
         command.arg("--shm_prefix").arg(AsmServices::shmem_prefix(port, self.local_rank));
+        command
+            .arg("--shm_input")
+            .arg(AsmServices::shmem_input_name(self.base_port, self.local_rank));
 
         match asm_service {
             AsmService::MT => {
@@ -66,6 +66,15 @@ impl AsmServices {
         format!("ZISK_{port}_{local_rank}")
     }
 
+    /// Name of the input shared memory of the services of `local_rank`. It is a single one for all
+    /// of them, so every input is written once and mapped by each service at its input address.
+    pub fn shmem_input_name(base_port: Option<u16>, local_rank: i32) -> String {
+        format!(
+            "{}_input",
+            Self::shmem_prefix(base_port.unwrap_or(ASM_SERVICE_BASE_PORT), local_rank)
+        )
+    }
+
     pub fn start_asm_services(
         &self,
         ziskemuasm_path: &Path,
@@ -136,6 +145,12 @@ impl AsmServices {
             }
         }
 
+        // The services don't remove the input shared memory, it is shared among them
+        let shmem_input_name = Self::shmem_input_name(Some(self.base_port), self.local_rank);
+        if let Ok(c_name) = std::ffi::CString::new(shmem_input_name) {
+            unsafe { libc::shm_unlink(c_name.as_ptr()) };
+        }
+
         Ok(())
     }
 
@@ -8,7 +8,10 @@ use std::{
     io,
     os::raw::c_void,
     ptr,
-    sync::atomic::{fence, Ordering},
+    sync::{
+        atomic::{fence, AtomicU64, Ordering},
+        Arc, Weak,
+    },
 };
 use tracing::debug;
 use zisk_common::io::{ZiskIO, ZiskStdin};
@@ -27,13 +30,39 @@ pub struct AsmSharedMemory<H: AsmShmemHeader> {
     _fd: i32,
     mapped_ptr: *mut c_void,
     mapped_size: usize,
+    map_flags: i32,
     shmem_name: String,
+
+    /// Owner of the current mapping once it has been shared with `share_mapping`. A shared mapping
+    /// is unmapped when its last owner is dropped, never moved.
+    shared_mapping: Option<Arc<ShmemMapping>>,
+
+    /// Shared mappings replaced by a remap, still alive while something borrows from them.
+    retired_mappings: Vec<Weak<ShmemMapping>>,
+
     _phantom: std::marker::PhantomData<H>,
 }
 
 unsafe impl<H: AsmShmemHeader> Send for AsmSharedMemory<H> {}
 unsafe impl<H: AsmShmemHeader> Sync for AsmSharedMemory<H> {}
 
+/// A mapping of a shared memory region that data borrowed from it keeps alive. It is unmapped when
+/// the last `Arc` is dropped.
+pub struct ShmemMapping {
+    ptr: *mut c_void,
+    size: usize,
+}
+
+// SAFETY: the mapping is read-only and only unmapped on drop, when nothing borrows from it
+unsafe impl Send for ShmemMapping {}
+unsafe impl Sync for ShmemMapping {}
+
+impl Drop for ShmemMapping {
+    fn drop(&mut self) {
+        unsafe { unmap(self.ptr, self.size) };
+    }
+}
+
 pub trait AsmShmemHeader: Debug {
     fn allocated_size(&self) -> u64;
 }
@@ -131,7 +160,10 @@ impl<H: AsmShmemHeader> AsmSharedMemory<H> {
                 _fd: fd,
                 mapped_ptr,
                 mapped_size: allocated_size,
+                map_flags: flags,
                 shmem_name: name.to_string(),
+                shared_mapping: None,
+                retired_mappings: Vec::new(),
                 _phantom: std::marker::PhantomData::<H>,
             })
         }
@@ -149,8 +181,17 @@ impl<H: AsmShmemHeader> AsmSharedMemory<H> {
             return Err(anyhow::anyhow!("New size must be greater than zero"));
         }
 
-        // Use mremap to extend the existing mapping at the same address
-        let new_ptr = self.remap_region(new_size)?;
+        let new_ptr = if let Some(shared_mapping) = self.shared_mapping.take() {
+            // The old mapping can't move while it is borrowed, map the region again elsewhere and
+            // let the borrowers unmap the old one
+            debug!("Remapping shared memory {} while it is borrowed", self.shmem_name);
+            self.retired_mappings.push(Arc::downgrade(&shared_mapping));
+            drop(shared_mapping);
+            self.map_region(new_size)?
+        } else {
+            // Use mremap to extend the existing mapping at the same address
+            self.remap_region(new_size)?
+        };
 
         // Update the struct with new mapping info
         self.mapped_ptr = new_ptr;
@@ -209,6 +250,40 @@ impl<H: AsmShmemHeader> AsmSharedMemory<H> {
         }
     }
 
+    /// Maps the whole shared memory region again at a new address, without unmapping the current
+    /// mapping.
+    fn map_region(&self, size: usize) -> Result<*mut c_void> {
+        let new_ptr =
+            unsafe { mmap(ptr::null_mut(), size, PROT_READ, self.map_flags, self._fd, 0) };
+        if new_ptr == MAP_FAILED {
+            Err(anyhow::anyhow!(
+                "mmap failed for '{}': {}",
+                self.shmem_name,
+                io::Error::last_os_error()
+            ))
+        } else {
+            Ok(new_ptr)
+        }
+    }
+
+    /// Returns the owner of the current mapping, for data that borrows from it in place. From then
+    /// on the mapping is only unmapped when the last owner is dropped, and a remap maps the region
+    /// again instead of moving it.
+    pub fn share_mapping(&mut self) -> Arc<ShmemMapping> {
+        let (mapped_ptr, mapped_size) = (self.mapped_ptr, self.mapped_size);
+        self.shared_mapping
+            .get_or_insert_with(|| Arc::new(ShmemMapping { ptr: mapped_ptr, size: mapped_size }))
+            .clone()
+    }
+
+    /// Returns `true` if anything still borrows from the current or a retired mapping, so the
+    /// region must not be written again.
+    pub fn is_borrowed(&mut self) -> bool {
+        self.retired_mappings.retain(|mapping| mapping.strong_count() > 0);
+        !self.retired_mappings.is_empty()
+            || self.shared_mapping.as_ref().is_some_and(|mapping| Arc::strong_count(mapping) > 1)
+    }
+
     pub fn check_size_changed<T>(&mut self, current_read_ptr: &mut *const T) -> Result<bool> {
         let read_mapped_size = self.map_header().allocated_size();
 
@@ -230,6 +305,14 @@ impl<H: AsmShmemHeader> AsmSharedMemory<H> {
     }
 
     pub fn unmap(&mut self) -> Result<()> {
+        if let Some(shared_mapping) = self.shared_mapping.take() {
+            // Unmapped by the last owner
+            drop(shared_mapping);
+            self.mapped_ptr = ptr::null_mut();
+            self.mapped_size = 0;
+            return Ok(());
+        }
+
         unsafe {
             if munmap(self.mapped_ptr, self.mapped_size) != 0 {
                 tracing::error!("munmap failed: {:?}", io::Error::last_os_error());
@@ -272,10 +355,6 @@ impl<H: AsmShmemHeader> AsmSharedMemory<H> {
         unsafe { self.mapped_ptr.add(size_of::<H>()) }
     }
 
-    pub fn shmem_input_name(port: u16, asm_service: AsmService, local_rank: i32) -> String {
-        format!("{}_{}_input", AsmServices::shmem_prefix(port, local_rank), asm_service.as_str())
-    }
-
     pub fn shmem_output_name(port: u16, asm_service: AsmService, local_rank: i32) -> String {
         format!("{}_{}_output", AsmServices::shmem_prefix(port, local_rank), asm_service.as_str())
     }
@@ -345,17 +424,65 @@ pub unsafe fn unmap(ptr: *mut c_void, size: usize) {
     }
 }
 
-pub fn write_input(stdin: &mut ZiskStdin, shmem_input_writer: &SharedMemoryWriter) {
-    let inputs = stdin.read();
-    let asm_input = AsmInputC2 { zero: 0, input_data_size: inputs.len() as u64 };
-    let shmem_input_size = (inputs.len() + size_of::<AsmInputC2>() + 7) & !7;
-
-    let mut full_input = Vec::with_capacity(shmem_input_size);
-    full_input.extend_from_slice(&asm_input.to_bytes());
-    full_input.extend_from_slice(&inputs);
-    while full_input.len() < shmem_input_size {
-        full_input.push(0);
+/// Source of the generations of `AsmInput`, 0 is never used.
+static NEXT_INPUT_GENERATION: AtomicU64 = AtomicU64::new(1);
+
+/// Guest input framed as the assembly services read it from their input shared memory: the
+/// `AsmInputC2` header followed by the data, padded to 8 bytes.
+///
+/// It is framed once per input and written as is to the input shared memory of the services. Its
+/// generation identifies it, so a writer that already has it doesn't copy it again.
+pub struct AsmInput {
+    generation: u64,
+    bytes: Vec<u8>,
+}
+
+impl AsmInput {
+    /// Frames `inputs` with a new generation.
+    pub fn new(inputs: &[u8]) -> Self {
+        let asm_input = AsmInputC2 { zero: 0, input_data_size: inputs.len() as u64 };
+        let shmem_input_size = (inputs.len() + size_of::<AsmInputC2>() + 7) & !7;
+
+        let mut bytes = Vec::with_capacity(shmem_input_size);
+        bytes.extend_from_slice(&asm_input.to_bytes());
+        bytes.extend_from_slice(inputs);
+        bytes.resize(shmem_input_size, 0);
+
+        Self { generation: NEXT_INPUT_GENERATION.fetch_add(1, Ordering::Relaxed), bytes }
+    }
+
+    /// Reads and frames the whole input of `stdin`.
+    pub fn from_stdin(stdin: &mut ZiskStdin) -> Self {
+        Self::new(&stdin.read())
     }
 
-    shmem_input_writer.write_input(&full_input).expect("Failed to write input to shared memory");
+    /// Returns the generation of the input.
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Returns the size of the framed input, in bytes.
+    pub fn len(&self) -> usize {
+        self.bytes.len()
+    }
+
+    /// Returns `true` if the framed input has no bytes.
+    pub fn is_empty(&self) -> bool {
+        self.bytes.is_empty()
+    }
+
+    /// Writes the framed input to the input shared memory of `shmem_input_writer`, unless it is
+    /// already there.
+    ///
+    /// # Returns
+    /// `true` if the input has been written, `false` if the shared memory already had it.
+    pub fn write(&self, shmem_input_writer: &SharedMemoryWriter) -> bool {
+        shmem_input_writer
+            .write_input_generation(self.generation, &self.bytes)
+            .expect("Failed to write input to shared memory")
+    }
+}
+
+pub fn write_input(stdin: &mut ZiskStdin, shmem_input_writer: &SharedMemoryWriter) {
+    AsmInput::from_stdin(stdin).write(shmem_input_writer);
 }
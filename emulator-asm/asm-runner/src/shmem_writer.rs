@@ -2,14 +2,21 @@
 use libc::{mmap, msync, shm_open, MAP_FAILED, MAP_SHARED, MS_SYNC};
 use std::io::{self, Result};
 use std::ptr;
+use std::sync::atomic::{AtomicU64, Ordering};
 
 use libc::{c_void, close, munmap, PROT_READ, PROT_WRITE, S_IRUSR, S_IWUSR};
 
+/// Alignment of the synced range of the shared memory, the page size.
+const SYNC_ALIGN: usize = 4096;
+
 pub struct SharedMemoryWriter {
     ptr: *mut u8,
     size: usize,
     fd: i32,
     name: String,
+
+    /// Generation of the input currently in the shared memory, 0 if none.
+    generation: AtomicU64,
 }
 
 unsafe impl Send for SharedMemoryWriter {}
@@ -27,7 +34,13 @@ impl SharedMemoryWriter {
         // Map the memory region for read/write
         let ptr = Self::map(fd, size, PROT_READ | PROT_WRITE, unlock_mapped_memory, name);
 
-        Ok(Self { ptr: ptr as *mut u8, size, fd, name: name.to_string() })
+        Ok(Self {
+            ptr: ptr as *mut u8,
+            size,
+            fd,
+            name: name.to_string(),
+            generation: AtomicU64::new(0),
+        })
     }
 
     #[cfg(all(target_os = "linux", target_arch = "x86_64"))]
@@ -93,15 +106,37 @@ impl SharedMemoryWriter {
 
         unsafe {
             ptr::copy_nonoverlapping(data.as_ptr(), self.ptr, data.len());
-            // Force changes to be flushed to the shared memory
+            // Force changes to be flushed to the shared memory, only the pages just written
             #[cfg(all(target_os = "linux", target_arch = "x86_64"))]
-            if msync(self.ptr as *mut _, self.size, MS_SYNC /*| MS_INVALIDATE*/) != 0 {
-                panic!("msync failed: {}", std::io::Error::last_os_error());
+            {
+                let sync_size = data.len().next_multiple_of(SYNC_ALIGN).min(self.size);
+                if sync_size > 0
+                    && msync(self.ptr as *mut _, sync_size, MS_SYNC /*| MS_INVALIDATE*/) != 0
+                {
+                    panic!("msync failed: {}", std::io::Error::last_os_error());
+                }
             }
         }
 
+        // The previous generation is overwritten, whatever it was
+        self.generation.store(0, Ordering::Release);
+
         Ok(())
     }
+
+    /// Writes the input of generation `generation` to the shared memory, unless it is already
+    /// there.
+    ///
+    /// # Returns
+    /// `true` if the input has been written, `false` if the shared memory already had it.
+    pub fn write_input_generation(&self, generation: u64, data: &[u8]) -> Result<bool> {
+        if generation != 0 && self.generation.load(Ordering::Acquire) == generation {
+            return Ok(false);
+        }
+        self.write_input(data)?;
+        self.generation.store(generation, Ordering::Release);
+        Ok(true)
+    }
 }
 
 impl Drop for SharedMemoryWriter {
@@ -35,6 +35,7 @@ uint64_t get_gen_method(void);
 
 #define INPUT_ADDR (uint64_t)0x90000000
 #define MAX_INPUT_SIZE (uint64_t)0x08000000 // 128MB
+#define INPUT_SYNC_ALIGN (uint64_t)0x1000 // 4KB, page size
 
 #define RAM_ADDR (uint64_t)0xa0000000
 #define RAM_SIZE (uint64_t)0x20000000 // 512MB
@@ -280,6 +281,9 @@ char shm_prefix[MAX_SHM_PREFIX_LENGTH];
 
 // Input shared memory
 char shmem_input_name[128];
+// Input shared memory shared by all the services of the caller, e.g. MT, RH and MO, set by
+// --shm_input; when empty every service gets its own one, named after the shm prefix
+char shmem_shared_input_name[128] = "";
 int shmem_input_fd = -1;
 uint64_t shmem_input_size = 0;
 void * shmem_input_address = NULL;
@@ -826,6 +830,7 @@ void print_usage (void)
     printf("\t-o output on\n");
     printf("\t--silent silent on\n");
     printf("\t--shm_prefix <prefix> (default: ZISK)\n");
+    printf("\t--shm_input <name> input shared memory shared with other services (default: <prefix>_<service>_input)\n");
     printf("\t-m metrics on\n");
     printf("\t-t trace on\n");
     printf("\t-tt trace_trace on\n");
@@ -1001,6 +1006,24 @@ void parse_arguments(int argc, char *argv[])
                 strcpy(shm_prefix, argv[i]);
                 continue;
             }
+            if (strcmp(argv[i], "--shm_input") == 0)
+            {
+                i++;
+                if (i >= argc)
+                {
+                    printf("ERROR: Detected argument --shm_input in the last position; please provide shared mem name after it\n");
+                    print_usage();
+                    exit(-1);
+                }
+                if (strlen(argv[i]) >= sizeof(shmem_shared_input_name))
+                {
+                    printf("ERROR: Detected argument --shm_input but next argument is too long\n");
+                    print_usage();
+                    exit(-1);
+                }
+                strcpy(shmem_shared_input_name, argv[i]);
+                continue;
+            }
             if (strcmp(argv[i], "--chunk") == 0)
             {
                 i++;
@@ -1442,6 +1465,12 @@ void configure (void)
         port = arguments_port;
     }
 
+    // The caller writes the input once to the shared input, instead of once per service
+    if ((shmem_shared_input_name[0] != 0) && (shmem_input_name[0] != 0))
+    {
+        strcpy(shmem_input_name, shmem_shared_input_name);
+    }
+
     if (verbose)
     {
         printf("ziskemuasm configuration:\n");
@@ -2502,11 +2531,17 @@ void server_setup (void)
 
     if ((gen_method != ChunkPlayerMTCollectMem) && (gen_method != ChunkPlayerMemReadsCollectMain))
     {
-        // Make sure the input shared memory is deleted
-        shm_unlink(shmem_input_name);
+        // A shared input can already be mapped by other services, so it is opened as it is,
+        // otherwise make sure the input shared memory is deleted
+        int shmem_input_flags = O_RDWR | O_CREAT;
+        if (shmem_shared_input_name[0] == 0)
+        {
+            shm_unlink(shmem_input_name);
+            shmem_input_flags |= O_EXCL;
+        }
 
         // Create the input shared memory
-        shmem_input_fd = shm_open(shmem_input_name, O_RDWR | O_CREAT | O_EXCL, 0666);
+        shmem_input_fd = shm_open(shmem_input_name, shmem_input_flags, 0666);
         if (shmem_input_fd < 0)
         {
             printf("ERROR: Failed calling shm_open(%s) as read-write errno=%d=%s\n", shmem_input_name, errno, strerror(errno));
@@ -2515,7 +2550,7 @@ void server_setup (void)
             exit(-1);
         }
 
-        // Size it
+        // Size it; a shared input has the same size in all the services
         result = ftruncate(shmem_input_fd, MAX_INPUT_SIZE);
         if (result != 0)
         {
@@ -2838,8 +2873,11 @@ void server_run (void)
         trace_used_size = 0;
     }
 
-    // Sync input shared memory
-    if (msync((void *)INPUT_ADDR, MAX_INPUT_SIZE, MS_SYNC) != 0) {
+    // Sync input shared memory, only the header and the input data written by the client
+    uint64_t input_sync_size = 16 + *(volatile uint64_t *)(INPUT_ADDR + 8);
+    if (input_sync_size > MAX_INPUT_SIZE) input_sync_size = MAX_INPUT_SIZE;
+    input_sync_size = (input_sync_size + INPUT_SYNC_ALIGN - 1) & ~(INPUT_SYNC_ALIGN - 1);
+    if (msync((void *)INPUT_ADDR, input_sync_size, MS_SYNC) != 0) {
         printf("ERROR: msync failed for shmem_input_address errno=%d=%s\n", errno, strerror(errno));
         fflush(stdout);
         fflush(stderr);
@@ -3017,10 +3055,14 @@ void server_cleanup (void)
     {
         printf("ERROR: Failed calling munmap(input) errno=%d=%s\n", errno, strerror(errno));
     }
-    result = shm_unlink(shmem_input_name);
-    if (result == -1)
+    // A shared input belongs to the caller, that writes it, other services can still be using it
+    if (shmem_shared_input_name[0] == 0)
     {
-        printf("ERROR: Failed calling shm_unlink(%s) errno=%d=%s\n", shmem_input_name, errno, strerror(errno));
+        result = shm_unlink(shmem_input_name);
+        if (result == -1)
+        {
+            printf("ERROR: Failed calling shm_unlink(%s) errno=%d=%s\n", shmem_input_name, errno, strerror(errno));
+        }
     }
 
     // Cleanup trace
@@ -0,0 +1,130 @@
+#[macro_use]
+extern crate criterion;
+use std::sync::Arc;
+
+use criterion::{BenchmarkId, Criterion};
+use data_bus::DataBusTrait;
+use zisk_common::{BusId, EmuTrace};
+use zisk_core::{Riscv2zisk, ZiskRom};
+use ziskemu::{Emu, EmuOptions, ReplayRom, ZiskEmulator};
+
+const CHUNK_SIZE: u64 = 1 << 18;
+
+// Data bus that folds every payload into a digest per bus, to check that both replays write the
+// same payloads in the same order
+#[derive(Default, PartialEq, Eq, Debug)]
+struct DigestBus {
+    digests: [u64; 3],
+    payloads: [u64; 3],
+}
+
+impl DataBusTrait<u64, ()> for DigestBus {
+    #[inline(always)]
+    fn write_to_bus(&mut self, bus_id: BusId, payload: &[u64]) -> bool {
+        let digest = &mut self.digests[bus_id.0];
+        for &value in payload {
+            *digest = (*digest ^ value).wrapping_mul(0x100000001b3);
+        }
+        self.payloads[bus_id.0] += 1;
+        true
+    }
+
+    fn on_close(&mut self) {}
+
+    fn into_devices(self, _execute_on_close: bool) -> Vec<(Option<usize>, Option<()>)> {
+        Vec::new()
+    }
+}
+
+fn load_traces() -> (Arc<ZiskRom>, Vec<EmuTrace>) {
+    let elf_file = "./benches/data/my.elf".to_string();
+    let rom = Riscv2zisk::new(elf_file).run().expect("Failed to convert the ELF file");
+    let input = std::fs::read("./benches/data/input.bin").expect("Could not read input file");
+
+    let options = EmuOptions { chunk_size: Some(CHUNK_SIZE), ..Default::default() };
+    let min_traces = ZiskEmulator::compute_minimal_traces(&rom, &input, &options, 1)
+        .expect("Failed to compute the minimal traces");
+
+    (Arc::new(rom), min_traces)
+}
+
+fn count_rom(rom: &ZiskRom, min_traces: &[EmuTrace], with_mem_ops: bool) -> DigestBus {
+    let mut data_bus = DigestBus::default();
+    for emu_trace in min_traces {
+        Emu::new(rom).process_emu_trace(emu_trace, &mut data_bus, with_mem_ops);
+    }
+    data_bus
+}
+
+fn count_replay(replay: &ReplayRom, min_traces: &[EmuTrace], with_mem_ops: bool) -> DigestBus {
+    let mut data_bus = DigestBus::default();
+    for emu_trace in min_traces {
+        Emu::new(replay.rom()).process_emu_trace_replay(
+            replay,
+            emu_trace,
+            &mut data_bus,
+            with_mem_ops,
+        );
+    }
+    data_bus
+}
+
+fn collect_rom(rom: &ZiskRom, min_traces: &[EmuTrace]) -> DigestBus {
+    let mut data_bus = DigestBus::default();
+    for chunk_id in 0..min_traces.len() {
+        Emu::new(rom).process_emu_traces(min_traces, chunk_id, &mut data_bus);
+    }
+    data_bus
+}
+
+fn collect_replay(replay: &ReplayRom, min_traces: &[EmuTrace]) -> DigestBus {
+    let mut data_bus = DigestBus::default();
+    for chunk_id in 0..min_traces.len() {
+        Emu::new(replay.rom()).process_emu_traces_replay(
+            replay,
+            min_traces,
+            chunk_id,
+            None,
+            &mut data_bus,
+        );
+    }
+    data_bus
+}
+
+fn bench_replay(c: &mut Criterion) {
+    let (rom, min_traces) = load_traces();
+    let replay = ReplayRom::new(rom.clone());
+
+    // The pre-decoded replay must be bit-identical to the ROM one
+    for with_mem_ops in [false, true] {
+        assert_eq!(
+            count_rom(&rom, &min_traces, with_mem_ops),
+            count_replay(&replay, &min_traces, with_mem_ops)
+        );
+    }
+    assert_eq!(collect_rom(&rom, &min_traces), collect_replay(&replay, &min_traces));
+
+    let mut group = c.benchmark_group("Replay minimal traces");
+    for with_mem_ops in [false, true] {
+        group.bench_with_input(
+            BenchmarkId::new("count_rom", with_mem_ops),
+            &with_mem_ops,
+            |b, &m| b.iter(|| count_rom(&rom, &min_traces, m)),
+        );
+        group.bench_with_input(
+            BenchmarkId::new("count_replay", with_mem_ops),
+            &with_mem_ops,
+            |b, &m| b.iter(|| count_replay(&replay, &min_traces, m)),
+        );
+    }
+    group.bench_function("collect_rom", |b| b.iter(|| collect_rom(&rom, &min_traces)));
+    group.bench_function("collect_replay", |b| b.iter(|| collect_replay(&replay, &min_traces)));
+    group.finish();
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().significance_level(0.1).sample_size(10);
+    targets = bench_replay
+}
+criterion_main!(benches);
@@ -2,6 +2,7 @@ use std::mem;
 
 use crate::{
     ElfSymbolReader, EmuContext, EmuFullTraceStep, EmuOptions, EmuRegTrace, ParEmuOptions,
+    ReplayRom,
 };
 use fields::PrimeField64;
 use mem_common::MemHelpers;
@@ -12,7 +13,7 @@ use zisk_common::{
 // #[cfg(feature = "sp")]
 // use zisk_core::SRC_SP;
 use data_bus::DataBusTrait;
-use zisk_common::{EmuTrace, EmuTraceStart};
+use zisk_common::{EmuChunkCheckpoint, EmuTrace, EmuTraceStart, CHECKPOINT_OP_TYPES};
 use zisk_core::zisk_ops::ZiskOp;
 use zisk_core::{
     EmulationMode, InstContext, Mem, ZiskInst, ZiskOperationType, ZiskRom, FREG_F0, FREG_INST,
@@ -1579,7 +1580,7 @@ impl<'a> Emu<'a> {
             }
 
             // Reserve enough entries for all the requested steps between callbacks
-            self.ctx.trace.mem_reads.reserve(self.ctx.callback_steps as usize);
+            self.ctx.trace.mem_reads.to_mut().reserve(self.ctx.callback_steps as usize);
 
             // Init pc to the rom entry address
             self.ctx.trace.start_state.pc = ROM_ENTRY;
@@ -1747,7 +1748,7 @@ impl<'a> Emu<'a> {
                         },
                         last_c: 0,
                         steps: 0,
-                        mem_reads: Vec::with_capacity(par_options.num_steps),
+                        mem_reads: Vec::with_capacity(par_options.num_steps).into(),
                         end: false,
                     });
                 }
@@ -1801,7 +1802,7 @@ impl<'a> Emu<'a> {
                     },
                     last_c: 0,
                     steps: 0,
-                    mem_reads: Vec::with_capacity(par_options.num_steps),
+                    mem_reads: Vec::with_capacity(par_options.num_steps).into(),
                     end: false,
                 });
             }
@@ -1914,7 +1915,7 @@ impl<'a> Emu<'a> {
 
                 // Swap the emulator trace to avoid memory copies
                 let mut trace = EmuTrace::default();
-                trace.mem_reads.reserve(self.ctx.callback_steps as usize);
+                trace.mem_reads.to_mut().reserve(self.ctx.callback_steps as usize);
                 mem::swap(&mut self.ctx.trace, &mut trace);
                 (callback)(trace);
 
@@ -1938,11 +1939,13 @@ impl<'a> Emu<'a> {
     #[inline(always)]
     pub fn par_step_my_block(&mut self, emu_full_trace_vec: &mut EmuTrace) {
         let instruction = self.rom.get_instruction(self.ctx.inst_ctx.pc);
+        let mem_reads = emu_full_trace_vec.mem_reads.to_mut();
+
         // Build the 'a' register value  based on the source specified by the current instruction
-        self.source_a_mem_reads_generate(instruction, &mut emu_full_trace_vec.mem_reads);
+        self.source_a_mem_reads_generate(instruction, mem_reads);
 
         // Build the 'b' register value  based on the source specified by the current instruction
-        self.source_b_mem_reads_generate(instruction, &mut emu_full_trace_vec.mem_reads);
+        self.source_b_mem_reads_generate(instruction, mem_reads);
 
         // If this is a precompiled, get the required input data to copy it to mem_reads
         if instruction.input_size > 0 {
@@ -1955,11 +1958,11 @@ impl<'a> Emu<'a> {
 
         // If this is a precompiled, copy input data generated by precompile call to mem_reads.
         if instruction.input_size > 0 {
-            emu_full_trace_vec.mem_reads.append(&mut self.ctx.inst_ctx.precompiled.input_data);
+            mem_reads.append(&mut self.ctx.inst_ctx.precompiled.input_data);
         }
 
         // Store the 'c' register value based on the storage specified by the current instruction
-        self.store_c_mem_reads_generate(instruction, &mut emu_full_trace_vec.mem_reads);
+        self.store_c_mem_reads_generate(instruction, mem_reads);
 
         // Set SP, if specified by the current instruction
         // #[cfg(feature = "sp")]
@@ -2148,15 +2151,97 @@ impl<'a> Emu<'a> {
         }
     }
 
+    /// Run a slice of the program like `process_emu_trace`, also storing a checkpoint of the
+    /// emulator state every `interval` steps, so the slice can be resumed later from any of them
+    pub fn process_emu_trace_with_checkpoints<T, DB: DataBusTrait<u64, T>>(
+        &mut self,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+        interval: u64,
+        checkpoints: &mut Vec<EmuChunkCheckpoint>,
+    ) {
+        // Set initial state
+        self.ctx.inst_ctx.pc = emu_trace.start_state.pc;
+        self.ctx.inst_ctx.sp = emu_trace.start_state.sp;
+        self.ctx.inst_ctx.step = emu_trace.start_state.step;
+        self.ctx.inst_ctx.c = emu_trace.start_state.c;
+        self.ctx.inst_ctx.regs = emu_trace.start_state.regs;
+        self.ctx.inst_ctx.emulation_mode = EmulationMode::ConsumeMemReads;
+
+        let mut mem_reads_index: usize = 0;
+        let mut op_counts = [0u64; CHECKPOINT_OP_TYPES];
+
+        for chunk_steps in 0..emu_trace.steps {
+            if chunk_steps > 0 && chunk_steps % interval == 0 {
+                checkpoints.push(self.chunk_checkpoint(chunk_steps, mem_reads_index, op_counts));
+            }
+
+            // Same condition used by the steps to write to the operation bus
+            let op_type = self.rom.get_instruction(self.ctx.inst_ctx.pc).op_type;
+            if op_type > ZiskOperationType::Internal && op_type < ZiskOperationType::FcallParam {
+                op_counts[op_type as usize] += 1;
+            }
+
+            if with_mem_ops {
+                self.step_emu_trace(&emu_trace.mem_reads, &mut mem_reads_index, data_bus);
+            } else {
+                self.step_emu_trace_no_mem_ops(
+                    &emu_trace.mem_reads,
+                    &mut mem_reads_index,
+                    data_bus,
+                );
+            }
+        }
+    }
+
+    /// Returns the checkpoint of the current emulator state, after `chunk_steps` steps of the
+    /// chunk that consumed `mem_reads_index` memory reads and counted `op_counts` operations
+    #[inline(always)]
+    fn chunk_checkpoint(
+        &self,
+        chunk_steps: u64,
+        mem_reads_index: usize,
+        op_counts: [u64; CHECKPOINT_OP_TYPES],
+    ) -> EmuChunkCheckpoint {
+        EmuChunkCheckpoint {
+            state: EmuTraceStart {
+                pc: self.ctx.inst_ctx.pc,
+                sp: self.ctx.inst_ctx.sp,
+                c: self.ctx.inst_ctx.c,
+                step: self.ctx.inst_ctx.step,
+                regs: self.ctx.inst_ctx.regs,
+            },
+            chunk_steps,
+            mem_reads_index,
+            op_counts,
+        }
+    }
+
     /// Run a slice of the program to generate full traces
     pub fn process_emu_traces<T, DB: DataBusTrait<u64, T>>(
         &mut self,
         vec_traces: &[EmuTrace],
         chunk_id: usize,
         data_bus: &mut DB,
+    ) {
+        self.process_emu_traces_from(vec_traces, chunk_id, None, data_bus);
+    }
+
+    /// Run a slice of the program to generate full traces, starting from `checkpoint` if any,
+    /// otherwise from the beginning of the slice
+    pub fn process_emu_traces_from<T, DB: DataBusTrait<u64, T>>(
+        &mut self,
+        vec_traces: &[EmuTrace],
+        chunk_id: usize,
+        checkpoint: Option<&EmuChunkCheckpoint>,
+        data_bus: &mut DB,
     ) {
         // Set initial state
-        let emu_trace_start = &vec_traces[chunk_id].start_state;
+        let emu_trace_start = match checkpoint {
+            Some(checkpoint) => &checkpoint.state,
+            None => &vec_traces[chunk_id].start_state,
+        };
         self.ctx.inst_ctx.pc = emu_trace_start.pc;
         self.ctx.inst_ctx.sp = emu_trace_start.sp;
         self.ctx.inst_ctx.step = emu_trace_start.step;
@@ -2164,8 +2249,9 @@ impl<'a> Emu<'a> {
         self.ctx.inst_ctx.regs = emu_trace_start.regs;
         self.ctx.inst_ctx.emulation_mode = EmulationMode::ConsumeMemReads;
 
-        let mut current_step_idx = 0;
-        let mut mem_reads_index: usize = 0;
+        let mut current_step_idx = checkpoint.map_or(0, |checkpoint| checkpoint.chunk_steps);
+        let mut mem_reads_index: usize =
+            checkpoint.map_or(0, |checkpoint| checkpoint.mem_reads_index);
         loop {
             if !self.step_emu_traces(
                 &vec_traces[chunk_id].mem_reads,
@@ -2240,6 +2326,256 @@ impl<'a> Emu<'a> {
         _continue
     }
 
+    /// Run a slice of the program like `process_emu_trace`, fetching the instructions from the
+    /// pre-decoded `replay` ROM. The bus payloads are the same, in the same order.
+    pub fn process_emu_trace_replay<T, DB: DataBusTrait<u64, T>>(
+        &mut self,
+        replay: &ReplayRom,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+    ) {
+        // Set initial state
+        self.ctx.inst_ctx.pc = emu_trace.start_state.pc;
+        self.ctx.inst_ctx.sp = emu_trace.start_state.sp;
+        self.ctx.inst_ctx.step = emu_trace.start_state.step;
+        self.ctx.inst_ctx.c = emu_trace.start_state.c;
+        self.ctx.inst_ctx.regs = emu_trace.start_state.regs;
+        self.ctx.inst_ctx.emulation_mode = EmulationMode::ConsumeMemReads;
+
+        let mut mem_reads_index: usize = 0;
+        let mut index = replay.index(self.ctx.inst_ctx.pc);
+
+        if with_mem_ops {
+            for _ in 0..emu_trace.steps {
+                (_, index) = self.step_replay::<_, _, true, false>(
+                    replay,
+                    index,
+                    &emu_trace.mem_reads,
+                    &mut mem_reads_index,
+                    data_bus,
+                );
+            }
+        } else {
+            for _ in 0..emu_trace.steps {
+                (_, index) = self.step_replay::<_, _, false, false>(
+                    replay,
+                    index,
+                    &emu_trace.mem_reads,
+                    &mut mem_reads_index,
+                    data_bus,
+                );
+            }
+        }
+    }
+
+    /// Run a slice of the program like `process_emu_trace_with_checkpoints`, fetching the
+    /// instructions from the pre-decoded `replay` ROM. The bus payloads and the checkpoints are the
+    /// same, in the same order.
+    pub fn process_emu_trace_replay_with_checkpoints<T, DB: DataBusTrait<u64, T>>(
+        &mut self,
+        replay: &ReplayRom,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+        interval: u64,
+        checkpoints: &mut Vec<EmuChunkCheckpoint>,
+    ) {
+        // Set initial state
+        self.ctx.inst_ctx.pc = emu_trace.start_state.pc;
+        self.ctx.inst_ctx.sp = emu_trace.start_state.sp;
+        self.ctx.inst_ctx.step = emu_trace.start_state.step;
+        self.ctx.inst_ctx.c = emu_trace.start_state.c;
+        self.ctx.inst_ctx.regs = emu_trace.start_state.regs;
+        self.ctx.inst_ctx.emulation_mode = EmulationMode::ConsumeMemReads;
+
+        let mut mem_reads_index: usize = 0;
+        let mut op_counts = [0u64; CHECKPOINT_OP_TYPES];
+        let mut index = replay.index(self.ctx.inst_ctx.pc);
+
+        for chunk_steps in 0..emu_trace.steps {
+            if chunk_steps > 0 && chunk_steps % interval == 0 {
+                checkpoints.push(self.chunk_checkpoint(chunk_steps, mem_reads_index, op_counts));
+            }
+
+            // Same condition used by the steps to write to the operation bus
+            let op_type = replay.get(index).0.op_type;
+            if op_type > ZiskOperationType::Internal && op_type < ZiskOperationType::FcallParam {
+                op_counts[op_type as usize] += 1;
+            }
+
+            if with_mem_ops {
+                (_, index) = self.step_replay::<_, _, true, false>(
+                    replay,
+                    index,
+                    &emu_trace.mem_reads,
+                    &mut mem_reads_index,
+                    data_bus,
+                );
+            } else {
+                (_, index) = self.step_replay::<_, _, false, false>(
+                    replay,
+                    index,
+                    &emu_trace.mem_reads,
+                    &mut mem_reads_index,
+                    data_bus,
+                );
+            }
+        }
+    }
+
+    /// Run a slice of the program like `process_emu_traces_from`, fetching the instructions from
+    /// the pre-decoded `replay` ROM. The bus payloads are the same, in the same order.
+    pub fn process_emu_traces_replay<T, DB: DataBusTrait<u64, T>>(
+        &mut self,
+        replay: &ReplayRom,
+        vec_traces: &[EmuTrace],
+        chunk_id: usize,
+        checkpoint: Option<&EmuChunkCheckpoint>,
+        data_bus: &mut DB,
+    ) {
+        // Set initial state
+        let emu_trace_start = match checkpoint {
+            Some(checkpoint) => &checkpoint.state,
+            None => &vec_traces[chunk_id].start_state,
+        };
+        self.ctx.inst_ctx.pc = emu_trace_start.pc;
+        self.ctx.inst_ctx.sp = emu_trace_start.sp;
+        self.ctx.inst_ctx.step = emu_trace_start.step;
+        self.ctx.inst_ctx.c = emu_trace_start.c;
+        self.ctx.inst_ctx.regs = emu_trace_start.regs;
+        self.ctx.inst_ctx.emulation_mode = EmulationMode::ConsumeMemReads;
+
+        let mut current_step_idx = checkpoint.map_or(0, |checkpoint| checkpoint.chunk_steps);
+        let mut mem_reads_index: usize =
+            checkpoint.map_or(0, |checkpoint| checkpoint.mem_reads_index);
+        let mut index = replay.index(self.ctx.inst_ctx.pc);
+        loop {
+            let (_continue, next) = self.step_replay::<_, _, true, true>(
+                replay,
+                index,
+                &vec_traces[chunk_id].mem_reads,
+                &mut mem_reads_index,
+                data_bus,
+            );
+            index = next;
+            if !_continue {
+                break;
+            }
+
+            if self.ctx.inst_ctx.end {
+                break;
+            }
+
+            current_step_idx += 1;
+            if current_step_idx == vec_traces[chunk_id].steps {
+                break;
+            }
+        }
+    }
+
+    /// Performs one single step of the replay of a pre-decoded instruction. `MEM_OPS` writes the
+    /// memory operations to the memory bus and `ROM_BUS` writes the instruction to the ROM bus, as
+    /// `step_emu_traces` does.
+    ///
+    /// Returns whether the execution must continue and the index of the next instruction.
+    #[inline(always)]
+    fn step_replay<T, DB: DataBusTrait<u64, T>, const MEM_OPS: bool, const ROM_BUS: bool>(
+        &mut self,
+        replay: &ReplayRom,
+        index: usize,
+        mem_reads: &[u64],
+        mem_reads_index: &mut usize,
+        data_bus: &mut DB,
+    ) -> (bool, usize) {
+        let mut _continue = true;
+        let (instruction, alu, next) = replay.get(index);
+
+        if MEM_OPS {
+            self.source_a_mem_reads_consume_databus(
+                instruction,
+                mem_reads,
+                mem_reads_index,
+                data_bus,
+            );
+            self.source_b_mem_reads_consume_databus(
+                instruction,
+                mem_reads,
+                mem_reads_index,
+                data_bus,
+            );
+        } else {
+            self.source_a_mem_reads_consume_no_mem_ops(instruction, mem_reads, mem_reads_index);
+            self.source_b_mem_reads_consume_no_mem_ops(instruction, mem_reads, mem_reads_index);
+        }
+
+        match alu {
+            Some(op) => {
+                (self.ctx.inst_ctx.c, self.ctx.inst_ctx.flag) =
+                    op.call_ab(self.ctx.inst_ctx.a, self.ctx.inst_ctx.b);
+            }
+            None => {
+                // If this is a precompiled, get the required input data from mem_reads
+                if instruction.input_size > 0 {
+                    self.ctx.inst_ctx.precompiled.input_data.clear();
+                    self.ctx.inst_ctx.precompiled.output_data.clear();
+
+                    // round_up => (size + 7) >> 3
+                    let number_of_mem_reads = (instruction.input_size + 7) >> 3;
+                    for _ in 0..number_of_mem_reads {
+                        let mem_read = mem_reads[*mem_reads_index];
+                        *mem_reads_index += 1;
+                        self.ctx.inst_ctx.precompiled.input_data.push(mem_read);
+                    }
+                }
+
+                (instruction.func)(&mut self.ctx.inst_ctx);
+            }
+        }
+
+        if MEM_OPS {
+            self.store_c_mem_reads_consume_databus(
+                instruction,
+                mem_reads,
+                mem_reads_index,
+                data_bus,
+            );
+        } else {
+            self.store_c_mem_reads_consume_no_mem_ops(instruction, mem_reads, mem_reads_index);
+        }
+
+        // Get operation bus data
+        if instruction.op_type > ZiskOperationType::Internal
+            && instruction.op_type < ZiskOperationType::FcallParam
+        {
+            let operation_payload: &[u64] = OperationBusData::write_instruction_payload(
+                instruction,
+                &self.ctx.inst_ctx,
+                &mut self.static_array,
+            );
+            _continue = data_bus.write_to_bus(OPERATION_BUS_ID, operation_payload);
+        }
+
+        if ROM_BUS {
+            let rom_payload = RomBusData::from_instruction(instruction, &self.ctx.inst_ctx);
+            data_bus.write_to_bus(ROM_BUS_ID, &rom_payload);
+        }
+
+        self.set_pc(instruction);
+        self.ctx.inst_ctx.end = instruction.end;
+
+        self.ctx.inst_ctx.step += 1;
+
+        // Only jumps need to look up the next instruction by pc, there is none after the end
+        let next = match next {
+            Some(next) => next,
+            None if instruction.end => index,
+            None => replay.index(self.ctx.inst_ctx.pc),
+        };
+
+        (_continue, next)
+    }
+
     /// Performs one single step of the emulation
     #[inline(always)]
     pub fn step_slice_full_trace<F: PrimeField64>(
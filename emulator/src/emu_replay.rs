@@ -0,0 +1,277 @@
+//! The `ReplayRom` module pre-decodes a ZisK ROM for the replay of minimal traces in the count
+//! and collect phases.
+//!
+//! The replay executes the same instructions many times, once per chunk, so the work that only
+//! depends on the instruction is done once here:
+//! * Instructions are stored in a dense stream, in pc order, so fetching the next instruction
+//!   doesn't need the range checks of `ZiskRom::get_instruction()`.
+//! * Instructions whose next pc doesn't depend on the flag or on c (straight-line code inside a
+//!   basic block) are linked to their successor, so only jumps need a lookup by pc.
+//! * Operations whose result only depends on a and b are executed through `ZiskOp::call_ab`,
+//!   inlined in the replay loop, instead of the indirect call to `ZiskInst::func`.
+
+use std::{ptr::NonNull, sync::Arc};
+
+use zisk_core::{
+    zisk_ops::{OpType, ZiskOp},
+    ZiskInst, ZiskRom,
+};
+
+/// Value of `ReplayInst::next` for instructions without a static successor.
+const NO_NEXT: u32 = u32::MAX;
+
+/// Pre-decoded ROM instruction.
+struct ReplayInst {
+    /// The ROM instruction, owned by `ReplayRom::rom`.
+    inst: NonNull<ZiskInst>,
+
+    /// The operation, if its result only depends on a and b.
+    alu: Option<ZiskOp>,
+
+    /// Index of the next instruction in the stream, `NO_NEXT` if it depends on the execution.
+    next: u32,
+}
+
+/// ZisK ROM pre-decoded for the replay of minimal traces.
+pub struct ReplayRom {
+    /// The ROM. It is never modified while shared, so the instructions referenced by `insts` stay
+    /// valid as long as this `Arc` is alive.
+    rom: Arc<ZiskRom>,
+
+    /// Pre-decoded instructions, indexed by `ZiskInst::sorted_pc_list_index`.
+    insts: Vec<ReplayInst>,
+}
+
+// SAFETY: `ReplayInst::inst` only points to instructions of the immutable ROM owned by the
+// `ReplayRom`, so sharing it between threads is as safe as sharing the `Arc<ZiskRom>`.
+unsafe impl Send for ReplayRom {}
+unsafe impl Sync for ReplayRom {}
+
+impl ReplayRom {
+    /// Pre-decodes all the instructions of `rom`.
+    pub fn new(rom: Arc<ZiskRom>) -> Self {
+        let insts = rom
+            .sorted_pc_list
+            .iter()
+            .enumerate()
+            .map(|(index, &pc)| {
+                let inst = rom.get_instruction(pc);
+                debug_assert_eq!(inst.sorted_pc_list_index, index);
+
+                let next = if !inst.set_pc && !inst.end && inst.jmp_offset1 == inst.jmp_offset2 {
+                    let next_pc = (pc as i64 + inst.jmp_offset2) as u64;
+                    rom.sorted_pc_list.binary_search(&next_pc).map_or(NO_NEXT, |next| next as u32)
+                } else {
+                    NO_NEXT
+                };
+
+                ReplayInst { inst: NonNull::from(inst), alu: Self::alu_op(inst), next }
+            })
+            .collect();
+
+        Self { rom, insts }
+    }
+
+    /// Returns the operation of `inst` if it can be executed with `ZiskOp::call_ab`, i.e. its
+    /// `func` only computes c and flag from a and b.
+    fn alu_op(inst: &ZiskInst) -> Option<ZiskOp> {
+        if inst.input_size > 0 {
+            return None;
+        }
+        let op = ZiskOp::try_from_code(inst.op).ok()?;
+        match op.op_type() {
+            OpType::Internal if op != ZiskOp::Halt => Some(op),
+            OpType::Binary
+            | OpType::BinaryE
+            | OpType::Arith
+            | OpType::ArithA32
+            | OpType::ArithAm32
+            | OpType::PubOut => Some(op),
+            _ => None,
+        }
+    }
+
+    /// Returns the ROM.
+    pub fn rom(&self) -> &ZiskRom {
+        &self.rom
+    }
+
+    /// Returns the number of pre-decoded instructions.
+    pub fn len(&self) -> usize {
+        self.insts.len()
+    }
+
+    /// Returns `true` if the ROM has no instructions.
+    pub fn is_empty(&self) -> bool {
+        self.insts.is_empty()
+    }
+
+    /// Returns the index in the stream of the instruction at `pc`.
+    #[inline(always)]
+    pub fn index(&self, pc: u64) -> usize {
+        self.rom.get_instruction(pc).sorted_pc_list_index
+    }
+
+    /// Returns the instruction at `index`, its operation if it only depends on a and b, and the
+    /// index of its static successor, if any.
+    #[inline(always)]
+    pub fn get(&self, index: usize) -> (&ZiskInst, Option<ZiskOp>, Option<usize>) {
+        let replay_inst = &self.insts[index];
+        // SAFETY: see `ReplayRom::rom`
+        let inst = unsafe { replay_inst.inst.as_ref() };
+        let next = (replay_inst.next != NO_NEXT).then_some(replay_inst.next as usize);
+        (inst, replay_inst.alu, next)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    use data_bus::DataBusTrait;
+    use zisk_common::{BusId, EmuChunkCheckpoint, EmuTrace};
+    use zisk_core::Riscv2zisk;
+
+    use crate::{Emu, EmuOptions, ZiskEmulator};
+
+    const CHUNK_SIZE: u64 = 1 << 18;
+    const CHECKPOINT_INTERVAL: u64 = 1 << 14;
+
+    /// Data bus that folds every payload into a digest per bus.
+    #[derive(Default, PartialEq, Eq, Debug)]
+    struct DigestBus {
+        digests: [u64; 3],
+        payloads: [u64; 3],
+    }
+
+    impl DataBusTrait<u64, ()> for DigestBus {
+        fn write_to_bus(&mut self, bus_id: BusId, payload: &[u64]) -> bool {
+            let digest = &mut self.digests[bus_id.0];
+            for &value in payload {
+                *digest = (*digest ^ value).wrapping_mul(0x100000001b3);
+            }
+            self.payloads[bus_id.0] += 1;
+            true
+        }
+
+        fn on_close(&mut self) {}
+
+        fn into_devices(self, _execute_on_close: bool) -> Vec<(Option<usize>, Option<()>)> {
+            Vec::new()
+        }
+    }
+
+    /// Minimal traces of the guest of the benches.
+    fn bench_traces() -> (Arc<ZiskRom>, Vec<EmuTrace>) {
+        let data = concat!(env!("CARGO_MANIFEST_DIR"), "/benches/data");
+        let rom = Riscv2zisk::new(format!("{data}/my.elf")).run().expect("Failed to convert ELF");
+        let input = std::fs::read(format!("{data}/input.bin")).expect("Failed to read input");
+
+        let options = EmuOptions { chunk_size: Some(CHUNK_SIZE), ..Default::default() };
+        let min_traces = ZiskEmulator::compute_minimal_traces(&rom, &input, &options, 1)
+            .expect("Failed to compute the minimal traces");
+        assert!(min_traces.len() > 1, "the guest must fill more than one chunk");
+
+        (Arc::new(rom), min_traces)
+    }
+
+    fn assert_same_checkpoints(expected: &[EmuChunkCheckpoint], found: &[EmuChunkCheckpoint]) {
+        assert_eq!(expected.len(), found.len());
+        for (expected, found) in expected.iter().zip(found) {
+            assert_eq!(expected.state.pc, found.state.pc);
+            assert_eq!(expected.state.sp, found.state.sp);
+            assert_eq!(expected.state.c, found.state.c);
+            assert_eq!(expected.state.step, found.state.step);
+            assert_eq!(expected.state.regs, found.state.regs);
+            assert_eq!(expected.chunk_steps, found.chunk_steps);
+            assert_eq!(expected.mem_reads_index, found.mem_reads_index);
+            assert_eq!(expected.op_counts, found.op_counts);
+        }
+    }
+
+    #[test]
+    fn test_replay_count_payloads() {
+        let (rom, min_traces) = bench_traces();
+        let replay = ReplayRom::new(rom.clone());
+
+        for with_mem_ops in [false, true] {
+            for emu_trace in &min_traces {
+                let mut expected = DigestBus::default();
+                Emu::new(&rom).process_emu_trace(emu_trace, &mut expected, with_mem_ops);
+
+                let mut found = DigestBus::default();
+                Emu::new(&rom).process_emu_trace_replay(
+                    &replay,
+                    emu_trace,
+                    &mut found,
+                    with_mem_ops,
+                );
+                assert_eq!(expected, found);
+
+                // The checkpoints don't change the payloads, and both replays take the same ones
+                let mut expected_checkpoints = Vec::new();
+                let mut expected_with_checkpoints = DigestBus::default();
+                Emu::new(&rom).process_emu_trace_with_checkpoints(
+                    emu_trace,
+                    &mut expected_with_checkpoints,
+                    with_mem_ops,
+                    CHECKPOINT_INTERVAL,
+                    &mut expected_checkpoints,
+                );
+                assert_eq!(expected, expected_with_checkpoints);
+
+                let mut found_checkpoints = Vec::new();
+                let mut found_with_checkpoints = DigestBus::default();
+                Emu::new(&rom).process_emu_trace_replay_with_checkpoints(
+                    &replay,
+                    emu_trace,
+                    &mut found_with_checkpoints,
+                    with_mem_ops,
+                    CHECKPOINT_INTERVAL,
+                    &mut found_checkpoints,
+                );
+                assert_eq!(expected, found_with_checkpoints);
+                assert_same_checkpoints(&expected_checkpoints, &found_checkpoints);
+            }
+        }
+    }
+
+    #[test]
+    fn test_replay_collect_payloads() {
+        let (rom, min_traces) = bench_traces();
+        let replay = ReplayRom::new(rom.clone());
+
+        for (chunk_id, emu_trace) in min_traces.iter().enumerate() {
+            let mut checkpoints = Vec::new();
+            Emu::new(&rom).process_emu_trace_with_checkpoints(
+                emu_trace,
+                &mut DigestBus::default(),
+                false,
+                CHECKPOINT_INTERVAL,
+                &mut checkpoints,
+            );
+
+            // From the first step of the chunk and from each of its checkpoints
+            let starts = std::iter::once(None).chain(checkpoints.iter().map(Some));
+            for checkpoint in starts {
+                let mut expected = DigestBus::default();
+                Emu::new(&rom).process_emu_traces_from(
+                    &min_traces,
+                    chunk_id,
+                    checkpoint,
+                    &mut expected,
+                );
+
+                let mut found = DigestBus::default();
+                Emu::new(&rom).process_emu_traces_replay(
+                    &replay,
+                    &min_traces,
+                    chunk_id,
+                    checkpoint,
+                    &mut found,
+                );
+                assert_eq!(expected, found);
+            }
+        }
+    }
+}
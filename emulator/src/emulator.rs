@@ -15,7 +15,7 @@
 //!             Emu::run()
 //! ```
 
-use crate::{Emu, EmuOptions, ErrWrongArguments, ParEmuOptions, ZiskEmulatorErr};
+use crate::{Emu, EmuOptions, ErrWrongArguments, ParEmuOptions, ReplayRom, ZiskEmulatorErr};
 
 use data_bus::DataBusTrait;
 use fields::PrimeField;
@@ -25,7 +25,7 @@ use std::{
     time::Instant,
 };
 use sysinfo::System;
-use zisk_common::EmuTrace;
+use zisk_common::{EmuChunkCheckpoint, EmuTrace};
 use zisk_core::{Riscv2zisk, ZiskRom};
 
 pub trait Emulator {
@@ -230,6 +230,28 @@ impl ZiskEmulator {
         emu.process_emu_trace(emu_trace, data_bus, with_mem_ops);
     }
 
+    /// COUNT phase, also storing a checkpoint of the emulator state every `interval` steps
+    pub fn process_emu_trace_with_checkpoints<F: PrimeField, T, DB: DataBusTrait<u64, T>>(
+        rom: &ZiskRom,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+        interval: u64,
+        checkpoints: &mut Vec<EmuChunkCheckpoint>,
+    ) {
+        // Create a emulator instance with this rom
+        let mut emu = Emu::new(rom);
+
+        // Run the emulation
+        emu.process_emu_trace_with_checkpoints(
+            emu_trace,
+            data_bus,
+            with_mem_ops,
+            interval,
+            checkpoints,
+        );
+    }
+
     /// EXPAND phase
     /// Third phase of the witness computation
     /// I have a
@@ -246,6 +268,75 @@ impl ZiskEmulator {
         emu.process_emu_traces(min_traces, chunk_id, data_bus);
     }
 
+    /// COUNT phase, fetching the instructions from a pre-decoded ROM
+    pub fn process_emu_trace_replay<F: PrimeField, T, DB: DataBusTrait<u64, T>>(
+        replay: &ReplayRom,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+    ) {
+        // Create a emulator instance with this rom
+        let mut emu = Emu::new(replay.rom());
+
+        // Run the emulation
+        emu.process_emu_trace_replay(replay, emu_trace, data_bus, with_mem_ops);
+    }
+
+    /// COUNT phase, fetching the instructions from a pre-decoded ROM and storing a checkpoint of
+    /// the emulator state every `interval` steps
+    pub fn process_emu_trace_replay_with_checkpoints<F: PrimeField, T, DB: DataBusTrait<u64, T>>(
+        replay: &ReplayRom,
+        emu_trace: &EmuTrace,
+        data_bus: &mut DB,
+        with_mem_ops: bool,
+        interval: u64,
+        checkpoints: &mut Vec<EmuChunkCheckpoint>,
+    ) {
+        // Create a emulator instance with this rom
+        let mut emu = Emu::new(replay.rom());
+
+        // Run the emulation
+        emu.process_emu_trace_replay_with_checkpoints(
+            replay,
+            emu_trace,
+            data_bus,
+            with_mem_ops,
+            interval,
+            checkpoints,
+        );
+    }
+
+    /// EXPAND phase, fetching the instructions from a pre-decoded ROM and resuming the chunk from
+    /// a checkpoint taken during the COUNT phase, if any
+    pub fn process_emu_traces_replay<F: PrimeField, T, DB: DataBusTrait<u64, T>>(
+        replay: &ReplayRom,
+        min_traces: &[EmuTrace],
+        chunk_id: usize,
+        checkpoint: Option<&EmuChunkCheckpoint>,
+        data_bus: &mut DB,
+    ) {
+        // Create a emulator instance with this rom
+        let mut emu = Emu::new(replay.rom());
+
+        // Run the emulation
+        emu.process_emu_traces_replay(replay, min_traces, chunk_id, checkpoint, data_bus);
+    }
+
+    /// EXPAND phase, resuming the chunk from a checkpoint taken during the COUNT phase
+    pub fn process_emu_traces_from<F: PrimeField, T, DB: DataBusTrait<u64, T>>(
+        rom: &ZiskRom,
+        min_traces: &[EmuTrace],
+        chunk_id: usize,
+        checkpoint: Option<&EmuChunkCheckpoint>,
+        data_bus: &mut DB,
+    ) {
+        // Create a emulator instance with this rom
+        let mut emu = Emu::new(rom);
+
+        // Run the emulation
+        emu.process_emu_traces_from(min_traces, chunk_id, checkpoint, data_bus);
+    }
+
     /// Finds all files in a directory and returns a vector with their full paths
     fn list_files(directory: &str) -> std::io::Result<Vec<String>> {
         // Define an internal function to call it recursively
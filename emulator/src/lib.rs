@@ -20,6 +20,7 @@ mod emu_full_trace;
 pub mod emu_options;
 mod emu_par_options;
 mod emu_reg_trace;
+mod emu_replay;
 mod emu_segment;
 mod emulator;
 mod emulator_errors;
@@ -39,6 +40,7 @@ pub use emu_full_trace::*;
 pub use emu_options::*;
 pub use emu_par_options::*;
 pub use emu_reg_trace::*;
+pub use emu_replay::*;
 pub use emu_segment::*;
 pub use emulator::*;
 pub use emulator_errors::*;
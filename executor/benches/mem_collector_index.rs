@@ -0,0 +1,108 @@
+#[macro_use]
+extern crate criterion;
+use std::collections::VecDeque;
+
+use criterion::{black_box, BatchSize, BenchmarkId, Criterion};
+use executor::MemCollectorIndex;
+use mem_common::{MemHelpers, MemModuleCheckPoint};
+use sm_mem::MemModuleCollector;
+use zisk_common::{BusDevice, BusId, MemBusData, MemCollectorInfo, SegmentId, MEM_BUS_ID};
+
+const RAM_ADDR: u32 = 0xa000_0000;
+const SEGMENT_SIZE: u32 = 0x10_0000;
+const NUM_ACCESSES: usize = 1 << 16;
+
+// Collectors of consecutive segments of the same memory area, each one owning SEGMENT_SIZE
+// bytes and sharing the boundary word with the next one, as in a chunk that feeds many segments
+fn build_collectors(n_segments: u32) -> Vec<MemModuleCollector> {
+    (0..n_segments)
+        .map(|i| {
+            let from_addr = (RAM_ADDR + i * SEGMENT_SIZE) >> 3;
+            let to_addr = (RAM_ADDR + (i + 1) * SEGMENT_SIZE) >> 3;
+            let check_point = MemModuleCheckPoint {
+                from_addr,
+                from_skip: 0,
+                to_addr,
+                to_count: u32::MAX,
+                count: NUM_ACCESSES as u32,
+            };
+            MemModuleCollector::new(
+                &check_point,
+                RAM_ADDR >> 3,
+                SegmentId(i as usize),
+                false,
+                false,
+            )
+        })
+        .collect()
+}
+
+fn build_accesses(n_segments: u32) -> Vec<[u64; 7]> {
+    let mut seed: u64 = 0x2545_f491_4f6c_dd1d;
+    (0..NUM_ACCESSES)
+        .map(|step| {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            let addr = RAM_ADDR + ((seed as u32) % (n_segments * SEGMENT_SIZE) & !7);
+            MemHelpers::mem_load(addr, step as u64, 0, 8, [seed, 0])
+        })
+        .collect()
+}
+
+fn bench_mem_dispatch(c: &mut Criterion) {
+    let mut group = c.benchmark_group("MemCollectorDispatch");
+    for n_segments in [1u32, 2, 3, 4, 16, 64] {
+        let accesses = build_accesses(n_segments);
+
+        group.bench_with_input(BenchmarkId::new("all", n_segments), &n_segments, |b, &n| {
+            b.iter_batched(
+                || build_collectors(n),
+                |mut collectors| {
+                    let mut pending: VecDeque<(BusId, Vec<u64>)> = VecDeque::new();
+                    for access in &accesses {
+                        for collector in collectors.iter_mut() {
+                            collector.process_data(&MEM_BUS_ID, access, &mut pending, None);
+                        }
+                    }
+                    black_box(collectors)
+                },
+                BatchSize::LargeInput,
+            )
+        });
+
+        group.bench_with_input(BenchmarkId::new("index", n_segments), &n_segments, |b, &n| {
+            b.iter_batched(
+                || {
+                    let collectors = build_collectors(n);
+                    let infos: Vec<MemCollectorInfo> =
+                        collectors.iter().map(|c| c.get_mem_collector_info()).collect();
+                    (collectors, MemCollectorIndex::new(&infos))
+                },
+                |(mut collectors, index)| {
+                    let mut pending: VecDeque<(BusId, Vec<u64>)> = VecDeque::new();
+                    for access in &accesses {
+                        index.for_each_collector(
+                            MemBusData::get_addr(access),
+                            MemBusData::get_bytes(access),
+                            |idx| {
+                                collectors[idx].process_data(
+                                    &MEM_BUS_ID,
+                                    access,
+                                    &mut pending,
+                                    None,
+                                );
+                            },
+                        );
+                    }
+                    black_box(collectors)
+                },
+                BatchSize::LargeInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_mem_dispatch);
+criterion_main!(benches);
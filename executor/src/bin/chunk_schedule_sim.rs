@@ -0,0 +1,65 @@
+//! Executable that compares the chunk schedulers of the collection on recorded chunk plans.
+
+use std::{env, path::Path, process};
+
+use executor::{simulate, ChunkSchedulePlan, ChunkScheduler};
+
+/// Simulates the collection of every plan recorded with `ZISK_CHUNK_SCHEDULE_RECORD` with each
+/// scheduler.
+/// The binary accepts 2 arguments: the path of the recorded plans, and optionally the number of
+/// collection threads (16 by default).
+fn main() {
+    let args: Vec<String> = env::args().collect();
+    if args.len() < 2 || args.len() > 3 {
+        eprintln!("Usage: chunk-schedule-sim <plans_file> [<n_threads>]");
+        process::exit(1);
+    }
+
+    let n_threads = match args.get(2).map(|arg| arg.parse::<usize>()) {
+        None => 16,
+        Some(Ok(n_threads)) if n_threads > 0 => n_threads,
+        Some(_) => {
+            eprintln!("Invalid number of threads: {}", args[2]);
+            process::exit(1);
+        }
+    };
+
+    let plans = ChunkSchedulePlan::read_all(Path::new(&args[1])).unwrap_or_else(|e| {
+        eprintln!("Failed to read the plans from {}: {}", args[1], e);
+        process::exit(1);
+    });
+
+    let schedulers = [ChunkScheduler::FewestChunks, ChunkScheduler::InstanceLifetime];
+    println!(
+        "{:>4} {:>6} {:>9} {:>18} {:>14} {:>14} {:>14} {:>9} {:>14}",
+        "plan",
+        "chunks",
+        "instances",
+        "scheduler",
+        "makespan",
+        "first_ready",
+        "mean_ready",
+        "peak_open",
+        "peak_weight"
+    );
+    for (plan_id, plan) in plans.iter().enumerate() {
+        let n_chunks = plan.chunks_to_execute.iter().filter(|ids| !ids.is_empty()).count();
+        let n_instances = plan.global_id_chunks().len();
+        for scheduler in schedulers {
+            let order = scheduler.order(plan);
+            let result = simulate(plan, &order, n_threads);
+            println!(
+                "{:>4} {:>6} {:>9} {:>18} {:>14} {:>14} {:>14} {:>9} {:>14}",
+                plan_id,
+                n_chunks,
+                n_instances,
+                scheduler.name(),
+                result.makespan,
+                result.first_ready,
+                result.mean_ready,
+                result.peak_open_instances,
+                result.peak_open_weight
+            );
+        }
+    }
+}
@@ -0,0 +1,388 @@
+//! The `ChunkScheduler` module decides the order in which the chunks are replayed to collect the
+//! inputs of the secondary instances.
+//!
+//! The collectors of an instance are alive from the replay of its first chunk until the replay of
+//! its last one, when the instance is witness-ready and its collectors are drained. The order
+//! of the chunks decides how many instances are alive at the same time, and their collector size
+//! the peak collector memory, and how soon the first instances can start their witness
+//! computation.
+//!
+//! A `ChunkSchedulePlan` can be recorded by the executor and replayed offline by the
+//! `chunk-schedule-sim` binary, which compares the schedulers with `simulate`.
+
+use std::{
+    cmp::Reverse,
+    collections::{BinaryHeap, HashMap},
+    fs::OpenOptions,
+    io::{self, BufRead, BufReader, Write},
+    path::Path,
+};
+
+/// Chunks to replay and the instances each one feeds.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct ChunkSchedulePlan {
+    /// Global IDs of the instances fed by each chunk, indexed by chunk ID.
+    pub chunks_to_execute: Vec<Vec<usize>>,
+
+    /// Replay cost of each chunk, in steps, indexed by chunk ID.
+    pub chunk_costs: Vec<u64>,
+
+    /// Collector size of each instance, by global ID, e.g. its number of rows. Instances without
+    /// a size weigh 1.
+    pub instance_weights: HashMap<usize, u64>,
+}
+
+impl ChunkSchedulePlan {
+    /// Creates a new `ChunkSchedulePlan`.
+    ///
+    /// # Arguments
+    /// * `chunks_to_execute` - Global IDs of the instances fed by each chunk.
+    /// * `chunk_costs` - Replay cost of each chunk.
+    pub fn new(chunks_to_execute: Vec<Vec<usize>>, chunk_costs: Vec<u64>) -> Self {
+        debug_assert_eq!(chunks_to_execute.len(), chunk_costs.len());
+        Self { chunks_to_execute, chunk_costs, instance_weights: HashMap::new() }
+    }
+
+    /// Sets the collector size of each instance, by global ID.
+    pub fn with_instance_weights(mut self, instance_weights: HashMap<usize, u64>) -> Self {
+        self.instance_weights = instance_weights;
+        self
+    }
+
+    /// Returns the collector size of the instance `global_id`.
+    pub fn instance_weight(&self, global_id: usize) -> u64 {
+        self.instance_weights.get(&global_id).copied().unwrap_or(1)
+    }
+
+    /// Returns the chunks of each instance, sorted by chunk ID.
+    pub fn global_id_chunks(&self) -> HashMap<usize, Vec<usize>> {
+        let mut global_id_chunks: HashMap<usize, Vec<usize>> = HashMap::new();
+        for (chunk_id, global_ids) in self.chunks_to_execute.iter().enumerate() {
+            for global_id in global_ids {
+                global_id_chunks.entry(*global_id).or_default().push(chunk_id);
+            }
+        }
+        global_id_chunks
+    }
+
+    /// Appends the plan to a text file, one line per chunk with its cost followed by the global
+    /// IDs it feeds, after a `plan <n_chunks>` header line. The instance weights follow, if any, in
+    /// a `weights <global_id>:<weight> ...` line.
+    pub fn append_to(&self, path: &Path) -> io::Result<()> {
+        let mut file = OpenOptions::new().create(true).append(true).open(path)?;
+        let mut text = format!("plan {}\n", self.chunks_to_execute.len());
+        for (cost, global_ids) in self.chunk_costs.iter().zip(&self.chunks_to_execute) {
+            text.push_str(&cost.to_string());
+            for global_id in global_ids {
+                text.push(' ');
+                text.push_str(&global_id.to_string());
+            }
+            text.push('\n');
+        }
+        if !self.instance_weights.is_empty() {
+            let mut instance_weights: Vec<_> = self.instance_weights.iter().collect();
+            instance_weights.sort_unstable();
+            text.push_str("weights");
+            for (global_id, weight) in instance_weights {
+                text.push_str(&format!(" {global_id}:{weight}"));
+            }
+            text.push('\n');
+        }
+        file.write_all(text.as_bytes())
+    }
+
+    /// Reads all the plans appended to a text file by `append_to`. Plans recorded without weights
+    /// are read with all the instances weighing 1.
+    pub fn read_all(path: &Path) -> io::Result<Vec<Self>> {
+        let invalid = |line: &str| {
+            io::Error::new(io::ErrorKind::InvalidData, format!("Invalid chunk plan line: {line}"))
+        };
+        let parse = |value: &str, line: &str| value.parse::<u64>().map_err(|_| invalid(line));
+
+        let mut plans: Vec<Self> = Vec::new();
+        let mut lines = BufReader::new(std::fs::File::open(path)?).lines();
+        while let Some(line) = lines.next() {
+            let line = line?;
+            if let Some(weights) = line.strip_prefix("weights") {
+                let plan = plans.last_mut().ok_or_else(|| invalid(&line))?;
+                for weight in weights.split_whitespace() {
+                    let (global_id, weight) =
+                        weight.split_once(':').ok_or_else(|| invalid(&line))?;
+                    plan.instance_weights
+                        .insert(parse(global_id, &line)? as usize, parse(weight, &line)?);
+                }
+                continue;
+            }
+            let n_chunks = match line.strip_prefix("plan ") {
+                Some(n_chunks) => parse(n_chunks, &line)? as usize,
+                None => return Err(invalid(&line)),
+            };
+
+            let mut plan = Self::default();
+            for _ in 0..n_chunks {
+                let line = lines.next().ok_or_else(|| invalid("<eof>"))??;
+                let mut values = line.split_whitespace();
+                let cost = parse(values.next().ok_or_else(|| invalid(&line))?, &line)?;
+                let global_ids = values
+                    .map(|value| parse(value, &line).map(|id| id as usize))
+                    .collect::<io::Result<Vec<_>>>()?;
+                plan.chunk_costs.push(cost);
+                plan.chunks_to_execute.push(global_ids);
+            }
+            plans.push(plan);
+        }
+        Ok(plans)
+    }
+}
+
+/// Chunk ordering strategy.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ChunkScheduler {
+    /// Repeatedly takes the instance with the fewest chunks left and replays all of them. Default
+    /// scheduler of the executor.
+    FewestChunks,
+
+    /// Closes the instances whose collectors are already alive before opening new ones, taking
+    /// first the instance whose chunks left open the smallest collectors, then the one with the
+    /// lowest replay cost left.
+    InstanceLifetime,
+}
+
+impl ChunkScheduler {
+    /// Returns the scheduler named `name`, as accepted by the `ZISK_CHUNK_SCHEDULER` environment
+    /// variable.
+    pub fn from_name(name: &str) -> Option<Self> {
+        match name {
+            "fewest_chunks" => Some(Self::FewestChunks),
+            "instance_lifetime" => Some(Self::InstanceLifetime),
+            _ => None,
+        }
+    }
+
+    /// Returns the name of the scheduler.
+    pub fn name(&self) -> &'static str {
+        match self {
+            Self::FewestChunks => "fewest_chunks",
+            Self::InstanceLifetime => "instance_lifetime",
+        }
+    }
+
+    /// Returns the order in which the chunks of `plan` must be replayed. Chunks that don't feed
+    /// any instance are not included.
+    pub fn order(&self, plan: &ChunkSchedulePlan) -> Vec<usize> {
+        let global_id_chunks = plan.global_id_chunks();
+        match self {
+            Self::FewestChunks => {
+                order_by_fewest_chunks(&plan.chunks_to_execute, &global_id_chunks)
+            }
+            Self::InstanceLifetime => order_by_instance_lifetime(plan, &global_id_chunks),
+        }
+    }
+}
+
+fn order_by_fewest_chunks(
+    chunks_to_execute: &[Vec<usize>],
+    global_id_chunks: &HashMap<usize, Vec<usize>>,
+) -> Vec<usize> {
+    let mut ordered_chunks = Vec::new();
+    let mut already_selected_chunks = vec![false; chunks_to_execute.len()];
+
+    let mut n_global_ids_incompleted = global_id_chunks.len();
+    let mut n_chunks_by_global_id: HashMap<usize, usize> =
+        global_id_chunks.iter().map(|(global_id, chunks)| (*global_id, chunks.len())).collect();
+
+    while n_global_ids_incompleted > 0 {
+        let selected_global_id = n_chunks_by_global_id
+            .iter()
+            .filter(|(_, &count)| count > 0)
+            .min_by_key(|(_, &count)| count)
+            .map(|(&global_id, _)| global_id);
+
+        if let Some(global_id) = selected_global_id {
+            for chunk_id in global_id_chunks[&global_id].iter() {
+                if already_selected_chunks[*chunk_id] {
+                    continue;
+                }
+                ordered_chunks.push(*chunk_id);
+                already_selected_chunks[*chunk_id] = true;
+                for global_idx in chunks_to_execute[*chunk_id].iter() {
+                    if let Some(count) = n_chunks_by_global_id.get_mut(global_idx) {
+                        *count -= 1;
+                        if *count == 0 {
+                            n_chunks_by_global_id.remove(global_idx);
+                            n_global_ids_incompleted -= 1;
+                        }
+                    }
+                }
+            }
+        } else {
+            break;
+        }
+    }
+
+    ordered_chunks
+}
+
+fn order_by_instance_lifetime(
+    plan: &ChunkSchedulePlan,
+    global_id_chunks: &HashMap<usize, Vec<usize>>,
+) -> Vec<usize> {
+    let mut ordered_chunks = Vec::new();
+    let mut already_selected_chunks = vec![false; plan.chunks_to_execute.len()];
+
+    // Replay cost left and whether its collectors are alive, by global ID
+    let mut cost_left: HashMap<usize, u64> = global_id_chunks
+        .iter()
+        .map(|(global_id, chunks)| {
+            (*global_id, chunks.iter().map(|&chunk_id| plan.chunk_costs[chunk_id]).sum())
+        })
+        .collect();
+    let mut open: HashMap<usize, bool> =
+        global_id_chunks.keys().map(|&global_id| (global_id, false)).collect();
+
+    // Collector size of the instances not alive yet, itself included, that would be opened by
+    // replaying all the chunks left of an instance
+    let opened_by = |global_id: usize, selected: &[bool], open: &HashMap<usize, bool>| {
+        let mut opened: Vec<usize> = global_id_chunks[&global_id]
+            .iter()
+            .filter(|&&chunk_id| !selected[chunk_id])
+            .flat_map(|&chunk_id| plan.chunks_to_execute[chunk_id].iter().copied())
+            .filter(|other| open.get(other) == Some(&false))
+            .collect();
+        opened.sort_unstable();
+        opened.dedup();
+        opened.iter().map(|&other| plan.instance_weight(other)).sum::<u64>()
+    };
+
+    while !cost_left.is_empty() {
+        // Close the alive instances first, the ones that open the smallest collectors and then
+        // the cheapest ones to finish first. Otherwise open the cheapest instance.
+        let selected_global_id = cost_left
+            .iter()
+            .filter(|(global_id, _)| open[global_id])
+            .min_by_key(|(&global_id, &cost)| {
+                (opened_by(global_id, &already_selected_chunks, &open), cost, global_id)
+            })
+            .map(|(&global_id, _)| global_id)
+            .or_else(|| {
+                cost_left
+                    .iter()
+                    .min_by_key(|(&global_id, &cost)| {
+                        (cost, opened_by(global_id, &already_selected_chunks, &open), global_id)
+                    })
+                    .map(|(&global_id, _)| global_id)
+            });
+
+        let Some(global_id) = selected_global_id else {
+            break;
+        };
+
+        // Chunks in ascending order, consecutive chunks usually feed the same instances
+        for &chunk_id in global_id_chunks[&global_id].iter() {
+            if already_selected_chunks[chunk_id] {
+                continue;
+            }
+            ordered_chunks.push(chunk_id);
+            already_selected_chunks[chunk_id] = true;
+            for global_idx in plan.chunks_to_execute[chunk_id].iter() {
+                if let Some(cost) = cost_left.get_mut(global_idx) {
+                    *cost -= plan.chunk_costs[chunk_id];
+                    open.insert(*global_idx, true);
+                }
+            }
+            for global_idx in plan.chunks_to_execute[chunk_id].iter() {
+                let done = global_id_chunks[global_idx]
+                    .iter()
+                    .all(|&chunk_id| already_selected_chunks[chunk_id]);
+                if done {
+                    cost_left.remove(global_idx);
+                    open.insert(*global_idx, false);
+                }
+            }
+        }
+    }
+
+    ordered_chunks
+}
+
+/// Result of simulating the replay of the chunks of a plan in a given order.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ChunkScheduleSimulation {
+    /// Time when the last chunk is replayed.
+    pub makespan: u64,
+
+    /// Time when the first instance is witness-ready.
+    pub first_ready: u64,
+
+    /// Mean time when the instances are witness-ready.
+    pub mean_ready: u64,
+
+    /// Maximum number of instances with alive collectors at the same time.
+    pub peak_open_instances: usize,
+
+    /// Maximum collector size of the instances alive at the same time, see
+    /// `ChunkSchedulePlan::instance_weights`.
+    pub peak_open_weight: u64,
+}
+
+/// Simulates the replay of the chunks of `plan` in `order` by `n_workers` threads, which take the
+/// next chunk of the order as soon as they are free, as the collection threads do. Times are in
+/// the units of the chunk costs.
+pub fn simulate(
+    plan: &ChunkSchedulePlan,
+    order: &[usize],
+    n_workers: usize,
+) -> ChunkScheduleSimulation {
+    let mut workers: BinaryHeap<Reverse<u64>> = (0..n_workers.max(1)).map(|_| Reverse(0)).collect();
+
+    // First start and last end of the replays of the chunks of each instance
+    let mut lifetimes: HashMap<usize, (u64, u64)> = HashMap::new();
+    let mut makespan = 0;
+    for &chunk_id in order {
+        let Reverse(start) = workers.pop().unwrap();
+        let end = start + plan.chunk_costs[chunk_id];
+        workers.push(Reverse(end));
+        makespan = makespan.max(end);
+
+        for global_id in &plan.chunks_to_execute[chunk_id] {
+            let lifetime = lifetimes.entry(*global_id).or_insert((start, end));
+            lifetime.0 = lifetime.0.min(start);
+            lifetime.1 = lifetime.1.max(end);
+        }
+    }
+
+    if lifetimes.is_empty() {
+        return ChunkScheduleSimulation { makespan, ..Default::default() };
+    }
+
+    let first_ready = lifetimes.values().map(|&(_, ready)| ready).min().unwrap();
+    let mean_ready =
+        lifetimes.values().map(|&(_, ready)| ready).sum::<u64>() / lifetimes.len() as u64;
+
+    // Collectors are released when the instance is ready, before any collector opened at the
+    // same time is created
+    let mut events: Vec<(u64, i64, i64)> = lifetimes
+        .iter()
+        .flat_map(|(&global_id, &(open, ready))| {
+            let weight = plan.instance_weight(global_id) as i64;
+            [(open, 1, weight), (ready, -1, -weight)]
+        })
+        .collect();
+    events.sort_unstable();
+    let (mut open_instances, mut open_weight) = (0i64, 0i64);
+    let (mut peak_open_instances, mut peak_open_weight) = (0i64, 0i64);
+    for (_, delta, weight) in events {
+        open_instances += delta;
+        open_weight += weight;
+        peak_open_instances = peak_open_instances.max(open_instances);
+        peak_open_weight = peak_open_weight.max(open_weight);
+    }
+
+    ChunkScheduleSimulation {
+        makespan,
+        first_ready,
+        mean_ready,
+        peak_open_instances: peak_open_instances as usize,
+        peak_open_weight: peak_open_weight as u64,
+    }
+}
@@ -20,8 +20,8 @@
 //! maintaining clarity and modularity in the computation process.
 
 use asm_runner::{
-    write_input, AsmMTHeader, AsmRunnerMO, AsmRunnerMT, AsmRunnerRH, AsmServices, AsmSharedMemory,
-    MinimalTraces, PreloadedMO, PreloadedMT, PreloadedRH, SharedMemoryWriter, Task, TaskFactory,
+    AsmInput, AsmRunnerMO, AsmRunnerMT, AsmRunnerRH, AsmServices, MinimalTraces, PreloadedMO,
+    PreloadedMT, PreloadedRH, SharedMemoryWriter, Task, TaskFactory,
 };
 use fields::PrimeField64;
 use pil_std_lib::Std;
@@ -30,38 +30,40 @@ use proofman_util::{timer_start_info, timer_stop_and_log_info};
 use rayon::prelude::*;
 use rom_setup::gen_elf_hash;
 use sm_rom::{RomInstance, RomSM};
-use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use witness::WitnessComponent;
 use zisk_common::io::{ZiskIO, ZiskStdin};
 
-use crate::DummyCounter;
+use crate::{
+    ChunkSchedulePlan, ChunkScheduler, DummyCounter, OperationBusStream, RecordingDataBus,
+};
 use data_bus::DataBusTrait;
 use sm_main::{MainInstance, MainPlanner, MainSM};
 use zisk_common::{
     BusDevice, BusDeviceMetrics, CheckPoint, ExecutorStats, ExecutorStatsHandle, Instance,
     InstanceCtx, InstanceType, Plan, Stats, ZiskExecutionResult,
 };
-use zisk_common::{ChunkId, PayloadType};
+use zisk_common::{ChunkId, PayloadType, OPERATION_BUS_ID};
 use zisk_pil::{
     RomRomTrace, ZiskPublicValues, INPUT_DATA_AIR_IDS, MAIN_AIR_IDS, MEM_AIR_IDS, ROM_AIR_IDS,
     ROM_DATA_AIR_IDS, ZISK_AIRGROUP_ID,
 };
 
 use std::thread::JoinHandle;
-use std::time::Instant;
+use std::time::{Instant, SystemTime};
 use std::{
-    collections::HashMap,
+    collections::{HashMap, HashSet},
     path::PathBuf,
-    sync::{Arc, Mutex, RwLock},
+    sync::{mpsc, Arc, Mutex, RwLock},
 };
 #[cfg(feature = "stats")]
 use zisk_common::ExecutorStatsEvent;
 
 use crossbeam::atomic::AtomicCell;
 
-use zisk_common::EmuTrace;
+use zisk_common::{EmuChunkCheckpoint, EmuTrace};
 use zisk_core::{ZiskRom, MAX_INPUT_SIZE};
-use ziskemu::{EmuOptions, ZiskEmulator};
+use ziskemu::{EmuOptions, ReplayRom, ZiskEmulator};
 
 use crate::StaticSMBundle;
 
@@ -69,6 +71,44 @@ type DeviceMetricsByChunk = (ChunkId, Box<dyn BusDeviceMetrics>); // (chunk_id,
 type DeviceMetricsList = Vec<DeviceMetricsByChunk>;
 pub type NestedDeviceMetricsList = HashMap<usize, DeviceMetricsList>;
 
+/// Environment variable that enables persisting the operation bus payloads of each chunk during
+/// the count phase, so the chunks whose secondary instances only listen to the operation bus are
+/// collected from the recorded payloads instead of being emulated again.
+pub const PERSIST_OP_BUS_STREAMS_ENV: &str = "ZISK_PERSIST_OP_BUS_STREAMS";
+
+/// Environment variable with the number of steps between the emulator checkpoints stored for each
+/// chunk during the count phase. Chunks collected only by precompiled instances resume from the
+/// last checkpoint before the first operation they need. Unset or 0 disables the checkpoints.
+pub const CHUNK_CHECKPOINT_INTERVAL_ENV: &str = "ZISK_CHUNK_CHECKPOINT_INTERVAL";
+
+/// Environment variable that enables replaying the minimal traces with the ROM pre-decoded by
+/// `ReplayRom`, in the count and collect phases. It can be combined with
+/// `CHUNK_CHECKPOINT_INTERVAL_ENV`, the checkpoints are then taken by the pre-decoded replay.
+pub const PREDECODED_REPLAY_ENV: &str = "ZISK_PREDECODED_REPLAY";
+
+/// Environment variable with the name of the `ChunkScheduler` that orders the chunks replayed in
+/// the collection, `fewest_chunks` by default. `instance_lifetime` is opt-in.
+pub const CHUNK_SCHEDULER_ENV: &str = "ZISK_CHUNK_SCHEDULER";
+
+/// Environment variable with the path of a file where the chunk plan of every collection is
+/// appended, to be compared offline with the `chunk-schedule-sim` binary.
+pub const CHUNK_SCHEDULE_RECORD_ENV: &str = "ZISK_CHUNK_SCHEDULE_RECORD";
+
+/// Environment variable with the number of workers that compute the witness of the secondary
+/// instances during `pre_calculate_witness`, as soon as their collection finishes and while the
+/// rest of the chunks are still being collected. Unset or 0 computes them in `calculate_witness`.
+pub const STREAMING_WITNESS_ENV: &str = "ZISK_STREAMING_WITNESS";
+
+/// Environment variable with the number of trace buffers of the pool that the streamed instances
+/// can take in a collection, the number of streaming workers by default. The buffers of the
+/// streamed instances are only released once they are proved, and `BufferPool` has no capacity
+/// query, so above the buffers of the pool the calling thread waits in `take_buffer` until a proof
+/// returns one. The collection threads never wait for it.
+pub const STREAMING_WITNESS_BUFFERS_ENV: &str = "ZISK_STREAMING_WITNESS_BUFFERS";
+
+/// Modification time and size of a file-based input, see `ZiskStdin::file_stamp`.
+type StdinStamp = (SystemTime, u64);
+
 #[allow(dead_code)]
 enum MinimalTraceExecutionMode {
     Emulator,
@@ -143,7 +183,51 @@ pub struct ZiskExecutor<F: PrimeField64> {
     asm_shmem_mo: Arc<Mutex<Option<PreloadedMO>>>,
     asm_shmem_rh: Arc<Mutex<Option<PreloadedRH>>>,
 
-    shmem_input_writer: [Arc<Mutex<Option<SharedMemoryWriter>>>; AsmServices::SERVICES.len()],
+    /// Writer of the input shared memory, a single one for all the services.
+    shmem_input_writer: Mutex<Option<SharedMemoryWriter>>,
+
+    /// Input of the next assembly execution, being read and framed in the background since
+    /// `set_stdin`. The thread gives back the stdin with the framed input and the stamp of its
+    /// file.
+    staged_asm_input: Mutex<Option<JoinHandle<(ZiskStdin, AsmInput, Option<StdinStamp>)>>>,
+
+    /// Input of the last assembly execution, the one in the input shared memory of the services,
+    /// with the stamp of the file it was read from.
+    asm_input: Mutex<Option<(Arc<AsmInput>, Option<StdinStamp>)>>,
+
+    /// Whether the operation bus payloads of each chunk are recorded during the count phase.
+    persist_op_bus_streams: bool,
+
+    /// Operation bus payloads recorded during the count phase, indexed by chunk ID. Empty when
+    /// `persist_op_bus_streams` is disabled.
+    op_bus_streams: Arc<RwLock<Vec<Option<OperationBusStream>>>>,
+
+    /// Number of steps between the checkpoints stored for each chunk, 0 if disabled.
+    checkpoint_interval: u64,
+
+    /// Emulator checkpoints stored during the count phase, indexed by chunk ID. Empty when
+    /// `checkpoint_interval` is 0.
+    chunk_checkpoints: Arc<RwLock<Vec<Vec<EmuChunkCheckpoint>>>>,
+
+    /// Pre-decoded ROM used to replay the minimal traces, `None` to use the ROM directly.
+    replay_rom: Option<Arc<ReplayRom>>,
+
+    /// Scheduler that orders the chunks replayed in the collection.
+    chunk_scheduler: ChunkScheduler,
+
+    /// File where the chunk plans are recorded, if any.
+    chunk_schedule_record: Option<PathBuf>,
+
+    /// Number of workers computing the witness of the collected instances while the collection
+    /// is still running, 0 if disabled.
+    streaming_witness_workers: usize,
+
+    /// Number of trace buffers the streamed instances can take from the pool in a collection.
+    streaming_witness_buffers: usize,
+
+    /// Global IDs of the secondary instances whose witness was already computed while they were
+    /// collected, so `calculate_witness` skips them.
+    streamed_witnesses: Mutex<HashSet<usize>>,
 }
 
 impl<F: PrimeField64> ZiskExecutor<F> {
@@ -186,6 +270,33 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             (None, None)
         };
 
+        let persist_op_bus_streams =
+            std::env::var(PERSIST_OP_BUS_STREAMS_ENV).is_ok_and(|value| value != "0");
+        let checkpoint_interval = std::env::var(CHUNK_CHECKPOINT_INTERVAL_ENV)
+            .ok()
+            .and_then(|value| value.parse::<u64>().ok())
+            .unwrap_or(0);
+        let replay_rom = std::env::var(PREDECODED_REPLAY_ENV)
+            .is_ok_and(|value| value != "0")
+            .then(|| Arc::new(ReplayRom::new(zisk_rom.clone())));
+        let chunk_scheduler = match std::env::var(CHUNK_SCHEDULER_ENV) {
+            Ok(name) => ChunkScheduler::from_name(&name).unwrap_or_else(|| {
+                tracing::warn!("Unknown chunk scheduler {}, using fewest_chunks", name);
+                ChunkScheduler::FewestChunks
+            }),
+            Err(_) => ChunkScheduler::FewestChunks,
+        };
+        let chunk_schedule_record =
+            std::env::var(CHUNK_SCHEDULE_RECORD_ENV).ok().map(PathBuf::from);
+        let streaming_witness_workers = std::env::var(STREAMING_WITNESS_ENV)
+            .ok()
+            .and_then(|value| value.parse::<usize>().ok())
+            .unwrap_or(0);
+        let streaming_witness_buffers = std::env::var(STREAMING_WITNESS_BUFFERS_ENV)
+            .ok()
+            .and_then(|value| value.parse::<usize>().ok())
+            .unwrap_or(streaming_witness_workers);
+
         Self {
             stdin: Mutex::new(ZiskStdin::null()),
             rom_path,
@@ -210,13 +321,77 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             asm_shmem_mt: Arc::new(Mutex::new(asm_shmem_mt)),
             asm_shmem_mo: Arc::new(Mutex::new(asm_shmem_mo)),
             asm_shmem_rh: Arc::new(Mutex::new(None)),
-            shmem_input_writer: std::array::from_fn(|_| Arc::new(Mutex::new(None))),
+            shmem_input_writer: Mutex::new(None),
+            staged_asm_input: Mutex::new(None),
+            asm_input: Mutex::new(None),
+            persist_op_bus_streams,
+            op_bus_streams: Arc::new(RwLock::new(Vec::new())),
+            checkpoint_interval,
+            chunk_checkpoints: Arc::new(RwLock::new(Vec::new())),
+            replay_rom,
+            chunk_scheduler,
+            chunk_schedule_record,
+            streaming_witness_workers,
+            streaming_witness_buffers,
+            streamed_witnesses: Mutex::new(HashSet::new()),
         }
     }
 
+    /// Sets the input of the next executions.
+    ///
+    /// With the assembly services the input is read and framed once, in the background, and
+    /// reused by the next executions until `set_stdin` is called again. A file-based input is
+    /// read again when the modification time or the size of its file change, so rewriting the
+    /// file between executions is seen as before. A rewrite that keeps both of them unchanged
+    /// isn't detected, and needs a new `set_stdin`.
     pub fn set_stdin(&self, stdin: ZiskStdin) {
-        let mut guard = self.stdin.lock().unwrap();
-        *guard = stdin;
+        if self.asm_runner_path.is_none() {
+            let mut guard = self.stdin.lock().unwrap();
+            *guard = stdin;
+            return;
+        }
+
+        // Stage the input of the assembly services while the current proof, if any, finishes
+        let mut stdin = stdin;
+        let handle = std::thread::spawn(move || {
+            // stamp taken before reading, a change while reading is seen on the next execution
+            let stamp = stdin.file_stamp();
+            let asm_input = AsmInput::from_stdin(&mut stdin);
+            (stdin, asm_input, stamp)
+        });
+
+        // An input staged but never executed is replaced
+        if let Some(previous) = self.staged_asm_input.lock().unwrap().replace(handle) {
+            let _ = previous.join();
+        }
+    }
+
+    /// Returns the input of the assembly execution: the staged one if `set_stdin` has been called
+    /// since the last execution, otherwise the last one. The last one is read again if it comes
+    /// from a file that has changed since it was read.
+    fn take_asm_input(&self) -> Arc<AsmInput> {
+        let staged = self.staged_asm_input.lock().unwrap().take();
+        let mut asm_input = self.asm_input.lock().unwrap();
+
+        if let Some(handle) = staged {
+            let (stdin, staged_input, stamp) = handle.join().expect("Failed to stage the input");
+            *self.stdin.lock().unwrap() = stdin;
+            *asm_input = Some((Arc::new(staged_input), stamp));
+        } else {
+            let mut stdin = self.stdin.lock().unwrap();
+            let stamp = stdin.file_stamp();
+            let stale = match &*asm_input {
+                None => true,
+                Some((_, read_stamp)) => {
+                    stdin.is_file() && (read_stamp.is_none() || *read_stamp != stamp)
+                }
+            };
+            if stale {
+                *asm_input = Some((Arc::new(AsmInput::from_stdin(&mut stdin)), stamp));
+            }
+        }
+
+        asm_input.as_ref().unwrap().0.clone()
     }
 
     #[allow(clippy::type_complexity)]
@@ -277,56 +452,49 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             ExecutorStatsEvent::Begin,
         );
 
-        AsmServices::SERVICES.par_iter().enumerate().for_each(|(idx, service)| {
-            #[cfg(feature = "stats")]
-            let stats_id = self.stats.next_id();
-            #[cfg(feature = "stats")]
-            self.stats.add_stat(
-                parent_stats_id,
-                stats_id,
-                "ASM_WRITE_INPUT",
-                0,
-                ExecutorStatsEvent::Begin,
-            );
-
-            let port = if let Some(base_port) = self.base_port {
-                AsmServices::port_for(service, base_port, self.local_rank)
-            } else {
-                AsmServices::default_port(service, self.local_rank)
-            };
+        // The input is framed once and copied as is to the input shared memory, that all the
+        // services map
+        let asm_input = self.take_asm_input();
 
-            let shmem_input_name =
-                AsmSharedMemory::<AsmMTHeader>::shmem_input_name(port, *service, self.local_rank);
+        #[cfg(feature = "stats")]
+        let stats_id = self.stats.next_id();
+        #[cfg(feature = "stats")]
+        self.stats.add_stat(
+            parent_stats_id,
+            stats_id,
+            "ASM_WRITE_INPUT",
+            0,
+            ExecutorStatsEvent::Begin,
+        );
 
-            let mut input_writer = self.shmem_input_writer[idx].lock().unwrap();
-            if input_writer.is_none() {
-                tracing::info!(
-                    "Initializing SharedMemoryWriter for service {:?} at '{}'",
-                    service,
-                    shmem_input_name
-                );
-                *input_writer = Some(
-                    SharedMemoryWriter::new(
-                        &shmem_input_name,
-                        MAX_INPUT_SIZE as usize,
-                        self.unlock_mapped_memory,
-                    )
-                    .expect("Failed to create SharedMemoryWriter"),
-                );
-            }
+        let mut input_writer = self.shmem_input_writer.lock().unwrap();
+        if input_writer.is_none() {
+            let shmem_input_name = AsmServices::shmem_input_name(self.base_port, self.local_rank);
+            tracing::info!("Initializing SharedMemoryWriter at '{}'", shmem_input_name);
+            *input_writer = Some(
+                SharedMemoryWriter::new(
+                    &shmem_input_name,
+                    MAX_INPUT_SIZE as usize,
+                    self.unlock_mapped_memory,
+                )
+                .expect("Failed to create SharedMemoryWriter"),
+            );
+        }
 
-            write_input(&mut self.stdin.lock().unwrap(), input_writer.as_ref().unwrap());
+        if !asm_input.write(input_writer.as_ref().unwrap()) {
+            tracing::debug!("Input generation {} already written", asm_input.generation());
+        }
+        drop(input_writer);
 
-            // Add to executor stats
-            #[cfg(feature = "stats")]
-            self.stats.add_stat(
-                parent_stats_id,
-                stats_id,
-                "ASM_WRITE_INPUT",
-                0,
-                ExecutorStatsEvent::End,
-            );
-        });
+        // Add to executor stats
+        #[cfg(feature = "stats")]
+        self.stats.add_stat(
+            parent_stats_id,
+            stats_id,
+            "ASM_WRITE_INPUT",
+            0,
+            ExecutorStatsEvent::End,
+        );
 
         let chunk_size = self.chunk_size;
         let (world_rank, local_rank, base_port) =
@@ -415,8 +583,10 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         {
             chunk_id: ChunkId,
             emu_trace: Arc<EmuTrace>,
-            data_bus: DB,
+            data_bus: RecordingDataBus<DB>,
             zisk_rom: Arc<ZiskRom>,
+            replay_rom: Option<Arc<ReplayRom>>,
+            checkpoint_interval: u64,
             _phantom: std::marker::PhantomData<F>,
             _stats: ExecutorStatsHandle,
             _parent_stats_id: u64,
@@ -427,7 +597,7 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             F: PrimeField64,
             DB: DataBusTrait<PayloadType, Box<dyn BusDeviceMetrics>> + Send + Sync + 'static,
         {
-            type Output = (ChunkId, DB);
+            type Output = (ChunkId, DB, Option<OperationBusStream>, Vec<EmuChunkCheckpoint>);
 
             fn execute(mut self) -> Self::Output {
                 #[cfg(feature = "stats")]
@@ -441,12 +611,45 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                     ExecutorStatsEvent::Begin,
                 );
 
-                ZiskEmulator::process_emu_trace::<F, _, _>(
-                    &self.zisk_rom,
-                    &self.emu_trace,
-                    &mut self.data_bus,
-                    false,
-                );
+                let mut checkpoints = Vec::new();
+                match (&self.replay_rom, self.checkpoint_interval) {
+                    (Some(replay_rom), 0) => {
+                        ZiskEmulator::process_emu_trace_replay::<F, _, _>(
+                            replay_rom,
+                            &self.emu_trace,
+                            &mut self.data_bus,
+                            false,
+                        );
+                    }
+                    (Some(replay_rom), checkpoint_interval) => {
+                        ZiskEmulator::process_emu_trace_replay_with_checkpoints::<F, _, _>(
+                            replay_rom,
+                            &self.emu_trace,
+                            &mut self.data_bus,
+                            false,
+                            checkpoint_interval,
+                            &mut checkpoints,
+                        );
+                    }
+                    (None, 0) => {
+                        ZiskEmulator::process_emu_trace::<F, _, _>(
+                            &self.zisk_rom,
+                            &self.emu_trace,
+                            &mut self.data_bus,
+                            false,
+                        );
+                    }
+                    (None, checkpoint_interval) => {
+                        ZiskEmulator::process_emu_trace_with_checkpoints::<F, _, _>(
+                            &self.zisk_rom,
+                            &self.emu_trace,
+                            &mut self.data_bus,
+                            false,
+                            checkpoint_interval,
+                            &mut checkpoints,
+                        );
+                    }
+                }
 
                 self.data_bus.on_close();
 
@@ -460,18 +663,25 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                     ExecutorStatsEvent::End,
                 );
 
-                (self.chunk_id, self.data_bus)
+                let (data_bus, op_bus_stream) = self.data_bus.into_parts();
+                (self.chunk_id, data_bus, op_bus_stream, checkpoints)
             }
         }
 
         let task_factory: TaskFactory<_> =
             Box::new(|chunk_id: ChunkId, emu_trace: Arc<EmuTrace>| {
-                let data_bus = self.sm_bundle.build_data_bus_counters();
+                let data_bus = RecordingDataBus::new(
+                    self.sm_bundle.build_data_bus_counters(),
+                    OPERATION_BUS_ID,
+                    self.persist_op_bus_streams,
+                );
                 CounterTask {
                     chunk_id,
                     emu_trace,
                     data_bus,
                     zisk_rom: self.zisk_rom.clone(),
+                    replay_rom: self.replay_rom.clone(),
+                    checkpoint_interval: self.checkpoint_interval,
                     _phantom: std::marker::PhantomData::<F>,
                     _stats: self.stats.clone(),
                     #[cfg(feature = "stats")]
@@ -493,12 +703,17 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         )
         .expect("Error during ASM execution");
 
-        data_buses.sort_by_key(|(chunk_id, _)| chunk_id.0);
+        data_buses.sort_by_key(|(chunk_id, _, _, _)| chunk_id.0);
 
         let mut main_count = Vec::with_capacity(data_buses.len());
         let mut secn_count = HashMap::new();
+        let mut op_bus_streams = Vec::with_capacity(data_buses.len());
+        let mut chunk_checkpoints = Vec::with_capacity(data_buses.len());
+
+        for (chunk_id, data_bus, op_bus_stream, checkpoints) in data_buses {
+            op_bus_streams.push(op_bus_stream);
+            chunk_checkpoints.push(checkpoints);
 
-        for (chunk_id, data_bus) in data_buses {
             let databus_counters = data_bus.into_devices(false);
 
             for (idx, counter) in databus_counters.into_iter() {
@@ -516,6 +731,9 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             }
         }
 
+        self.store_op_bus_streams(op_bus_streams);
+        self.store_chunk_checkpoints(chunk_checkpoints);
+
         #[cfg(feature = "stats")]
         self.stats.add_stat(0, parent_stats_id, "RUN_MT_ASSEMBLY", 0, ExecutorStatsEvent::End);
         (MinimalTraces::AsmEmuTrace(asm_runner_mt), main_count, secn_count)
@@ -600,15 +818,54 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         let metrics_slices: Vec<_> = min_traces
             .par_iter()
             .map(|minimal_trace| {
-                let mut data_bus = self.sm_bundle.build_data_bus_counters();
-
-                ZiskEmulator::process_emu_trace::<F, _, _>(
-                    &self.zisk_rom,
-                    minimal_trace,
-                    &mut data_bus,
-                    true,
+                let mut data_bus = RecordingDataBus::new(
+                    self.sm_bundle.build_data_bus_counters(),
+                    OPERATION_BUS_ID,
+                    self.persist_op_bus_streams,
                 );
 
+                let mut checkpoints = Vec::new();
+                match (&self.replay_rom, self.checkpoint_interval) {
+                    (Some(replay_rom), 0) => {
+                        ZiskEmulator::process_emu_trace_replay::<F, _, _>(
+                            replay_rom,
+                            minimal_trace,
+                            &mut data_bus,
+                            true,
+                        );
+                    }
+                    (Some(replay_rom), checkpoint_interval) => {
+                        ZiskEmulator::process_emu_trace_replay_with_checkpoints::<F, _, _>(
+                            replay_rom,
+                            minimal_trace,
+                            &mut data_bus,
+                            true,
+                            checkpoint_interval,
+                            &mut checkpoints,
+                        );
+                    }
+                    (None, 0) => {
+                        ZiskEmulator::process_emu_trace::<F, _, _>(
+                            &self.zisk_rom,
+                            minimal_trace,
+                            &mut data_bus,
+                            true,
+                        );
+                    }
+                    (None, checkpoint_interval) => {
+                        ZiskEmulator::process_emu_trace_with_checkpoints::<F, _, _>(
+                            &self.zisk_rom,
+                            minimal_trace,
+                            &mut data_bus,
+                            true,
+                            checkpoint_interval,
+                            &mut checkpoints,
+                        );
+                    }
+                }
+
+                let (data_bus, op_bus_stream) = data_bus.into_parts();
+
                 let mut counters = Vec::new();
 
                 let databus_counters = data_bus.into_devices(true);
@@ -616,14 +873,21 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                     counters.push(counter);
                 }
 
-                counters
+                (counters, op_bus_stream, checkpoints)
             })
             .collect();
 
         let mut main_count = Vec::new();
         let mut secn_count = HashMap::new();
+        let mut op_bus_streams = Vec::with_capacity(metrics_slices.len());
+        let mut chunk_checkpoints = Vec::with_capacity(metrics_slices.len());
+
+        for (chunk_id, (counter_slice, op_bus_stream, checkpoints)) in
+            metrics_slices.into_iter().enumerate()
+        {
+            op_bus_streams.push(op_bus_stream);
+            chunk_checkpoints.push(checkpoints);
 
-        for (chunk_id, counter_slice) in metrics_slices.into_iter().enumerate() {
             for (idx, counter) in counter_slice.into_iter() {
                 match idx {
                     None => {
@@ -642,9 +906,41 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             }
         }
 
+        self.store_op_bus_streams(op_bus_streams);
+        self.store_chunk_checkpoints(chunk_checkpoints);
+
         (main_count, secn_count)
     }
 
+    /// Stores the operation bus streams recorded during the count phase, if any.
+    ///
+    /// # Arguments
+    /// * `op_bus_streams` - Recorded stream of each chunk, indexed by chunk ID.
+    fn store_op_bus_streams(&self, op_bus_streams: Vec<Option<OperationBusStream>>) {
+        if !self.persist_op_bus_streams {
+            return;
+        }
+
+        for op_bus_stream in op_bus_streams.iter().flatten() {
+            self.stats
+                .add_op_bus_stream_recorded(op_bus_stream.len(), op_bus_stream.size_in_bytes());
+        }
+
+        *self.op_bus_streams.write().unwrap() = op_bus_streams;
+    }
+
+    /// Stores the emulator checkpoints taken during the count phase, if any.
+    ///
+    /// # Arguments
+    /// * `chunk_checkpoints` - Checkpoints of each chunk, indexed by chunk ID.
+    fn store_chunk_checkpoints(&self, chunk_checkpoints: Vec<Vec<EmuChunkCheckpoint>>) {
+        if self.checkpoint_interval == 0 {
+            return;
+        }
+
+        *self.chunk_checkpoints.write().unwrap() = chunk_checkpoints;
+    }
+
     /// Adds secondary state machine instances to the proof context and assigns global IDs.
     ///
     /// # Arguments
@@ -839,48 +1135,46 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         Ok(())
     }
 
+    /// Returns the order in which the chunks are replayed to collect the secondary instances,
+    /// recording the plan first if `ZISK_CHUNK_SCHEDULE_RECORD` is set.
+    ///
+    /// # Arguments
+    /// * `pctx` - Proof context.
+    /// * `sctx` - Setup context, the collector size of each instance is its number of rows.
+    /// * `min_traces` - Minimal traces, the cost of each chunk is its number of steps.
+    /// * `chunks_to_execute` - Global IDs of the instances fed by each chunk.
+    /// * `global_ids` - Global IDs of the instances to collect.
     fn order_chunks(
         &self,
+        pctx: &ProofCtx<F>,
+        sctx: &SetupCtx<F>,
+        min_traces: &[EmuTrace],
         chunks_to_execute: &[Vec<usize>],
-        global_id_chunks: &HashMap<usize, Vec<usize>>,
+        global_ids: &[usize],
     ) -> Vec<usize> {
-        let mut ordered_chunks = Vec::new();
-        let mut already_selected_chunks = vec![false; chunks_to_execute.len()];
+        let instance_weights = global_ids
+            .iter()
+            .filter_map(|&global_id| {
+                let (airgroup_id, air_id) =
+                    pctx.dctx_get_instance_info(global_id).expect("Failed to get instance info");
+                let setup = sctx.get_setup(airgroup_id, air_id).ok()?;
+                Some((global_id, 1u64 << setup.stark_info.stark_struct.n_bits))
+            })
+            .collect();
 
-        let mut n_global_ids_incompleted = global_id_chunks.len();
-        let mut n_chunks_by_global_id: HashMap<usize, usize> =
-            global_id_chunks.iter().map(|(global_id, chunks)| (*global_id, chunks.len())).collect();
+        let plan = ChunkSchedulePlan::new(
+            chunks_to_execute.to_vec(),
+            min_traces.iter().map(|min_trace| min_trace.steps).collect(),
+        )
+        .with_instance_weights(instance_weights);
 
-        while n_global_ids_incompleted > 0 {
-            let selected_global_id = n_chunks_by_global_id
-                .iter()
-                .filter(|(_, &count)| count > 0)
-                .min_by_key(|(_, &count)| count)
-                .map(|(&global_id, _)| global_id);
-
-            if let Some(global_id) = selected_global_id {
-                for chunk_id in global_id_chunks[&global_id].iter() {
-                    if already_selected_chunks[*chunk_id] {
-                        continue;
-                    }
-                    ordered_chunks.push(*chunk_id);
-                    already_selected_chunks[*chunk_id] = true;
-                    for global_idx in chunks_to_execute[*chunk_id].iter() {
-                        if let Some(count) = n_chunks_by_global_id.get_mut(global_idx) {
-                            *count -= 1;
-                            if *count == 0 {
-                                n_chunks_by_global_id.remove(global_idx);
-                                n_global_ids_incompleted -= 1;
-                            }
-                        }
-                    }
-                }
-            } else {
-                break;
+        if let Some(path) = &self.chunk_schedule_record {
+            if let Err(e) = plan.append_to(path) {
+                tracing::warn!("Failed to record the chunk plan in {}: {}", path.display(), e);
             }
         }
 
-        ordered_chunks
+        self.chunk_scheduler.order(&plan)
     }
 
     /// Expands for a secondary state machines instance.
@@ -894,7 +1188,9 @@ impl<F: PrimeField64> ZiskExecutor<F> {
     fn witness_collect_instances(
         &self,
         pctx: Arc<ProofCtx<F>>,
+        sctx: &SetupCtx<F>,
         secn_instances: HashMap<usize, &Box<dyn Instance<F>>>,
+        ready_tx: Option<mpsc::Sender<usize>>,
     ) {
         let min_traces = self.min_traces.read().unwrap();
 
@@ -908,8 +1204,9 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         let (chunks_to_execute, global_id_chunks) =
             self.chunks_to_execute(min_traces, &secn_instances);
 
-        let ordered_chunks = self.order_chunks(&chunks_to_execute, &global_id_chunks);
         let global_ids: Vec<usize> = secn_instances.keys().copied().collect();
+        let ordered_chunks =
+            self.order_chunks(&pctx, sctx, min_traces, &chunks_to_execute, &global_ids);
 
         let collect_start_times: Vec<Arc<AtomicCell<Option<Instant>>>> =
             global_ids.iter().map(|_| Arc::new(AtomicCell::new(None))).collect();
@@ -961,6 +1258,7 @@ impl<F: PrimeField64> ZiskExecutor<F> {
             let min_traces_lock = Arc::clone(&self.min_traces);
             let data_buses = data_buses.clone();
             let zisk_rom = self.zisk_rom.clone();
+            let replay_rom = self.replay_rom.clone();
             let n_chunks_left = n_chunks_left.clone();
             let global_ids_map = global_ids_map.clone();
             let global_id_chunks = global_id_chunks.clone();
@@ -973,6 +1271,11 @@ impl<F: PrimeField64> ZiskExecutor<F> {
 
             let collect_start_times = collect_start_times.clone();
 
+            let op_bus_streams_lock = Arc::clone(&self.op_bus_streams);
+            let chunk_checkpoints_lock = Arc::clone(&self.chunk_checkpoints);
+
+            let ready_tx = ready_tx.clone();
+
             let _stats = self.stats.clone();
             handles.push(std::thread::spawn(move || {
                 let guard = min_traces_lock.read().unwrap();
@@ -981,6 +1284,8 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                     MinimalTraces::AsmEmuTrace(a) => &a.vec_chunks,
                     _ => unreachable!(),
                 };
+                let op_bus_streams = op_bus_streams_lock.read().unwrap();
+                let chunk_checkpoints = chunk_checkpoints_lock.read().unwrap();
                 loop {
                     let next_chunk_id = next_chunk.fetch_add(1, Ordering::SeqCst);
                     if next_chunk_id >= ordered_chunks_clone.len() {
@@ -996,12 +1301,47 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                             }
                         }
 
-                        ZiskEmulator::process_emu_traces::<F, _, _>(
-                            &zisk_rom,
-                            min_traces,
-                            chunk_id,
-                            &mut data_bus,
-                        );
+                        // Chunks whose collectors only listen to the operation bus are
+                        // collected from the payloads recorded during the count phase
+                        let op_bus_stream = op_bus_streams
+                            .get(chunk_id)
+                            .and_then(|stream| stream.as_ref())
+                            .filter(|_| data_bus.only_operation_bus());
+
+                        let collect_start = Instant::now();
+                        if let Some(op_bus_stream) = op_bus_stream {
+                            op_bus_stream.replay(OPERATION_BUS_ID, &mut data_bus);
+                        } else {
+                            // Collectors that skip their first operations can start from the
+                            // last checkpoint before them, instead of the start of the chunk
+                            let checkpoint = chunk_checkpoints
+                                .get(chunk_id)
+                                .and_then(|checkpoints| data_bus.fast_forward(checkpoints));
+
+                            if let Some(replay_rom) = &replay_rom {
+                                ZiskEmulator::process_emu_traces_replay::<F, _, _>(
+                                    replay_rom,
+                                    min_traces,
+                                    chunk_id,
+                                    checkpoint,
+                                    &mut data_bus,
+                                );
+                            } else {
+                                ZiskEmulator::process_emu_traces_from::<F, _, _>(
+                                    &zisk_rom,
+                                    min_traces,
+                                    chunk_id,
+                                    checkpoint,
+                                    &mut data_bus,
+                                );
+                            }
+                        }
+                        if !op_bus_streams.is_empty() {
+                            _stats.add_op_bus_stream_collected(
+                                op_bus_stream.is_some(),
+                                collect_start.elapsed().as_nanos() as u64,
+                            );
+                        }
 
                         for (global_id, collector) in data_bus.into_devices(false) {
                             if let Some(global_id) = global_id {
@@ -1023,7 +1363,12 @@ impl<F: PrimeField64> ZiskExecutor<F> {
 
                                 if n_chunks_left[*global_id_idx].fetch_sub(1, Ordering::SeqCst) == 1
                                 {
-                                    pctx_clone.set_witness_ready(global_id, true);
+                                    // When streaming, the instance is ready once its witness
+                                    // has been computed, or once the streaming leaves it to
+                                    // calculate_witness
+                                    if ready_tx.is_none() {
+                                        pctx_clone.set_witness_ready(global_id, true);
+                                    }
 
                                     let collect_start_time = collect_start_times[*global_id_idx]
                                         .load()
@@ -1045,6 +1390,12 @@ impl<F: PrimeField64> ZiskExecutor<F> {
                                     };
 
                                     _stats.insert_witness_stats(global_id, stats);
+
+                                    if let Some(ready_tx) = &ready_tx {
+                                        ready_tx
+                                            .send(global_id)
+                                            .expect("Streaming witness receiver dropped");
+                                    }
                                 }
                             }
                         }
@@ -1056,6 +1407,165 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         for handle in handles {
             handle.join().unwrap();
         }
+
+        if self.persist_op_bus_streams {
+            let stats = self.stats.get_op_bus_stream_stats();
+            tracing::info!(
+                "Operation bus streams: {} chunks recorded ({} payloads, {} MB), {} chunks replayed in {} ms, {} chunks emulated in {} ms",
+                stats.recorded_chunks,
+                stats.recorded_payloads,
+                stats.recorded_bytes >> 20,
+                stats.replayed_chunks,
+                stats.replay_duration / 1_000_000,
+                stats.emulated_chunks,
+                stats.emulate_duration / 1_000_000,
+            );
+        }
+    }
+
+    /// Collects the secondary instances and computes the witness of each one as soon as its last
+    /// chunk is collected, while the collection of the rest goes on.
+    ///
+    /// The collection threads send the global ID of each completed instance through an unbounded
+    /// channel, so they never wait for the calling thread. The calling thread takes a trace buffer
+    /// from `buffer_pool` for each completed instance and hands both to the first idle worker.
+    ///
+    /// Buffers taken by the streamed instances aren't released while collecting, so at most
+    /// `streaming_witness_buffers` instances are streamed. The instances completed once they are
+    /// taken, or once the collection has ended and there is nothing left to overlap with, are
+    /// computed in `calculate_witness`.
+    ///
+    /// # Arguments
+    /// * `pctx` - Proof context.
+    /// * `sctx` - Setup context.
+    /// * `secn_instances` - Secondary instances to collect, by global ID.
+    /// * `buffer_pool` - Pool of trace buffers.
+    /// * `install` - Runs a closure inside the thread pool of the witness computation.
+    #[allow(clippy::borrowed_box)]
+    fn collect_and_stream_witness<I>(
+        &self,
+        pctx: &Arc<ProofCtx<F>>,
+        sctx: &SetupCtx<F>,
+        secn_instances: HashMap<usize, &Box<dyn Instance<F>>>,
+        buffer_pool: &dyn BufferPool<F>,
+        install: I,
+    ) -> ProofmanResult<()>
+    where
+        I: for<'a> Fn(Box<dyn FnOnce() + Send + 'a>) + Sync,
+    {
+        let n_workers = self.streaming_witness_workers;
+        let instances = secn_instances.clone();
+
+        let start = Instant::now();
+        let collect_end = Mutex::new(start);
+        let witness_intervals = Mutex::new(Vec::with_capacity(instances.len()));
+        let result = Mutex::new(Ok(()));
+
+        let (ready_tx, ready_rx) = mpsc::channel::<usize>();
+        let collect_done = AtomicBool::new(false);
+        let (job_tx, job_rx) = mpsc::sync_channel::<(usize, Vec<F>)>(0);
+        let job_rx = Mutex::new(job_rx);
+
+        std::thread::scope(|scope| {
+            let (install, collect_end, collect_done) = (&install, &collect_end, &collect_done);
+            scope.spawn(move || {
+                install(Box::new(move || {
+                    self.witness_collect_instances(
+                        pctx.clone(),
+                        sctx,
+                        secn_instances,
+                        Some(ready_tx),
+                    )
+                }));
+                *collect_end.lock().unwrap() = Instant::now();
+                collect_done.store(true, Ordering::Release);
+            });
+
+            for _ in 0..n_workers {
+                scope.spawn(|| loop {
+                    // Release the receiver before computing, so other workers can take jobs
+                    let job = job_rx.lock().unwrap().recv();
+                    let Ok((global_id, trace_buffer)) = job else {
+                        break;
+                    };
+
+                    let witness_start = Instant::now();
+                    let mut witness_result = Ok(());
+                    install(Box::new(|| {
+                        witness_result = self.witness_secn_instance(
+                            pctx,
+                            sctx,
+                            global_id,
+                            &**instances[&global_id],
+                            trace_buffer,
+                            0,
+                        );
+                    }));
+                    witness_intervals.lock().unwrap().push((witness_start, Instant::now()));
+
+                    match witness_result {
+                        Ok(()) => {
+                            self.streamed_witnesses.lock().unwrap().insert(global_id);
+                            pctx.set_witness_ready(global_id, true);
+                        }
+                        Err(e) => {
+                            // Keep the first error, returned once the collection ends
+                            let mut result = result.lock().unwrap();
+                            if result.is_ok() {
+                                *result = Err(e);
+                            }
+                        }
+                    }
+                });
+            }
+
+            // Ends when every collection thread has dropped its sender
+            let mut buffers = self.streaming_witness_buffers;
+            for global_id in ready_rx {
+                if buffers == 0 || collect_done.load(Ordering::Acquire) {
+                    pctx.set_witness_ready(global_id, true);
+                    continue;
+                }
+                buffers -= 1;
+                let wait_start = Instant::now();
+                let trace_buffer = buffer_pool.take_buffer();
+                self.stats
+                    .add_streaming_witness_buffer_wait(wait_start.elapsed().as_nanos() as u64);
+                job_tx.send((global_id, trace_buffer)).expect("Streaming witness workers stopped");
+            }
+            drop(job_tx);
+        });
+
+        let collect_end = collect_end.into_inner().unwrap();
+        let witness_intervals = witness_intervals.into_inner().unwrap();
+        self.stats.add_streaming_witness(
+            witness_intervals.len() as u64,
+            (instances.len() - witness_intervals.len()) as u64,
+            collect_end.duration_since(start).as_nanos() as u64,
+            witness_intervals
+                .iter()
+                .map(|(from, to)| to.duration_since(*from).as_nanos() as u64)
+                .sum(),
+            witness_intervals
+                .iter()
+                .map(|(from, to)| {
+                    (*to).min(collect_end).saturating_duration_since(*from).as_nanos() as u64
+                })
+                .sum(),
+        );
+
+        let stats = self.stats.get_streaming_witness_stats();
+        tracing::info!(
+            "Streaming witness: {} instances computed in {} ms, {} ms overlapped with a collection of {} ms, {} ms waiting for trace buffers, {} instances left to calculate_witness",
+            stats.streamed_instances,
+            stats.witness_duration / 1_000_000,
+            stats.overlap_duration / 1_000_000,
+            stats.collect_duration / 1_000_000,
+            stats.buffer_wait_duration / 1_000_000,
+            stats.unstreamed_instances,
+        );
+
+        result.into_inner().unwrap()
     }
 
     /// Computes and generates witness for secondary state machine instance of type `Table`.
@@ -1158,6 +1668,9 @@ impl<F: PrimeField64> ZiskExecutor<F> {
         self.main_instances.write().unwrap().clear();
         self.secn_instances.write().unwrap().clear();
         self.collectors_by_instance.write().unwrap().clear();
+        self.op_bus_streams.write().unwrap().clear();
+        self.chunk_checkpoints.write().unwrap().clear();
+        self.streamed_witnesses.lock().unwrap().clear();
         self.stats.reset();
     }
 }
@@ -1423,6 +1936,10 @@ impl<F: PrimeField64> WitnessComponent<F> for ZiskExecutor<F> {
 
                     match secn_instance.instance_type() {
                         InstanceType::Instance => {
+                            // Already computed while it was collected
+                            if self.streamed_witnesses.lock().unwrap().remove(&global_id) {
+                                continue;
+                            }
                             if !self.collectors_by_instance.read().unwrap().contains_key(&global_id)
                             {
                                 if air_id == ROM_AIR_IDS[0] && self.asm_runner_path.is_some() {
@@ -1444,7 +1961,12 @@ impl<F: PrimeField64> WitnessComponent<F> for ZiskExecutor<F> {
                                 } else {
                                     let mut secn_instances = HashMap::new();
                                     secn_instances.insert(global_id, secn_instance);
-                                    self.witness_collect_instances(pctx.clone(), secn_instances);
+                                    self.witness_collect_instances(
+                                        pctx.clone(),
+                                        &sctx,
+                                        secn_instances,
+                                        None,
+                                    );
                                 }
                             }
                             self.witness_secn_instance(
@@ -1487,10 +2009,10 @@ impl<F: PrimeField64> WitnessComponent<F> for ZiskExecutor<F> {
         &self,
         stage: u32,
         pctx: Arc<ProofCtx<F>>,
-        _sctx: Arc<SetupCtx<F>>,
+        sctx: Arc<SetupCtx<F>>,
         global_ids: &[usize],
         n_cores: usize,
-        _buffer_pool: &dyn BufferPool<F>,
+        buffer_pool: &dyn BufferPool<F>,
     ) -> ProofmanResult<()> {
         #[cfg(feature = "stats")]
         let parent_stats_id = self.stats.next_id();
@@ -1553,11 +2075,17 @@ impl<F: PrimeField64> WitnessComponent<F> for ZiskExecutor<F> {
         }
 
         let pool = create_pool(n_cores);
-        pool.install(|| {
-            if !secn_instances.is_empty() {
-                self.witness_collect_instances(pctx.clone(), secn_instances);
+        if !secn_instances.is_empty() {
+            if self.streaming_witness_workers > 0 {
+                self.collect_and_stream_witness(&pctx, &sctx, secn_instances, buffer_pool, |f| {
+                    pool.install(f)
+                })?;
+            } else {
+                pool.install(|| {
+                    self.witness_collect_instances(pctx.clone(), &sctx, secn_instances, None)
+                });
             }
-        });
+        }
 
         // Add to executor stats
         #[cfg(feature = "stats")]
@@ -1,11 +1,17 @@
+mod chunk_scheduler;
 mod dummy_counter;
 mod executor;
+mod mem_collector_index;
+mod operation_bus_stream;
 mod sm_static_bundle;
 mod static_data_bus;
 mod static_data_bus_collect;
 
+pub use chunk_scheduler::*;
 pub use dummy_counter::*;
 pub use executor::*;
+pub use mem_collector_index::*;
+pub use operation_bus_stream::*;
 pub use sm_static_bundle::*;
 pub use static_data_bus::*;
 pub use static_data_bus_collect::*;
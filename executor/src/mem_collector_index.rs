@@ -0,0 +1,112 @@
+//! The `MemCollectorIndex` module routes the memory bus data of a chunk to the memory collectors
+//! that own the accessed address, instead of offering every access to every collector.
+//!
+//! The address ranges of the collectors, taken from their checkpoints, are split into sorted
+//! non-overlapping intervals, each one with the list of collectors whose range covers it.
+//! Consecutive segments of the same memory area can share the boundary address, so an interval
+//! can have more than one collector.
+//!
+//! With a chunk of one or two collectors the binary search costs more than letting each
+//! collector filter the address, so those chunks offer every access to every collector.
+
+use zisk_common::MemCollectorInfo;
+
+/// Up to this number of collectors, every access is offered to every collector.
+const LINEAR_DISPATCH_MAX: usize = 2;
+
+/// Address-interval index of the memory collectors of a chunk.
+#[derive(Debug, Default)]
+pub struct MemCollectorIndex {
+    /// First address of each interval, sorted. The last interval ends at the last address of
+    /// the last collector, so it has no collectors.
+    starts: Vec<u64>,
+
+    /// Collectors of interval `i` are `collectors[offsets[i]..offsets[i + 1]]`.
+    offsets: Vec<u32>,
+
+    /// Indexes of the collectors of each interval, one interval after the other.
+    collectors: Vec<u32>,
+
+    /// Number of collectors, when it's at most `LINEAR_DISPATCH_MAX` the intervals are unused.
+    n_collectors: usize,
+}
+
+impl MemCollectorIndex {
+    /// Creates a new `MemCollectorIndex`.
+    ///
+    /// # Arguments
+    /// * `infos` - Address range of each collector, the index of each collector in the index is
+    ///   its position in this slice.
+    pub fn new(infos: &[MemCollectorInfo]) -> Self {
+        let mut starts: Vec<u64> = infos
+            .iter()
+            .flat_map(|info| [info.from_addr as u64, info.to_addr as u64 + 1])
+            .collect();
+        starts.sort_unstable();
+        starts.dedup();
+
+        let mut offsets = Vec::with_capacity(starts.len() + 1);
+        let mut collectors = Vec::new();
+        offsets.push(0);
+        for &start in &starts {
+            for (idx, info) in infos.iter().enumerate() {
+                if info.from_addr as u64 <= start && start <= info.to_addr as u64 {
+                    collectors.push(idx as u32);
+                }
+            }
+            offsets.push(collectors.len() as u32);
+        }
+
+        Self { starts, offsets, collectors, n_collectors: infos.len() }
+    }
+
+    /// Returns the interval that contains `addr`, 0 if `addr` is before the first interval.
+    #[inline(always)]
+    fn interval(&self, addr: u64) -> usize {
+        self.starts.partition_point(|&start| start <= addr)
+    }
+
+    /// Returns the collectors of an interval returned by `interval`.
+    #[inline(always)]
+    fn interval_collectors(&self, interval: usize) -> &[u32] {
+        if interval == 0 {
+            return &[];
+        }
+        &self.collectors[self.offsets[interval - 1] as usize..self.offsets[interval] as usize]
+    }
+
+    /// Calls `f` once with the index of every collector whose range overlaps the access of
+    /// `bytes` bytes at `addr`. Collector ranges are whole 8-byte words, so every interval is at
+    /// least 8 bytes and an access, at most 8 bytes, can only touch two consecutive intervals.
+    /// With up to `LINEAR_DISPATCH_MAX` collectors `f` is called with all of them.
+    ///
+    /// # Arguments
+    /// * `addr` - First address of the access.
+    /// * `bytes` - Width of the access, in bytes.
+    /// * `f` - Function called with each collector index.
+    #[inline(always)]
+    pub fn for_each_collector(&self, addr: u32, bytes: u8, mut f: impl FnMut(usize)) {
+        if self.n_collectors <= LINEAR_DISPATCH_MAX {
+            (0..self.n_collectors).for_each(f);
+            return;
+        }
+
+        let first_interval = self.interval(addr as u64);
+        let first = self.interval_collectors(first_interval);
+        for &idx in first {
+            f(idx as usize);
+        }
+
+        // Interval `first_interval` ends where the next start begins, an access that ends before
+        // it doesn't need a second search
+        let last_addr = addr as u64 + bytes as u64 - 1;
+        if bytes > 1 && self.starts.get(first_interval).is_some_and(|&next| last_addr >= next) {
+            let last_interval = self.interval(last_addr);
+            for &idx in self.interval_collectors(last_interval) {
+                if !first.contains(&idx) {
+                    f(idx as usize);
+                }
+            }
+        }
+    }
+}
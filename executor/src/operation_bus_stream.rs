@@ -0,0 +1,212 @@
+//! The `OperationBusStream` module records the operation bus payloads emitted while a chunk is
+//! replayed during the count phase, so the secondary instances that only listen to the operation
+//! bus can be collected later without emulating the chunk again.
+//!
+//! Payloads are stored by columns, one set of columns for each operation type, plus a tag per
+//! record with its operation type. The tags keep the original order of the payloads, which the
+//! collectors need: the inputs generators derive operations of other types (e.g. arith emits
+//! binary operations) and the collectors skip and take operations by their position.
+
+use data_bus::DataBusTrait;
+use zisk_common::{
+    BusId, PayloadType, A, B, MAX_OPERATION_DATA_SIZE, OP, OPERATION_BUS_DATA_SIZE, OP_TYPE,
+};
+use zisk_core::ZiskOperationType;
+
+/// Number of operation types that can be written to the operation bus.
+const NUM_OP_TYPES: usize = ZiskOperationType::FcallParam as usize;
+
+/// Columns of the payloads of a single operation type.
+#[derive(Default)]
+struct OperationBusColumns {
+    /// Operation of each payload, the operation type is implicit.
+    op: Vec<u8>,
+
+    /// First operand of each payload.
+    a: Vec<u64>,
+
+    /// Second operand of each payload.
+    b: Vec<u64>,
+
+    /// Number of extended values of each payload, only for precompiled operations.
+    ext_len: Vec<u8>,
+
+    /// Extended values of all the payloads, one after the other.
+    ext: Vec<u64>,
+}
+
+/// Operation bus payloads of a chunk, in the order they were written.
+pub struct OperationBusStream {
+    /// Operation type of each payload.
+    op_types: Vec<u8>,
+
+    /// Columns of the payloads, indexed by operation type.
+    columns: Vec<OperationBusColumns>,
+}
+
+impl Default for OperationBusStream {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl OperationBusStream {
+    /// Creates a new empty `OperationBusStream`.
+    pub fn new() -> Self {
+        Self {
+            op_types: Vec::new(),
+            columns: (0..NUM_OP_TYPES).map(|_| OperationBusColumns::default()).collect(),
+        }
+    }
+
+    /// Appends an operation bus payload to the stream.
+    ///
+    /// # Arguments
+    /// * `payload` - The payload, with the operation, operation type, a, b and the extended data.
+    #[inline(always)]
+    pub fn push(&mut self, payload: &[PayloadType]) {
+        let op_type = payload[OP_TYPE] as usize;
+        debug_assert!(op_type < NUM_OP_TYPES);
+        debug_assert!(payload.len() <= MAX_OPERATION_DATA_SIZE);
+
+        let columns = &mut self.columns[op_type];
+        columns.op.push(payload[OP] as u8);
+        columns.a.push(payload[A]);
+        columns.b.push(payload[B]);
+
+        // Only precompiled operations have extended data, don't store lengths for the rest
+        let ext = &payload[OPERATION_BUS_DATA_SIZE..];
+        if !ext.is_empty() || !columns.ext_len.is_empty() {
+            columns.ext_len.resize(columns.op.len() - 1, 0);
+            columns.ext_len.push(ext.len() as u8);
+            columns.ext.extend_from_slice(ext);
+        }
+
+        self.op_types.push(op_type as u8);
+    }
+
+    /// Writes all the payloads of the stream to the operation bus of `data_bus`, in the same
+    /// order they were recorded.
+    ///
+    /// # Arguments
+    /// * `bus_id` - The ID of the operation bus.
+    /// * `data_bus` - The data bus receiving the payloads.
+    pub fn replay<T, DB: DataBusTrait<PayloadType, T>>(&self, bus_id: BusId, data_bus: &mut DB) {
+        let mut payload = [0u64; MAX_OPERATION_DATA_SIZE];
+        let mut index = [0usize; NUM_OP_TYPES];
+        let mut ext_index = [0usize; NUM_OP_TYPES];
+
+        for &op_type in &self.op_types {
+            let op_type = op_type as usize;
+            let columns = &self.columns[op_type];
+            let i = index[op_type];
+            index[op_type] += 1;
+
+            payload[OP] = columns.op[i] as u64;
+            payload[OP_TYPE] = op_type as u64;
+            payload[A] = columns.a[i];
+            payload[B] = columns.b[i];
+
+            let ext_len = columns.ext_len.get(i).map_or(0, |&len| len as usize);
+            let len = OPERATION_BUS_DATA_SIZE + ext_len;
+            if ext_len > 0 {
+                let ext_start = ext_index[op_type];
+                payload[OPERATION_BUS_DATA_SIZE..len]
+                    .copy_from_slice(&columns.ext[ext_start..ext_start + ext_len]);
+                ext_index[op_type] += ext_len;
+            }
+
+            data_bus.write_to_bus(bus_id, &payload[..len]);
+        }
+    }
+
+    /// Returns the number of payloads in the stream.
+    pub fn len(&self) -> usize {
+        self.op_types.len()
+    }
+
+    /// Returns `true` if the stream has no payloads.
+    pub fn is_empty(&self) -> bool {
+        self.op_types.is_empty()
+    }
+
+    /// Returns the memory used by the stream, in bytes.
+    pub fn size_in_bytes(&self) -> usize {
+        self.op_types.capacity()
+            + self
+                .columns
+                .iter()
+                .map(|c| {
+                    c.op.capacity()
+                        + (c.a.capacity() + c.b.capacity() + c.ext.capacity()) * 8
+                        + c.ext_len.capacity()
+                })
+                .sum::<usize>()
+    }
+
+    /// Releases the memory not used by the stream.
+    pub fn shrink_to_fit(&mut self) {
+        self.op_types.shrink_to_fit();
+        for columns in &mut self.columns {
+            columns.op.shrink_to_fit();
+            columns.a.shrink_to_fit();
+            columns.b.shrink_to_fit();
+            columns.ext_len.shrink_to_fit();
+            columns.ext.shrink_to_fit();
+        }
+    }
+}
+
+/// Data bus wrapper that forwards everything to `inner` and records the operation bus payloads
+/// in an `OperationBusStream` when recording is enabled.
+pub struct RecordingDataBus<DB> {
+    /// The wrapped data bus.
+    inner: DB,
+
+    /// Bus ID of the recorded payloads.
+    bus_id: BusId,
+
+    /// The recorded stream, `None` when recording is disabled.
+    stream: Option<OperationBusStream>,
+}
+
+impl<DB> RecordingDataBus<DB> {
+    /// Creates a new `RecordingDataBus`.
+    ///
+    /// # Arguments
+    /// * `inner` - The wrapped data bus.
+    /// * `bus_id` - The ID of the operation bus.
+    /// * `record` - Whether the operation bus payloads must be recorded.
+    pub fn new(inner: DB, bus_id: BusId, record: bool) -> Self {
+        Self { inner, bus_id, stream: record.then(OperationBusStream::new) }
+    }
+
+    /// Returns the wrapped data bus and the recorded stream, if any.
+    pub fn into_parts(self) -> (DB, Option<OperationBusStream>) {
+        let stream = self.stream.map(|mut stream| {
+            stream.shrink_to_fit();
+            stream
+        });
+        (self.inner, stream)
+    }
+}
+
+impl<T, DB: DataBusTrait<PayloadType, T>> DataBusTrait<PayloadType, T> for RecordingDataBus<DB> {
+    #[inline(always)]
+    fn write_to_bus(&mut self, bus_id: BusId, payload: &[PayloadType]) -> bool {
+        if bus_id == self.bus_id {
+            if let Some(stream) = self.stream.as_mut() {
+                stream.push(payload);
+            }
+        }
+        self.inner.write_to_bus(bus_id, payload)
+    }
+
+    fn on_close(&mut self) {
+        self.inner.on_close();
+    }
+
+    fn into_devices(self, execute_on_close: bool) -> Vec<(Option<usize>, Option<T>)> {
+        self.inner.into_devices(execute_on_close)
+    }
+}
@@ -4,6 +4,7 @@
 //! send data, route it to the appropriate subscribers, and manage device connections.
 use std::collections::VecDeque;
 
+use crate::MemCollectorIndex;
 use data_bus::DataBusTrait;
 use precomp_arith_eq::ArithEqCollector;
 use precomp_arith_eq::ArithEqCounterInputGen;
@@ -21,8 +22,8 @@ use sm_binary::{BinaryAddCollector, BinaryBasicCollector, BinaryExtensionCollect
 use sm_mem::{MemAlignCollector, MemModuleCollector};
 use sm_rom::RomCollector;
 use zisk_common::{
-    BusDevice, BusId, MemCollectorInfo, PayloadType, MEM_BUS_ID, OPERATION_BUS_ID, OP_TYPE,
-    ROM_BUS_ID,
+    BusDevice, BusId, EmuChunkCheckpoint, MemBusData, MemCollectorInfo, PayloadType, MEM_BUS_ID,
+    OPERATION_BUS_ID, OP_TYPE, ROM_BUS_ID,
 };
 use zisk_core::ZiskOperationType;
 
@@ -74,6 +75,10 @@ pub struct StaticDataBusCollect<D> {
     pending_transfers: VecDeque<(BusId, Vec<D>)>,
 
     mem_collectors_info: Vec<MemCollectorInfo>,
+
+    /// Address-interval index of `mem_collector`, to route each memory access only to the
+    /// collectors that own its address.
+    mem_collector_index: MemCollectorIndex,
 }
 
 const BINARY_TYPE: u64 = ZiskOperationType::Binary as u64;
@@ -110,6 +115,7 @@ impl StaticDataBusCollect<PayloadType> {
     ) -> Self {
         let mem_collectors_info: Vec<MemCollectorInfo> =
             mem_collector.iter().map(|(_, collector)| collector.get_mem_collector_info()).collect();
+        let mem_collector_index = MemCollectorIndex::new(&mem_collectors_info);
 
         Self {
             mem_collector,
@@ -132,9 +138,76 @@ impl StaticDataBusCollect<PayloadType> {
             add256_inputs_generator,
             pending_transfers: VecDeque::with_capacity(64),
             mem_collectors_info,
+            mem_collector_index,
         }
     }
 
+    /// Returns `true` if none of the collectors listens to the memory or the ROM buses, so all
+    /// their inputs can be derived from the operation bus payloads of the chunk.
+    pub fn only_operation_bus(&self) -> bool {
+        self.mem_collector.is_empty()
+            && self.mem_align_collector.is_empty()
+            && self.rom_collector.is_empty()
+    }
+
+    /// Selects the last checkpoint of the chunk that is before the first operation needed by
+    /// every collector, and marks the operations before it as already skipped.
+    ///
+    /// Only the precompiled collectors skip by counting the operations of their own type, the
+    /// rest need the chunk from its start, so in that case no checkpoint is selected.
+    ///
+    /// # Arguments
+    /// * `checkpoints` - Checkpoints of the chunk taken during the count phase, in step order.
+    ///
+    /// # Returns
+    /// The checkpoint the chunk emulation must resume from, `None` to start from the beginning.
+    pub fn fast_forward<'a>(
+        &mut self,
+        checkpoints: &'a [EmuChunkCheckpoint],
+    ) -> Option<&'a EmuChunkCheckpoint> {
+        if !self.only_operation_bus()
+            || !self.binary_basic_collector.is_empty()
+            || !self.binary_add_collector.is_empty()
+            || !self.binary_extension_collector.is_empty()
+            || !self.arith_collector.is_empty()
+        {
+            return None;
+        }
+
+        // Types without collectors don't limit the checkpoint
+        let keccakf = self.keccakf_collector.iter().map(|(_, c)| c.pending_skip()).min();
+        let sha256f = self.sha256f_collector.iter().map(|(_, c)| c.pending_skip()).min();
+        let arith_eq = self.arith_eq_collector.iter().map(|(_, c)| c.pending_skip()).min();
+        let arith_eq_384 = self.arith_eq_384_collector.iter().map(|(_, c)| c.pending_skip()).min();
+        let add256 = self.add256_collector.iter().map(|(_, c)| c.pending_skip()).min();
+
+        let checkpoint = checkpoints.iter().rev().find(|cp| {
+            cp.op_counts[KECCAK_TYPE as usize] <= keccakf.unwrap_or(u64::MAX)
+                && cp.op_counts[SHA256_TYPE as usize] <= sha256f.unwrap_or(u64::MAX)
+                && cp.op_counts[ARITH_EQ_TYPE as usize] <= arith_eq.unwrap_or(u64::MAX)
+                && cp.op_counts[ARITH_EQ_384_TYPE as usize] <= arith_eq_384.unwrap_or(u64::MAX)
+                && cp.op_counts[BIG_INT_OP_TYPE_ID as usize] <= add256.unwrap_or(u64::MAX)
+        })?;
+
+        for (_, collector) in &mut self.keccakf_collector {
+            collector.fast_forward(checkpoint.op_counts[KECCAK_TYPE as usize]);
+        }
+        for (_, collector) in &mut self.sha256f_collector {
+            collector.fast_forward(checkpoint.op_counts[SHA256_TYPE as usize]);
+        }
+        for (_, collector) in &mut self.arith_eq_collector {
+            collector.fast_forward(checkpoint.op_counts[ARITH_EQ_TYPE as usize]);
+        }
+        for (_, collector) in &mut self.arith_eq_384_collector {
+            collector.fast_forward(checkpoint.op_counts[ARITH_EQ_384_TYPE as usize]);
+        }
+        for (_, collector) in &mut self.add256_collector {
+            collector.fast_forward(checkpoint.op_counts[BIG_INT_OP_TYPE_ID as usize]);
+        }
+
+        Some(checkpoint)
+    }
+
     /// Routes data to the devices subscribed to a specific bus ID or global devices.
     ///
     /// # Arguments
@@ -149,10 +222,21 @@ impl StaticDataBusCollect<PayloadType> {
     fn route_data(&mut self, bus_id: BusId, payload: &[PayloadType]) {
         match bus_id {
             MEM_BUS_ID => {
-                // Process mem collectors - inverted condition to avoid continue
-                for (_, mem_collector) in &mut self.mem_collector {
-                    mem_collector.process_data(&bus_id, payload, &mut self.pending_transfers, None);
-                }
+                // Process only the mem collectors that own the address
+                let mem_collector = &mut self.mem_collector;
+                let pending_transfers = &mut self.pending_transfers;
+                self.mem_collector_index.for_each_collector(
+                    MemBusData::get_addr(payload),
+                    MemBusData::get_bytes(payload),
+                    |idx| {
+                        mem_collector[idx].1.process_data(
+                            &bus_id,
+                            payload,
+                            pending_transfers,
+                            None,
+                        );
+                    },
+                );
 
                 // Only process align collectors if needed
                 for (_, mem_align_collector) in &mut self.mem_align_collector {
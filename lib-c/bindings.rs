@@ -27,6 +27,88 @@ extern "C" {
     ) -> ::std::os::raw::c_int;
 }
 
+extern "C" {
+    pub fn AddPointEcBatchP(
+        _dbl: ::std::os::raw::c_ulong,
+        _n: ::std::os::raw::c_ulong,
+        _p1: *const ::std::os::raw::c_ulong,
+        _p2: *const ::std::os::raw::c_ulong,
+        _p3: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BN254CurveAddBatchP(
+        _n: ::std::os::raw::c_ulong,
+        _p1: *const ::std::os::raw::c_ulong,
+        _p2: *const ::std::os::raw::c_ulong,
+        _p3: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BN254CurveDblBatchP(
+        _n: ::std::os::raw::c_ulong,
+        _p1: *const ::std::os::raw::c_ulong,
+        _p2: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BLS12_381CurveAddBatchP(
+        _n: ::std::os::raw::c_ulong,
+        _p1: *const ::std::os::raw::c_ulong,
+        _p2: *const ::std::os::raw::c_ulong,
+        _p3: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BLS12_381CurveDblBatchP(
+        _n: ::std::os::raw::c_ulong,
+        _p1: *const ::std::os::raw::c_ulong,
+        _p2: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+pub const FIELD_BATCH_ADD: u64 = 0;
+pub const FIELD_BATCH_MUL: u64 = 1;
+pub const FIELD_BATCH_SQUARE: u64 = 2;
+
+extern "C" {
+    pub fn FieldBatchIfmaSupported() -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn Secp256k1FpBatch(
+        _op: ::std::os::raw::c_ulong,
+        _n: ::std::os::raw::c_ulong,
+        _a: *const ::std::os::raw::c_ulong,
+        _b: *const ::std::os::raw::c_ulong,
+        _r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BN254FpBatch(
+        _op: ::std::os::raw::c_ulong,
+        _n: ::std::os::raw::c_ulong,
+        _a: *const ::std::os::raw::c_ulong,
+        _b: *const ::std::os::raw::c_ulong,
+        _r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn BLS12_381FpBatch(
+        _op: ::std::os::raw::c_ulong,
+        _n: ::std::os::raw::c_ulong,
+        _a: *const ::std::os::raw::c_ulong,
+        _b: *const ::std::os::raw::c_ulong,
+        _r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
 extern "C" {
     pub fn InverseFpEc(
         a: *const ::std::os::raw::c_ulong,
@@ -49,6 +131,28 @@ extern "C" {
     ) -> ::std::os::raw::c_int;
 }
 
+extern "C" {
+    pub fn Secp256r1FpInv(
+        a: *const ::std::os::raw::c_ulong,
+        r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn Secp256r1FnInv(
+        a: *const ::std::os::raw::c_ulong,
+        r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
+extern "C" {
+    pub fn Secp256r1FpSqrt(
+        a: *const ::std::os::raw::c_ulong,
+        parity: ::std::os::raw::c_ulong,
+        r: *mut ::std::os::raw::c_ulong,
+    ) -> ::std::os::raw::c_int;
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct FcallContext {
@@ -1,5 +1,6 @@
 #include "arith256.hpp"
 #include "../common/utils.hpp"
+#include "../bigint/limbs.hpp"
 
 int Arith256 (
     const uint64_t * _a,  // 4 x 64 bits
@@ -38,6 +39,20 @@ int Arith256Mod (
     const uint64_t * _module, // 4 x 64 bits
           uint64_t * _d       // 4 x 64 bits
 )
+{
+    // Calculate (a * b) + c as 8 x 64 bits, and reduce it by module
+    uint64_t r[8];
+    mul_add_limbs<4>(_a, _b, _c, r);
+    return mod_limbs<4>(r, _module, _d);
+}
+
+int Arith256ModGmp (
+    const uint64_t * _a,      // 4 x 64 bits
+    const uint64_t * _b,      // 4 x 64 bits
+    const uint64_t * _c,      // 4 x 64 bits
+    const uint64_t * _module, // 4 x 64 bits
+          uint64_t * _d       // 4 x 64 bits
+)
 {
     // Convert input parameters to scalars
     mpz_class a, b, c, module;
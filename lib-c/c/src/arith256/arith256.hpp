@@ -14,7 +14,7 @@ int Arith256 (
     unsigned long * dh // 4 x 64 bits
 );
 
-// Computes d = ((a * b) + c) % module
+// Computes d = ((a * b) + c) % module, returns -1 if module is zero
 int Arith256Mod (
     const unsigned long * a,  // 4 x 64 bits
     const unsigned long * b,  // 4 x 64 bits
@@ -23,6 +23,15 @@ int Arith256Mod (
     unsigned long * d // 4 x 64 bits
 );
 
+// Same as Arith256Mod using GMP, reference implementation for tests
+int Arith256ModGmp (
+    const unsigned long * a,  // 4 x 64 bits
+    const unsigned long * b,  // 4 x 64 bits
+    const unsigned long * c,  // 4 x 64 bits
+    const unsigned long * module,  // 4 x 64 bits
+    unsigned long * d // 4 x 64 bits
+);
+
 int FastArith256(
     const unsigned long * _a,  // 4 x 64 bits (input: a)
     const unsigned long * _b,  // 4 x 64 bits (input: b)  
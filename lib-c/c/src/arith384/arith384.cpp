@@ -1,5 +1,6 @@
 #include "arith384.hpp"
 #include "../common/utils.hpp"
+#include "../bigint/limbs.hpp"
 
 int Arith384 (
     const uint64_t * _a,  // 6 x 64 bits
@@ -8,6 +9,40 @@ int Arith384 (
           uint64_t * _dl, // 6 x 64 bits
           uint64_t * _dh  // 6 x 64 bits
 )
+{
+    // Calculate (a * b) + c as 12 x 64 bits, and decompose it as d = dl + dh<<384
+    uint64_t r[12];
+    mul_add_limbs<6>(_a, _b, _c, r);
+    for (int i = 0; i < 6; i++)
+    {
+        _dl[i] = r[i];
+        _dh[i] = r[i + 6];
+    }
+
+    return 0;
+}
+
+int Arith384Mod (
+    const uint64_t * _a,      // 6 x 64 bits
+    const uint64_t * _b,      // 6 x 64 bits
+    const uint64_t * _c,      // 6 x 64 bits
+    const uint64_t * _module, // 6 x 64 bits
+          uint64_t * _d       // 6 x 64 bits
+)
+{
+    // Calculate (a * b) + c as 12 x 64 bits, and reduce it by module
+    uint64_t r[12];
+    mul_add_limbs<6>(_a, _b, _c, r);
+    return mod_limbs<6>(r, _module, _d);
+}
+
+int Arith384Gmp (
+    const uint64_t * _a,  // 6 x 64 bits
+    const uint64_t * _b,  // 6 x 64 bits
+    const uint64_t * _c,  // 6 x 64 bits
+          uint64_t * _dl, // 6 x 64 bits
+          uint64_t * _dh  // 6 x 64 bits
+)
 {
     // Convert input parameters to scalars
     mpz_class a, b, c;
@@ -19,7 +54,7 @@ int Arith384 (
     mpz_class d;
     d = (a * b) + c;
 
-    // Decompose d = dl + dh<<256 (dh = d)
+    // Decompose d = dl + dh<<384 (dh = d)
     mpz_class dl;
     dl = d & ScalarMask384;
     d >>= 384;
@@ -31,7 +66,7 @@ int Arith384 (
     return 0;
 }
 
-int Arith384Mod (
+int Arith384ModGmp (
     const uint64_t * _a,      // 6 x 64 bits
     const uint64_t * _b,      // 6 x 64 bits
     const uint64_t * _c,      // 6 x 64 bits
@@ -54,4 +89,4 @@ int Arith384Mod (
     scalar2array6(d, _d);
 
     return 0;
-}
\ No newline at end of file
+}
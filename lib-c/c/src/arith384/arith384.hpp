@@ -14,7 +14,7 @@ int Arith384 (
     unsigned long * dh // 6 x 64 bits
 );
 
-// Computes d = ((a * b) + c) % module
+// Computes d = ((a * b) + c) % module, returns -1 if module is zero
 int Arith384Mod (
     const unsigned long * a,  // 6 x 64 bits
     const unsigned long * b,  // 6 x 64 bits
@@ -23,6 +23,23 @@ int Arith384Mod (
     unsigned long * d // 6 x 64 bits
 );
 
+// Same as Arith384 and Arith384Mod using GMP, reference implementations for tests
+int Arith384Gmp (
+    const unsigned long * a,  // 6 x 64 bits
+    const unsigned long * b,  // 6 x 64 bits
+    const unsigned long * c,  // 6 x 64 bits
+    unsigned long * dl, // 6 x 64 bits
+    unsigned long * dh // 6 x 64 bits
+);
+
+int Arith384ModGmp (
+    const unsigned long * a,  // 6 x 64 bits
+    const unsigned long * b,  // 6 x 64 bits
+    const unsigned long * c,  // 6 x 64 bits
+    const unsigned long * module,  // 6 x 64 bits
+    unsigned long * d // 6 x 64 bits
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,165 @@
+#ifndef LIMBS_HPP
+#define LIMBS_HPP
+
+#include <stdint.h>
+
+// Fixed-size arithmetic over arrays of N u64 limbs LE, without heap allocations
+
+typedef unsigned __int128 uint128_t;
+
+// Computes (hi:lo) / d with a single divq, returning the quotient and the remainder on rem.
+// Requires hi < d, otherwise the quotient doesn't fit in 64 bits
+inline uint64_t div_128_64 (uint64_t hi, uint64_t lo, uint64_t d, uint64_t &rem)
+{
+    uint64_t q;
+    asm ("divq %4" : "=a" (q), "=d" (rem) : "a" (lo), "d" (hi), "rm" (d) : "cc");
+    return q;
+}
+
+// Computes r = (a * b) + c, where a, b, c have N limbs and r has 2N limbs. The result
+// always fits because (2^k - 1)^2 + (2^k - 1) < 2^2k
+template <int N>
+inline void mul_add_limbs (const uint64_t * a, const uint64_t * b, const uint64_t * c, uint64_t * r)
+{
+    for (int i = 0; i < N; i++)
+    {
+        r[i] = c[i];
+        r[i + N] = 0;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        uint64_t carry = 0;
+        for (int j = 0; j < N; j++)
+        {
+            uint128_t t = (uint128_t)a[i] * b[j] + r[i + j] + carry;
+            r[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        r[i + N] = carry;
+    }
+}
+
+// Computes q = u / m and r = u % m, where u, q have UN limbs and m, r have N limbs, using
+// the long division of Knuth (TAOCP vol. 2, 4.3.1, algorithm D) over the significant limbs
+// of m. q can be null if only the remainder is needed.
+// Returns -1 if m is zero, 0 otherwise.
+template <int UN, int N>
+inline int divmod_limbs (const uint64_t * u, const uint64_t * m, uint64_t * q, uint64_t * r)
+{
+    // Significant limbs of the module
+    int t = N;
+    while ((t > 0) && (m[t - 1] == 0)) t--;
+    if (t == 0)
+    {
+        return -1;
+    }
+
+    if (t == 1)
+    {
+        uint64_t rem = 0;
+        for (int i = UN - 1; i >= 0; i--)
+        {
+            const uint64_t qi = div_128_64(rem, u[i], m[0], rem);
+            if (q) q[i] = qi;
+        }
+        r[0] = rem;
+        for (int i = 1; i < N; i++) r[i] = 0;
+        return 0;
+    }
+
+    // Normalize, shifting left until the most significant bit of the module is set
+    const int s = __builtin_clzll(m[t - 1]);
+    uint64_t vn[N];
+    uint64_t un[UN + 1];
+    for (int i = t - 1; i > 0; i--)
+    {
+        vn[i] = s ? (m[i] << s) | (m[i - 1] >> (64 - s)) : m[i];
+    }
+    vn[0] = m[0] << s;
+    un[UN] = s ? u[UN - 1] >> (64 - s) : 0;
+    for (int i = UN - 1; i > 0; i--)
+    {
+        un[i] = s ? (u[i] << s) | (u[i - 1] >> (64 - s)) : u[i];
+    }
+    un[0] = u[0] << s;
+
+    if (q)
+    {
+        for (int i = UN - t + 1; i < UN; i++) q[i] = 0;
+    }
+    for (int j = UN - t; j >= 0; j--)
+    {
+        // Estimate the quotient digit, at most 2 units greater than the real one. Since
+        // un[j + t] <= vn[t - 1], when they are equal the estimation is 2^64 - 1
+        uint64_t qhat, rhat;
+        bool rhat_overflow = false;
+        if (un[j + t] >= vn[t - 1])
+        {
+            qhat = 0xFFFFFFFFFFFFFFFF;
+            rhat = un[j + t - 1] + vn[t - 1];
+            rhat_overflow = rhat < vn[t - 1];
+        }
+        else
+        {
+            qhat = div_128_64(un[j + t], un[j + t - 1], vn[t - 1], rhat);
+        }
+        while (!rhat_overflow && ((uint128_t)qhat * vn[t - 2] > (((uint128_t)rhat << 64) | un[j + t - 2])))
+        {
+            qhat--;
+            rhat += vn[t - 1];
+            rhat_overflow = rhat < vn[t - 1];
+        }
+
+        // Multiply and subtract
+        uint64_t borrow = 0;
+        uint64_t carry = 0;
+        for (int i = 0; i < t; i++)
+        {
+            const uint128_t p = (uint128_t)qhat * vn[i] + carry;
+            carry = (uint64_t)(p >> 64);
+            const uint64_t pl = (uint64_t)p;
+            const uint64_t d = un[i + j] - pl;
+            const uint64_t b1 = un[i + j] < pl;
+            un[i + j] = d - borrow;
+            borrow = b1 | (d < borrow);
+        }
+        const uint64_t d = un[j + t] - carry;
+        const uint64_t b1 = un[j + t] < carry;
+        un[j + t] = d - borrow;
+        borrow = b1 | (d < borrow);
+
+        // The estimation was one unit greater, add back
+        if (borrow)
+        {
+            uint64_t c = 0;
+            for (int i = 0; i < t; i++)
+            {
+                const uint128_t sum = (uint128_t)un[i + j] + vn[i] + c;
+                un[i + j] = (uint64_t)sum;
+                c = (uint64_t)(sum >> 64);
+            }
+            un[j + t] += c;
+            qhat--;
+        }
+        if (q) q[j] = qhat;
+    }
+
+    // Unnormalize the remainder
+    for (int i = 0; i < t - 1; i++)
+    {
+        r[i] = s ? (un[i] >> s) | (un[i + 1] << (64 - s)) : un[i];
+    }
+    r[t - 1] = un[t - 1] >> s;
+    for (int i = t; i < N; i++) r[i] = 0;
+    return 0;
+}
+
+// Computes r = u % m, where u has 2N limbs and m, r have N limbs.
+// Returns -1 if m is zero, 0 otherwise.
+template <int N>
+inline int mod_limbs (const uint64_t * u, const uint64_t * m, uint64_t * r)
+{
+    return divmod_limbs<2 * N, N>(u, m, nullptr, r);
+}
+
+#endif
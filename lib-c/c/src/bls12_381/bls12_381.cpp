@@ -5,6 +5,7 @@
 #include "../ffiasm/bls12_381_384.hpp"
 #include "../common/utils.hpp"
 #include "../common/globals.hpp"
+#include "../common/batch.hpp"
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -47,6 +48,11 @@ int BLS12_381CurveAddP (const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
     return result;
 }
 
+int BLS12_381CurveAddBatchP (uint64_t n, const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
+{
+    return curveBatchFe(bls12_381, "BLS12_381CurveAddBatchP", n, false, p1, p2, p3);
+}
+
 /**************************/
 /* BLS12_381 CURVE DOUBLE */
 /**************************/
@@ -79,6 +85,11 @@ int BLS12_381CurveDblP (const uint64_t * p1, uint64_t * p2)
     return result;
 }
 
+int BLS12_381CurveDblBatchP (uint64_t n, const uint64_t * p1, uint64_t * p2)
+{
+    return curveBatchFe(bls12_381, "BLS12_381CurveDblBatchP", n, true, p1, NULL, p2);
+}
+
 /*************************/
 /* BLS12_381 COMPLEX ADD */
 /*************************/
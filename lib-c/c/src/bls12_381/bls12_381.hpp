@@ -26,6 +26,15 @@ int BLS12_381CurveAddP (
     uint64_t * p3  // 12 x 64 bits
 );
 
+// Computes n additions p3[i] = p1[i] + p2[i] with a single field inversion for all of them.
+// p3 can be the same array as p1.
+int BLS12_381CurveAddBatchP (
+    const uint64_t n,
+    const uint64_t * p1, // n x 12 x 64 bits
+    const uint64_t * p2, // n x 12 x 64 bits
+    uint64_t * p3  // n x 12 x 64 bits
+);
+
 /**************************/
 /* BLS12_381 curve double */
 /**************************/
@@ -42,6 +51,14 @@ int BLS12_381CurveDblP (
     uint64_t * p2  // 12 x 64 bits
 );
 
+// Computes n doublings p2[i] = 2 * p1[i] with a single field inversion for all of them.
+// p2 can be the same array as p1.
+int BLS12_381CurveDblBatchP (
+    const uint64_t n,
+    const uint64_t * p1, // n x 12 x 64 bits
+    uint64_t * p2  // n x 12 x 64 bits
+);
+
 /*************************/
 /* BLS12_381 complex add */
 /*************************/
@@ -5,6 +5,7 @@
 #include "../ffiasm/fq.hpp"
 #include "../common/utils.hpp"
 #include "../common/globals.hpp"
+#include "../common/batch.hpp"
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -47,6 +48,11 @@ int BN254CurveAddP (const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
     return result;
 }
 
+int BN254CurveAddBatchP (uint64_t n, const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
+{
+    return curveBatchFe(bn254, "BN254CurveAddBatchP", n, false, p1, p2, p3);
+}
+
 /**********************/
 /* BN254 CURVE DOUBLE */
 /**********************/
@@ -79,6 +85,11 @@ int BN254CurveDblP (const uint64_t * p1, uint64_t * p2)
     return result;
 }
 
+int BN254CurveDblBatchP (uint64_t n, const uint64_t * p1, uint64_t * p2)
+{
+    return curveBatchFe(bn254, "BN254CurveDblBatchP", n, true, p1, NULL, p2);
+}
+
 /*********************/
 /* BN254 COMPLEX ADD */
 /*********************/
@@ -26,6 +26,15 @@ int BN254CurveAddP (
     uint64_t * p3  // 8 x 64 bits
 );
 
+// Computes n additions p3[i] = p1[i] + p2[i] with a single field inversion for all of them.
+// p3 can be the same array as p1.
+int BN254CurveAddBatchP (
+    const uint64_t n,
+    const uint64_t * p1, // n x 8 x 64 bits
+    const uint64_t * p2, // n x 8 x 64 bits
+    uint64_t * p3  // n x 8 x 64 bits
+);
+
 /**********************/
 /* BN254 curve double */
 /**********************/
@@ -42,6 +51,14 @@ int BN254CurveDblP (
     uint64_t * p2  // 8 x 64 bits
 );
 
+// Computes n doublings p2[i] = 2 * p1[i] with a single field inversion for all of them.
+// p2 can be the same array as p1.
+int BN254CurveDblBatchP (
+    const uint64_t n,
+    const uint64_t * p1, // n x 8 x 64 bits
+    uint64_t * p2  // n x 8 x 64 bits
+);
+
 /*********************/
 /* BN254 complex add */
 /*********************/
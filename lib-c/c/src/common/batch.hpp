@@ -0,0 +1,124 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "utils.hpp"
+
+// Batch operations over arrays of field elements, sharing a single field inversion between
+// all of them using the Montgomery trick:
+//   prefix[i] = a[0] * ... * a[i]
+//   inv = prefix[n-1]^-1
+//   a[i]^-1 = inv * prefix[i-1], inv = inv * a[i] (from i = n-1 down to 0)
+// so n inversions cost 1 inversion plus 3(n-1) multiplications.
+
+// Computes values[i] = values[i]^-1 for all i, none of the values can be zero
+template <class Field>
+inline void batchInverse (Field &field, typename Field::Element * values, uint64_t n)
+{
+    if (n == 0) return;
+
+    std::vector<typename Field::Element> prefix(n);
+    prefix[0] = values[0];
+    for (uint64_t i = 1; i < n; i++)
+    {
+        field.mul(prefix[i], prefix[i - 1], values[i]);
+    }
+
+    typename Field::Element inv, aux;
+    field.inv(inv, prefix[n - 1]);
+    for (uint64_t i = n - 1; i > 0; i--)
+    {
+        field.mul(aux, inv, prefix[i - 1]);
+        field.mul(inv, inv, values[i]);
+        values[i] = aux;
+    }
+    values[0] = inv;
+}
+
+// Computes n affine point additions (dbl = false) or doublings (dbl = true) over a curve
+// y^2 = x^3 + b, with points as arrays of 2 * N64 u64 LE (x, y). When dbl is true p2 is
+// not used and can be null. Operations with a zero denominator are not computed, their
+// result is set to zero and -1 is returned, otherwise returns 0.
+template <class Field>
+inline int curveBatchFe (Field &field, const char * name, uint64_t n, bool dbl, const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
+{
+    typedef typename Field::Element Element;
+    const uint64_t n64 = sizeof(Element) / sizeof(uint64_t);
+    int result = 0;
+
+    // s = (y2-y1)/(x2-x1) for additions, s = 3*x1*x1/2*y1 for doublings
+    std::vector<Element> numerators(n);
+    std::vector<Element> denominators(n);
+    std::vector<bool> failed(n, false);
+    Element x1, y1, x2, y2, three;
+    field.fromUI(three, 3);
+    for (uint64_t i = 0; i < n; i++)
+    {
+        array2fe(p1 + i * 2 * n64, x1);
+        array2fe(p1 + i * 2 * n64 + n64, y1);
+        if (dbl)
+        {
+            field.square(numerators[i], x1);
+            field.mul(numerators[i], numerators[i], three);
+            field.add(denominators[i], y1, y1);
+        }
+        else
+        {
+            array2fe(p2 + i * 2 * n64, x2);
+            array2fe(p2 + i * 2 * n64 + n64, y2);
+            field.sub(numerators[i], y2, y1);
+            field.sub(denominators[i], x2, x1);
+        }
+        if (field.isZero(denominators[i]))
+        {
+            printf("%s() got denominator=0 on operation %lu\n", name, i);
+            failed[i] = true;
+            field.copy(denominators[i], field.one());
+            result = -1;
+        }
+    }
+
+    batchInverse(field, denominators.data(), n);
+
+    Element s, aux1, aux2, x3, y3;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        uint64_t * r = p3 + i * 2 * n64;
+        if (failed[i])
+        {
+            for (uint64_t j = 0; j < 2 * n64; j++) r[j] = 0;
+            continue;
+        }
+        field.mul(s, numerators[i], denominators[i]);
+
+        array2fe(p1 + i * 2 * n64, x1);
+        array2fe(p1 + i * 2 * n64 + n64, y1);
+        if (dbl)
+        {
+            field.add(aux2, x1, x1);
+        }
+        else
+        {
+            array2fe(p2 + i * 2 * n64, x2);
+            field.add(aux2, x1, x2);
+        }
+
+        // x3 = s*s - (x1+x2)
+        field.square(aux1, s);
+        field.sub(x3, aux1, aux2);
+
+        // y3 = s*(x1-x3) - y1
+        field.sub(aux1, x1, x3);
+        field.mul(aux1, aux1, s);
+        field.sub(y3, aux1, y1);
+
+        fe2array(x3, r);
+        fe2array(y3, r + n64);
+    }
+
+    return result;
+}
+
+#endif
@@ -6,16 +6,25 @@
 #include "../ffiasm/fnec.hpp"
 #include "../ffiasm/fq.hpp"
 #include "../ffiasm/bls12_381_384.hpp"
+#include "../ffiasm/psecp256r1.hpp"
+#include "../ffiasm/nsecp256r1.hpp"
+
+// Global field instances and constants, shared by all the lib-c functions. They are only
+// written during the static initialization, before any lib-c function can be called, so all
+// the exported functions are reentrant and can be called concurrently from any number of
+// threads. Any scratch state must live on the stack (or be thread_local), never here.
 
 extern RawFec fec;
 extern RawFnec fnec;
 extern RawFq bn254;
 extern RawBLS12_381_384 bls12_381;
+extern RawpSecp256r1 psecp256r1;
+extern RawnSecp256r1 nsecp256r1;
 
-extern mpz_class ScalarMask256;
-extern mpz_class ScalarMask384;
-extern mpz_class ScalarP_DIV_4;
-extern mpz_class ScalarP;
-extern mpz_class ScalarNQR;
+extern const mpz_class ScalarMask256;
+extern const mpz_class ScalarMask384;
+extern const mpz_class ScalarP_DIV_4;
+extern const mpz_class ScalarP;
+extern const mpz_class ScalarNQR;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef JACOBIAN_HPP
+#define JACOBIAN_HPP
+
+#include <stdint.h>
+#include "utils.hpp"
+
+// Jacobian coordinates engine for curves y^2 = x^3 + b (secp256k1, BN254, BLS12-381), where
+// the affine point (x, y) is (X/Z^2, Y/Z^3) and the point at infinity has Z = 0. Additions
+// and doublings don't need any field inversion, only the final conversion to affine does.
+// In the u64 array format the point at infinity is (0, 1), as in the zisklib curves.
+// https://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-0.html
+
+template <class Field>
+struct JacobianPoint
+{
+    typename Field::Element X, Y, Z;
+};
+
+// Computes r = 2 * p, using dbl-2009-l. r and p can be the same point
+template <class Field>
+inline void jacobianDbl (Field &field, JacobianPoint<Field> &r, const JacobianPoint<Field> &p)
+{
+    typename Field::Element a, b, c, d, e, f, aux;
+
+    // a = X1^2, b = Y1^2, c = b^2
+    field.square(a, p.X);
+    field.square(b, p.Y);
+    field.square(c, b);
+
+    // d = 2*((X1+b)^2-a-c)
+    field.add(aux, p.X, b);
+    field.square(d, aux);
+    field.sub(d, d, a);
+    field.sub(d, d, c);
+    field.add(d, d, d);
+
+    // e = 3*a, f = e^2
+    field.add(e, a, a);
+    field.add(e, e, a);
+    field.square(f, e);
+
+    // Z3 = 2*Y1*Z1, computed first since r can be p
+    field.mul(r.Z, p.Y, p.Z);
+    field.add(r.Z, r.Z, r.Z);
+
+    // X3 = f-2*d
+    field.sub(r.X, f, d);
+    field.sub(r.X, r.X, d);
+
+    // Y3 = e*(d-X3)-8*c
+    field.add(c, c, c);
+    field.add(c, c, c);
+    field.add(c, c, c);
+    field.sub(aux, d, r.X);
+    field.mul(r.Y, e, aux);
+    field.sub(r.Y, r.Y, c);
+}
+
+// Computes r = p + q, where q is an affine point (Z = 1) different from infinity, using
+// madd-2007-bl. r and p can be the same point
+template <class Field>
+inline void jacobianAddAffine (Field &field, JacobianPoint<Field> &r, const JacobianPoint<Field> &p, const typename Field::Element &qx, const typename Field::Element &qy)
+{
+    if (field.isZero(p.Z))
+    {
+        field.copy(r.X, qx);
+        field.copy(r.Y, qy);
+        field.copy(r.Z, field.one());
+        return;
+    }
+
+    typename Field::Element z1z1, u2, s2, h, hh, i, j, rr, v, aux;
+
+    // u2 = X2*Z1^2, s2 = Y2*Z1^3
+    field.square(z1z1, p.Z);
+    field.mul(u2, qx, z1z1);
+    field.mul(s2, qy, p.Z);
+    field.mul(s2, s2, z1z1);
+
+    // h = u2-X1, rr = 2*(s2-Y1)
+    field.sub(h, u2, p.X);
+    field.sub(rr, s2, p.Y);
+    if (field.isZero(h))
+    {
+        if (field.isZero(rr))
+        {
+            // Same point, double it
+            jacobianDbl(field, r, p);
+        }
+        else
+        {
+            // Opposite points, the result is the point at infinity
+            field.copy(r.X, field.one());
+            field.copy(r.Y, field.one());
+            field.copy(r.Z, field.zero());
+        }
+        return;
+    }
+    field.add(rr, rr, rr);
+
+    // hh = h^2, i = 4*hh, j = h*i, v = X1*i
+    field.square(hh, h);
+    field.add(i, hh, hh);
+    field.add(i, i, i);
+    field.mul(j, h, i);
+    field.mul(v, p.X, i);
+
+    // Z3 = (Z1+h)^2-z1z1-hh, computed first since r can be p
+    field.add(aux, p.Z, h);
+    field.square(r.Z, aux);
+    field.sub(r.Z, r.Z, z1z1);
+    field.sub(r.Z, r.Z, hh);
+
+    // 2*Y1*j, before Y1 is overwritten
+    field.mul(aux, p.Y, j);
+    field.add(aux, aux, aux);
+
+    // X3 = rr^2-j-2*v
+    field.square(r.X, rr);
+    field.sub(r.X, r.X, j);
+    field.sub(r.X, r.X, v);
+    field.sub(r.X, r.X, v);
+
+    // Y3 = rr*(v-X3)-2*Y1*j
+    field.sub(v, v, r.X);
+    field.mul(r.Y, rr, v);
+    field.sub(r.Y, r.Y, aux);
+}
+
+// Converts p to affine coordinates with a single field inversion. The point at infinity is
+// returned as (0, 1)
+template <class Field>
+inline void jacobianToAffine (Field &field, const JacobianPoint<Field> &p, typename Field::Element &x, typename Field::Element &y)
+{
+    if (field.isZero(p.Z))
+    {
+        field.copy(x, field.zero());
+        field.copy(y, field.one());
+        return;
+    }
+
+    typename Field::Element zinv, zinv2;
+    field.inv(zinv, p.Z);
+    field.square(zinv2, zinv);
+    field.mul(x, p.X, zinv2);
+    field.mul(zinv2, zinv2, zinv);
+    field.mul(y, p.Y, zinv2);
+}
+
+// Computes r = k * p, with p and r as affine points of 2 * N64 u64 LE (x, y) and k as 4 u64
+// LE, using double and add over Jacobian coordinates and a single inversion at the end.
+// The point at infinity is (0, 1), both as input and as output.
+template <class Field>
+inline void curveScalarMulFe (Field &field, const uint64_t * p, const uint64_t * k, uint64_t * r)
+{
+    typedef typename Field::Element Element;
+    const uint64_t n64 = sizeof(Element) / sizeof(uint64_t);
+
+    Element px, py, x, y;
+    array2fe(p, px);
+    array2fe(p + n64, py);
+
+    JacobianPoint<Field> acc;
+    field.copy(acc.X, field.one());
+    field.copy(acc.Y, field.one());
+    field.copy(acc.Z, field.zero());
+
+    bool infinity = field.isZero(px) && field.eq(py, field.one());
+    if (!infinity)
+    {
+        // Most significant bit first, the accumulator starts at p on the most significant 1
+        bool started = false;
+        for (int64_t i = 3; i >= 0; i--)
+        {
+            for (int64_t bit = 63; bit >= 0; bit--)
+            {
+                if (started)
+                {
+                    jacobianDbl(field, acc, acc);
+                }
+                if ((k[i] >> bit) & 1)
+                {
+                    jacobianAddAffine(field, acc, acc, px, py);
+                    started = true;
+                }
+            }
+        }
+    }
+
+    jacobianToAffine(field, acc, x, y);
+    fe2array(x, r);
+    fe2array(y, r + n64);
+}
+
+#endif
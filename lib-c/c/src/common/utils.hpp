@@ -43,68 +43,81 @@ inline void scalar2array6 (mpz_class &s, uint64_t * a)
     mpz_export((void *)a, NULL, -1, 8, -1, 0, s.get_mpz_t());
 }
 
+// Conversions between raw limbs and field elements use the Montgomery routines of each
+// field directly over the limbs, Element has the same layout as an array of N64 u64 LE.
+// Values not reduced (>= field prime) are reduced by the Montgomery multiplication, as
+// fromMpz does.
+
 // Converts an array of 4 u64 LE to a FEC element
 inline void array2fe (const uint64_t * a, RawFec::Element &fe)
 {
-    mpz_class s;
-    array2scalar(a, s);
-    fec.fromMpz(fe, s.get_mpz_t());
+    fec.toMontgomery(fe, *(const RawFec::Element *)a);
 }
 
 // Converts a FEC element to an array of 4 u64 LE
 inline void fe2array (const RawFec::Element &fe, uint64_t * a)
 {
-    mpz_class s;
-    fec.toMpz(s.get_mpz_t(), fe);
-    scalar2array(s, a);
+    fec.fromMontgomery(*(RawFec::Element *)a, fe);
 }
 
 // Converts an array of 4 u64 LE to a FNEC element
 inline void array2fe (const uint64_t * a, RawFnec::Element &fe)
 {
-    mpz_class s;
-    array2scalar(a, s);
-    fnec.fromMpz(fe, s.get_mpz_t());
+    fnec.toMontgomery(fe, *(const RawFnec::Element *)a);
 }
 
 // Converts a FNEC element to an array of 4 u64 LE
 inline void fe2array (const RawFnec::Element &fe, uint64_t * a)
 {
-    mpz_class s;
-    fnec.toMpz(s.get_mpz_t(), fe);
-    scalar2array(s, a);
+    fnec.fromMontgomery(*(RawFnec::Element *)a, fe);
 }
 
 // Converts an array of 4 u64 LE to a Fq (BN254) element
 inline void array2fe (const uint64_t * a, RawFq::Element &fe)
 {
-    mpz_class s;
-    array2scalar(a, s);
-    bn254.fromMpz(fe, s.get_mpz_t());
+    bn254.toMontgomery(fe, *(const RawFq::Element *)a);
 }
 
 // Converts a Fq (BN254) element to an array of 4 u64 LE
 inline void fe2array (const RawFq::Element &fe, uint64_t * a)
 {
-    mpz_class s;
-    bn254.toMpz(s.get_mpz_t(), fe);
-    scalar2array(s, a);
+    bn254.fromMontgomery(*(RawFq::Element *)a, fe);
 }
 
 // Converts an array of 6 u64 LE to a Fq (BLS12_381) element
 inline void array2fe (const uint64_t * a, RawBLS12_381_384::Element &fe)
 {
-    mpz_class s;
-    array2scalar6(a, s);
-    bls12_381.fromMpz(fe, s.get_mpz_t());
+    bls12_381.toMontgomery(fe, *(const RawBLS12_381_384::Element *)a);
 }
 
 // Converts a Fq (BLS12_381) element to an array of 6 u64 LE
 inline void fe2array (const RawBLS12_381_384::Element &fe, uint64_t * a)
 {
-    mpz_class s;
-    bls12_381.toMpz(s.get_mpz_t(), fe);
-    scalar2array6(s, a);
+    bls12_381.fromMontgomery(*(RawBLS12_381_384::Element *)a, fe);
+}
+
+// Converts an array of 4 u64 LE to a secp256r1 Fp element
+inline void array2fe (const uint64_t * a, RawpSecp256r1::Element &fe)
+{
+    psecp256r1.toMontgomery(fe, *(const RawpSecp256r1::Element *)a);
+}
+
+// Converts a secp256r1 Fp element to an array of 4 u64 LE
+inline void fe2array (const RawpSecp256r1::Element &fe, uint64_t * a)
+{
+    psecp256r1.fromMontgomery(*(RawpSecp256r1::Element *)a, fe);
+}
+
+// Converts an array of 4 u64 LE to a secp256r1 Fn element
+inline void array2fe (const uint64_t * a, RawnSecp256r1::Element &fe)
+{
+    nsecp256r1.toMontgomery(fe, *(const RawnSecp256r1::Element *)a);
+}
+
+// Converts a secp256r1 Fn element to an array of 4 u64 LE
+inline void fe2array (const RawnSecp256r1::Element &fe, uint64_t * a)
+{
+    nsecp256r1.fromMontgomery(*(RawnSecp256r1::Element *)a, fe);
 }
 
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "../ffiasm/fnec.hpp"
 #include "../common/utils.hpp"
 #include "../common/globals.hpp"
+#include "../common/batch.hpp"
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -182,6 +183,11 @@ int AddPointEcP (uint64_t _dbl, const uint64_t * p1, const uint64_t * p2, uint64
     return result;
 }
 
+int AddPointEcBatchP (uint64_t _dbl, uint64_t n, const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
+{
+    return curveBatchFe(fec, "AddPointEcBatchP", n, _dbl, p1, p2, p3);
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
\ No newline at end of file
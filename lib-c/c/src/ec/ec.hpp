@@ -24,6 +24,15 @@ int AddPointEcP (
     uint64_t * p3  // 8 x 64 bits
 );
 
+// Computes n additions (or doublings if dbl) of the points p1[i], p2[i] into p3[i], with a
+// single field inversion for all of them. p3 can be the same array as p1.
+int AddPointEcBatchP (
+    const uint64_t dbl,
+    const uint64_t n,
+    const uint64_t * p1, // n x 8 x 64 bits
+    const uint64_t * p2, // n x 8 x 64 bits, not used if dbl
+    uint64_t * p3  // n x 8 x 64 bits
+);
 
 #ifdef __cplusplus
 } // extern "C"
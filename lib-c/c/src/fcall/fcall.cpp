@@ -2,8 +2,11 @@
 #include "../common/utils.hpp"
 #include "../bn254/bn254_fe.hpp"
 #include "../bls12_381/bls12_381_fe.hpp"
+#include "../bigint/limbs.hpp"
+#include "../common/jacobian.hpp"
 #include <stdint.h>
 #include <assert.h>
+#include <string.h>
 
 int Fcall (
     struct FcallContext * ctx  // fcall context
@@ -98,6 +101,36 @@ int Fcall (
             iresult = BinDecompCtx(ctx);
             break;
         }
+        case FCALL_SECP256K1_SCALAR_MUL_ID:
+        {
+            iresult = Secp256k1ScalarMulCtx(ctx);
+            break;
+        }
+        case FCALL_BN254_SCALAR_MUL_ID:
+        {
+            iresult = BN254ScalarMulCtx(ctx);
+            break;
+        }
+        case FCALL_BLS12_381_SCALAR_MUL_ID:
+        {
+            iresult = BLS12_381ScalarMulCtx(ctx);
+            break;
+        }
+        case FCALL_SECP256R1_FP_INV_ID:
+        {
+            iresult = Secp256r1FpInvCtx(ctx);
+            break;
+        }
+        case FCALL_SECP256R1_FN_INV_ID:
+        {
+            iresult = Secp256r1FnInvCtx(ctx);
+            break;
+        }
+        case FCALL_SECP256R1_FP_SQRT_ID:
+        {
+            iresult = Secp256r1FpSqrtCtx(ctx);
+            break;
+        }
         default:
         {
             printf("Fcall() found unsupported function_id=%lu\n", ctx->function_id);
@@ -197,22 +230,96 @@ int InverseFnEcCtx (
 /* FEC SQRT */
 /************/
 
-mpz_class n("0x3fffffffffffffffffffffffffffffffffffffffffffffffffffffffbfffff0c");
-mpz_class p("0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
-
 // We use that p = 3 mod 4 => r = a^((p+1)/4) is a square root of a
 // https://www.rieselprime.de/ziki/Modular_square_root
-// n = p+1/4
-// return true if sqrt exists, false otherwise
+// The exponentiation is done in Montgomery form with a fixed addition chain per field.
+
+// Computes r = a^(2^n), r and a can be the same element
+template <class Field>
+inline void squareN(Field &field, typename Field::Element &r, const typename Field::Element &a, uint64_t n)
+{
+    field.square(r, a);
+    for (uint64_t i = 1; i < n; i++)
+    {
+        field.square(r, r);
+    }
+}
+
+// Returns true if the raw limbs of a are lower than the raw limbs of the field prime q
+inline bool rawLowerThan(const uint64_t * a, const uint64_t * q, uint64_t n64)
+{
+    for (int64_t i = n64 - 1; i >= 0; i--)
+    {
+        if (a[i] != q[i]) return a[i] < q[i];
+    }
+    return false;
+}
+
+// Computes r = a^((p+1)/4) on secp256k1 Fp. The binary representation of (p+1)/4 has 3
+// blocks of 1s, with lengths in { 2, 22, 223 }. Uses the addition chain of libsecp256k1
+// to calculate 2^n - 1 for each block: 1, [2], 3, 6, 9, 11, [22], 44, 88, 176, 220, [223]
+static void sqrtChainFec(RawFec::Element &r, const RawFec::Element &a)
+{
+    RawFec::Element x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t1;
+
+    fec.square(x2, a);
+    fec.mul(x2, x2, a);
+
+    fec.square(x3, x2);
+    fec.mul(x3, x3, a);
 
-inline bool sqrtF3mod4(mpz_class &r, const mpz_class &a)
+    squareN(fec, x6, x3, 3);
+    fec.mul(x6, x6, x3);
+
+    squareN(fec, x9, x6, 3);
+    fec.mul(x9, x9, x3);
+
+    squareN(fec, x11, x9, 2);
+    fec.mul(x11, x11, x2);
+
+    squareN(fec, x22, x11, 11);
+    fec.mul(x22, x22, x11);
+
+    squareN(fec, x44, x22, 22);
+    fec.mul(x44, x44, x22);
+
+    squareN(fec, x88, x44, 44);
+    fec.mul(x88, x88, x44);
+
+    squareN(fec, x176, x88, 88);
+    fec.mul(x176, x176, x88);
+
+    squareN(fec, x220, x176, 44);
+    fec.mul(x220, x220, x44);
+
+    squareN(fec, x223, x220, 3);
+    fec.mul(x223, x223, x3);
+
+    // The final result is assembled using a sliding window over the blocks
+    squareN(fec, t1, x223, 23);
+    fec.mul(t1, t1, x22);
+    squareN(fec, t1, t1, 6);
+    fec.mul(t1, t1, x2);
+    squareN(fec, r, t1, 2);
+}
+
+// Computes r = a^((p+1)/4) on secp256k1 Fp, returns true if r is a square root of a.
+// If a is not a quadratic residue (or a >= p) r = (3*a)^((p+1)/4), since 3 is a non
+// quadratic residue
+inline bool sqrtF3mod4(RawFec::Element &r, const uint64_t * _a)
 {
-    mpz_class auxa = a;
-    mpz_powm(r.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t(), p.get_mpz_t());
-    if ((r * r) % p != auxa)
+    RawFec::Element a;
+    array2fe(_a, a);
+    sqrtChainFec(r, a);
+
+    RawFec::Element square;
+    fec.square(square, r);
+    if (!rawLowerThan(_a, Fec_rawq, 4) || !fec.eq(square, a))
     {
-        auxa = (auxa * 3) % p;
-        mpz_powm(r.get_mpz_t(), auxa.get_mpz_t(), n.get_mpz_t(), p.get_mpz_t());
+        RawFec::Element a3;
+        fec.add(a3, a, a);
+        fec.add(a3, a3, a);
+        sqrtChainFec(r, a3);
         return false;
     }
     return true;
@@ -224,35 +331,20 @@ int SqrtFpEcParity (
     uint64_t * _r  // 1 x 64 bits (sqrt exists) + 4 x 64 bits
 )
 {
-    mpz_class parity(static_cast<unsigned long>(_parity));
-    mpz_class a;
-    array2scalar(_a, a);
-
     // Call the sqrt function
-    mpz_class r;
-    bool sqrt_exists = sqrtF3mod4(r, a);
+    RawFec::Element r;
+    bool sqrt_exists = sqrtF3mod4(r, _a);
 
     _r[0] = sqrt_exists;
 
     // Post-process the result
-    if (r == ScalarMask256)
+    fe2array(r, &_r[1]);
+    if ((_r[1] & 1) != _parity)
     {
-        // This sqrt does not have a solution
+        // Negate the result, since it hasn't the requested parity
+        r = fec.neg(r);
+        fe2array(r, &_r[1]);
     }
-    else if ((r & 1) == parity)
-    {
-        // Return r as it is, since it has the requested parity
-    }
-    else
-    {
-        // Negate the result
-        RawFec::Element fe;
-        fec.fromMpz(fe, r.get_mpz_t());
-        fe = fec.neg(fe);
-        fec.toMpz(r.get_mpz_t(), fe);
-    }
-
-    scalar2array(r, &_r[1]);
 
     return 0;
 }
@@ -578,33 +670,71 @@ int BLS12_381FpInvCtx (
 /* BLS12_381 CURVE SQUARE ROOT */
 /*******************************/
 
+// Sliding window (5 bits) addition chain of (p+1)/4 on BLS12-381 Fp. Starting with the odd
+// power of the first step, each step squares the accumulator and multiplies it by an odd
+// power a^(2*index+1).
+static const uint8_t bls12_381_sqrt_chain[][2] = {
+    // {squarings, index}
+    {0, 6}, {13, 8}, {7, 7}, {4, 2}, {6, 3}, {7, 11}, {5, 15}, {5, 12}, {3, 2}, {6, 6},
+    {6, 4}, {3, 1}, {8, 13}, {3, 2}, {6, 7}, {6, 13}, {3, 0}, {8, 6}, {7, 11}, {5, 5},
+    {6, 6}, {6, 14}, {4, 4}, {8, 14}, {4, 6}, {7, 11}, {9, 9}, {5, 12}, {2, 1}, {7, 2},
+    {7, 4}, {6, 11}, {5, 14}, {5, 9}, {5, 9}, {8, 6}, {7, 10}, {9, 7}, {5, 6}, {3, 1},
+    {8, 7}, {3, 1}, {7, 4}, {9, 7}, {6, 10}, {6, 15}, {5, 15}, {5, 15}, {4, 6}, {3, 1},
+    {8, 10}, {7, 15}, {5, 15}, {5, 15}, {4, 7}, {4, 3}, {7, 15}, {5, 14}, {5, 15}, {5, 15},
+    {5, 15}, {5, 15}, {5, 15}, {5, 15}, {4, 6}, {6, 10}, {5, 5}
+};
+
+// Computes r = a^((p+1)/4) on BLS12-381 Fp
+static void sqrtChainBLS12_381(RawBLS12_381_384::Element &r, const RawBLS12_381_384::Element &a)
+{
+    // Odd powers a^1, a^3, ..., a^31
+    RawBLS12_381_384::Element powers[16];
+    RawBLS12_381_384::Element a2;
+    bls12_381.square(a2, a);
+    bls12_381.copy(powers[0], a);
+    for (uint64_t i = 1; i < 16; i++)
+    {
+        bls12_381.mul(powers[i], powers[i - 1], a2);
+    }
+
+    const uint64_t steps = sizeof(bls12_381_sqrt_chain) / sizeof(bls12_381_sqrt_chain[0]);
+    bls12_381.copy(r, powers[bls12_381_sqrt_chain[0][1]]);
+    for (uint64_t i = 1; i < steps; i++)
+    {
+        squareN(bls12_381, r, r, bls12_381_sqrt_chain[i][0]);
+        bls12_381.mul(r, r, powers[bls12_381_sqrt_chain[i][1]]);
+    }
+}
+
 int BLS12_381FpSqrt (
     const uint64_t * _a, // 6 x 64 bits
           uint64_t * _r  // 6 x 64 bits
 )
 {
-    mpz_class a;
-    array2scalar6(_a, a);
+    RawBLS12_381_384::Element a;
+    array2fe(_a, a);
 
     // Attempt to compute the square root of a
-    mpz_class r;
-    mpz_powm(r.get_mpz_t(), a.get_mpz_t(), ScalarP_DIV_4.get_mpz_t(), ScalarP.get_mpz_t());
+    RawBLS12_381_384::Element r;
+    sqrtChainBLS12_381(r, a);
 
-    // Check if a is a quadratic residue
-    mpz_class square = (r * r) % ScalarP;
-    uint64_t a_is_gr = (square == a) ? 1 : 0;
+    // Check if a is a quadratic residue (a >= p is never considered a quadratic residue)
+    RawBLS12_381_384::Element square;
+    bls12_381.square(square, r);
+    uint64_t a_is_gr = (rawLowerThan(_a, BLS12_381_384_rawq, 6) && bls12_381.eq(square, a)) ? 1 : 0;
     _r[0] = a_is_gr;
     if (!a_is_gr)
     {
         // To check that a is indeed a non-quadratic residue, we check that
-        // a * NQR is a quadratic residue for some fixed known non-quadratic residue NQR
-        mpz_class a_nqr = (a * ScalarNQR) % ScalarP;
+        // a * NQR is a quadratic residue for some fixed known non-quadratic residue NQR = 2
+        RawBLS12_381_384::Element a_nqr;
+        bls12_381.add(a_nqr, a, a);
 
         // Compute the square root of a * NQR
-        mpz_powm(r.get_mpz_t(), a_nqr.get_mpz_t(), ScalarP_DIV_4.get_mpz_t(), ScalarP.get_mpz_t());
+        sqrtChainBLS12_381(r, a_nqr);
     }
 
-    scalar2array6(r, &_r[1]);
+    fe2array(r, &_r[1]);
 
     return 0;
 }
@@ -839,6 +969,12 @@ int BigInt256Div (
           uint64_t * _r  // 8 x 64 bits
 )
 {
+    if (divmod_limbs<4, 4>(_a, _a + 4, &_r[0], &_r[4]) == 0)
+    {
+        return 0;
+    }
+
+    // Division by zero, keep the behavior of GMP
     mpz_class a, b;
     array2scalar(_a, a);
     array2scalar(_a + 4, b);
@@ -873,6 +1009,13 @@ int BigInt256DivCtx (
 /* BIG INT DIVISION */
 /********************/
 
+// Returns the number of significant limbs of a
+inline uint64_t significant_limbs (const uint64_t * a, uint64_t len)
+{
+    while ((len > 0) && (a[len - 1] == 0)) len--;
+    return len;
+}
+
 int BigIntDivCtx (
     struct FcallContext * ctx  // fcall context
 )
@@ -882,18 +1025,32 @@ int BigIntDivCtx (
     assert(len_a < FCALL_PARAMS_MAX_SIZE);
     uint64_t len_b = ctx->params[1 + len_a];
     assert(len_b < FCALL_PARAMS_MAX_SIZE);
+    const uint64_t * _a = &ctx->params[1];
+    const uint64_t * _b = &ctx->params[2 + len_a];
+
+    // Operands up to 256 bits are divided over fixed 4 limbs, the quotient and the remainder
+    // fit in 4 limbs, the minimum size of the result
+    uint64_t sig_a = significant_limbs(_a, len_a);
+    uint64_t sig_b = significant_limbs(_b, len_b);
+    if ((sig_a <= 4) && (sig_b <= 4) && (sig_b > 0))
+    {
+        uint64_t a[4] = {0, 0, 0, 0};
+        uint64_t b[4] = {0, 0, 0, 0};
+        for (uint64_t i = 0; i < sig_a; i++) a[i] = _a[i];
+        for (uint64_t i = 0; i < sig_b; i++) b[i] = _b[i];
+        ctx->result[0] = 4;
+        ctx->result[5] = 4;
+        divmod_limbs<4, 4>(a, b, &ctx->result[1], &ctx->result[6]);
+        return 10;
+    }
 
-    // Convert first parameter to mpz_class
-    mpz_class a;
-    mpz_import(a.get_mpz_t(), len_a, -1, 8, -1, 0, (const void *)&ctx->params[1]);
-
-    // Convert second parameter to mpz_class
-    mpz_class b;
-    mpz_import(b.get_mpz_t(), len_b, -1, 8, -1, 0, (const void *)&ctx->params[2 + len_a]);
+    // Larger operands use GMP, reusing the integers of the thread to avoid allocations
+    thread_local mpz_class a, b, quotient, remainder;
+    mpz_import(a.get_mpz_t(), len_a, -1, 8, -1, 0, (const void *)_a);
+    mpz_import(b.get_mpz_t(), len_b, -1, 8, -1, 0, (const void *)_b);
 
     // Compute quotient and remainder
-    mpz_class quotient = a / b;
-    mpz_class remainder = a % b;
+    mpz_tdiv_qr(quotient.get_mpz_t(), remainder.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
 
     // Convert quotient to an array of u64 starting at ctx->result[1], with length multiple of 4
     size_t exported_size = 0;
@@ -929,39 +1086,298 @@ int BinDecompCtx (
     // Parse input parameter length
     uint64_t len_x = ctx->params[0];
     assert(len_x < FCALL_PARAMS_MAX_SIZE);
+    const uint64_t * x = &ctx->params[1];
 
-    // Perform binary decomposition
-    ctx->result_size = 0;
-    bool started = false;
-
-    // For every u64 in the input parameter, in reverse order
-    for (int i = len_x - 1; i >= 0; i--)
+    // Skip the leading zero words, the decomposition starts at the most significant 1 bit
+    uint64_t len = significant_limbs(x, len_x);
+    if (len == 0)
     {
-        // For every bit in the u64, in reverse order
-        for (int bit_pos = 63; bit_pos >= 0; bit_pos--)
+        ctx->result[0] = 0;
+        ctx->result_size = 1;
+        return 0;
+    }
+    uint64_t top_bits = 64 - __builtin_clzll(x[len - 1]);
+    uint64_t result_size = top_bits + (len - 1) * 64;
+    assert(result_size < FCALL_RESULT_MAX_SIZE);
+
+    // Word at a time, from the most significant word: clear the 64 (or top_bits) output bits
+    // and set the ones, iterating over the set bits of the word
+    uint64_t * r = &ctx->result[1];
+    uint64_t bits = top_bits;
+    for (int64_t i = len - 1; i >= 0; i--)
+    {
+        memset(r, 0, bits * sizeof(uint64_t));
+        uint64_t word = x[i];
+        while (word != 0)
         {
-            // Obtain the bit value
-            uint8_t bit = (ctx->params[1 + i] >> bit_pos) & 1;
-
-            // Start recording once we hit the first 1 bit
-            if (!started && bit == 1)
-            {
-                started = true;
-            }
-
-            // If started, record the bit
-            if (started)
-            {
-                ctx->result[1 + ctx->result_size] = bit;
-                ctx->result_size += 1;
-                assert(ctx->result_size < FCALL_RESULT_MAX_SIZE);
-            }
+            r[bits - 1 - __builtin_ctzll(word)] = 1;
+            word &= word - 1;
         }
+        r += bits;
+        bits = 64;
     }
 
     // Store the result size at the beginning of the result array
-    ctx->result[0] = ctx->result_size;
-    ctx->result_size++;
+    ctx->result[0] = result_size;
+    ctx->result_size = result_size + 1;
     
     return 0;
-}
\ No newline at end of file
+}
+
+/***********************************/
+/* SECP256K1 SCALAR MULTIPLICATION */
+/***********************************/
+
+int Secp256k1ScalarMul (
+    const uint64_t * _a, // 8 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * _r  // 8 x 64 bits
+)
+{
+    curveScalarMulFe(fec, _a, _a + 8, _r);
+    return 0;
+}
+
+int Secp256k1ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = Secp256k1ScalarMul(ctx->params, ctx->result);
+    if (iresult == 0)
+    {
+        iresult = 8;
+        ctx->result_size = 8;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
+
+/*******************************/
+/* BN254 SCALAR MULTIPLICATION */
+/*******************************/
+
+int BN254ScalarMul (
+    const uint64_t * _a, // 8 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * _r  // 8 x 64 bits
+)
+{
+    curveScalarMulFe(bn254, _a, _a + 8, _r);
+    return 0;
+}
+
+int BN254ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = BN254ScalarMul(ctx->params, ctx->result);
+    if (iresult == 0)
+    {
+        iresult = 8;
+        ctx->result_size = 8;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
+
+/***********************************/
+/* BLS12_381 SCALAR MULTIPLICATION */
+/***********************************/
+
+int BLS12_381ScalarMul (
+    const uint64_t * _a, // 12 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * _r  // 12 x 64 bits
+)
+{
+    curveScalarMulFe(bls12_381, _a, _a + 12, _r);
+    return 0;
+}
+
+int BLS12_381ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = BLS12_381ScalarMul(ctx->params, ctx->result);
+    if (iresult == 0)
+    {
+        iresult = 12;
+        ctx->result_size = 12;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
+
+/********************/
+/* SECP256R1 FP INV */
+/********************/
+
+int Secp256r1FpInv (
+    const uint64_t * _a, // 4 x 64 bits
+          uint64_t * _r  // 4 x 64 bits
+)
+{
+    RawpSecp256r1::Element a;
+    array2fe(_a, a);
+    if (psecp256r1.isZero(a))
+    {
+        printf("Secp256r1FpInv() Division by zero\n");
+        return -1;
+    }
+
+    RawpSecp256r1::Element r;
+    psecp256r1.inv(r, a);
+
+    fe2array(r, _r);
+
+    return 0;
+}
+
+int Secp256r1FpInvCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = Secp256r1FpInv(ctx->params, ctx->result);
+    if (iresult == 0)
+    {
+        iresult = 4;
+        ctx->result_size = 4;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
+
+/********************/
+/* SECP256R1 FN INV */
+/********************/
+
+int Secp256r1FnInv (
+    const uint64_t * _a, // 4 x 64 bits
+          uint64_t * _r  // 4 x 64 bits
+)
+{
+    RawnSecp256r1::Element a;
+    array2fe(_a, a);
+    if (nsecp256r1.isZero(a))
+    {
+        printf("Secp256r1FnInv() Division by zero\n");
+        return -1;
+    }
+
+    RawnSecp256r1::Element r;
+    nsecp256r1.inv(r, a);
+
+    fe2array(r, _r);
+
+    return 0;
+}
+
+int Secp256r1FnInvCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = Secp256r1FnInv(ctx->params, ctx->result);
+    if (iresult == 0)
+    {
+        iresult = 4;
+        ctx->result_size = 4;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
+
+/*********************/
+/* SECP256R1 FP SQRT */
+/*********************/
+
+// Computes r = a^((p+1)/4) on secp256r1 Fp, where (p+1)/4 = 2^254 - 2^222 + 2^190 + 2^94,
+// i.e. a block of 32 1s followed by two isolated 1s: 1, 2, 4, 8, 16, [32]
+static void sqrtChainSecp256r1(RawpSecp256r1::Element &r, const RawpSecp256r1::Element &a)
+{
+    RawpSecp256r1::Element x2, x4, x8, x16, x32;
+
+    psecp256r1.square(x2, a);
+    psecp256r1.mul(x2, x2, a);
+
+    squareN(psecp256r1, x4, x2, 2);
+    psecp256r1.mul(x4, x4, x2);
+
+    squareN(psecp256r1, x8, x4, 4);
+    psecp256r1.mul(x8, x8, x4);
+
+    squareN(psecp256r1, x16, x8, 8);
+    psecp256r1.mul(x16, x16, x8);
+
+    squareN(psecp256r1, x32, x16, 16);
+    psecp256r1.mul(x32, x32, x16);
+
+    squareN(psecp256r1, r, x32, 32);
+    psecp256r1.mul(r, r, a);
+    squareN(psecp256r1, r, r, 96);
+    psecp256r1.mul(r, r, a);
+    squareN(psecp256r1, r, r, 94);
+}
+
+int Secp256r1FpSqrt (
+    const uint64_t * _a,  // 4 x 64 bits
+    const uint64_t _parity,  // 1 x 64 bits
+    uint64_t * _r  // 1 x 64 bits (sqrt exists) + 4 x 64 bits
+)
+{
+    // p = 3 mod 4, so r = a^((p+1)/4) is a square root of a if it exists. Otherwise, since
+    // p = 7 mod 12 and 3 is a non quadratic residue, r = (3*a)^((p+1)/4) is returned
+    RawpSecp256r1::Element a, r, square;
+    array2fe(_a, a);
+    sqrtChainSecp256r1(r, a);
+    psecp256r1.square(square, r);
+    bool sqrt_exists = rawLowerThan(_a, pSecp256r1_rawq, 4) && psecp256r1.eq(square, a);
+    if (!sqrt_exists)
+    {
+        RawpSecp256r1::Element a3;
+        psecp256r1.add(a3, a, a);
+        psecp256r1.add(a3, a3, a);
+        sqrtChainSecp256r1(r, a3);
+    }
+
+    _r[0] = sqrt_exists;
+
+    // Post-process the result
+    fe2array(r, &_r[1]);
+    if ((_r[1] & 1) != _parity)
+    {
+        // Negate the result, since it hasn't the requested parity
+        psecp256r1.neg(r, r);
+        fe2array(r, &_r[1]);
+    }
+
+    return 0;
+}
+
+int Secp256r1FpSqrtCtx (
+    struct FcallContext * ctx  // fcall context
+)
+{
+    int iresult = Secp256r1FpSqrt(ctx->params, ctx->params[4], &ctx->result[0]);
+    if (iresult == 0)
+    {
+        iresult = 5;
+        ctx->result_size = 5;
+    }
+    else
+    {
+        ctx->result_size = 0;
+    }
+    return iresult;
+}
@@ -25,11 +25,18 @@ extern "C" {
 #define FCALL_BIGINT256_DIV_ID 16
 #define FCALL_BIG_INT_DIV_ID 17
 #define FCALL_BIN_DECOMP_ID 18
+#define FCALL_SECP256K1_SCALAR_MUL_ID 19
+#define FCALL_BN254_SCALAR_MUL_ID 20
+#define FCALL_BLS12_381_SCALAR_MUL_ID 21
+#define FCALL_SECP256R1_FP_INV_ID 22
+#define FCALL_SECP256R1_FN_INV_ID 23
+#define FCALL_SECP256R1_FP_SQRT_ID 24
 
 #define FCALL_PARAMS_MAX_SIZE 386
 #define FCALL_RESULT_MAX_SIZE 8193
 
-// Fcall context
+// Fcall context. Fcall functions keep no state between calls, so they can run concurrently
+// as long as every thread uses its own context
 struct FcallContext
 {
     uint64_t function_id; // identifies what function to call
@@ -98,6 +105,24 @@ int BigIntDivCtx (
 int BinDecompCtx (
     struct FcallContext * ctx  // fcall context
 );
+int Secp256k1ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+);
+int BN254ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+);
+int BLS12_381ScalarMulCtx (
+    struct FcallContext * ctx  // fcall context
+);
+int Secp256r1FpInvCtx (
+    struct FcallContext * ctx  // fcall context
+);
+int Secp256r1FnInvCtx (
+    struct FcallContext * ctx  // fcall context
+);
+int Secp256r1FpSqrtCtx (
+    struct FcallContext * ctx  // fcall context
+);
 
 // Functions supported by fcall, in u64 array format
 int InverseFpEc (
@@ -162,6 +187,36 @@ int BigInt256Div (
           uint64_t * r  // 8 x 64 bits
 );
 
+// Scalar multiplications k * p over Jacobian coordinates, with a single inversion to return
+// the affine result. The point at infinity is (0, 1), both as input and as output
+int Secp256k1ScalarMul (
+    const uint64_t * a, // 8 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * r  // 8 x 64 bits
+);
+int BN254ScalarMul (
+    const uint64_t * a, // 8 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * r  // 8 x 64 bits
+);
+int BLS12_381ScalarMul (
+    const uint64_t * a, // 12 x 64 bits (point) + 4 x 64 bits (scalar)
+          uint64_t * r  // 12 x 64 bits
+);
+
+// secp256r1 (P-256) field hints
+int Secp256r1FpInv (
+    const uint64_t * a, // 4 x 64 bits
+          uint64_t * r  // 4 x 64 bits
+);
+int Secp256r1FnInv (
+    const uint64_t * a, // 4 x 64 bits
+          uint64_t * r  // 4 x 64 bits
+);
+int Secp256r1FpSqrt (
+    const uint64_t * a, // 4 x 64 bits
+    const uint64_t parity, // 1 x 64 bits
+          uint64_t * r  // 1 x 64 bits (sqrt exists) + 4 x 64 bits
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -1,4 +1,5 @@
 #include "bls12_381_384.hpp"
+#include "modinv.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <gmp.h>
@@ -232,18 +233,15 @@ std::string RawBLS12_381_384::toString(const Element &a, uint32_t radix) {
     return resS;
 }
 
-void RawBLS12_381_384::inv(Element &r, const Element &a) {
-    mpz_t mr;
-    mpz_init(mr);
-    mpz_import(mr, BLS12_381_384_N64, -1, 8, -1, 0, (const void *)(a.v));
-    mpz_invert(mr, mr, q);
-
-
-    for (int i=0; i<BLS12_381_384_N64; i++) r.v[i] = 0;
-    mpz_export((void *)(r.v), NULL, -1, 8, -1, 0, mr);
+// Modulus of the field as signed limbs of 62 bits, for the safegcd inversion. The field values
+// are not secret, so the variable time version is used
+static const ModInvModInfo<7> modinv_info = modinv_modinfo<BLS12_381_384_N64, 7>(BLS12_381_384_rawq);
 
+void RawBLS12_381_384::inv(Element &r, const Element &a) {
+    // a is in Montgomery form (a*R), its raw inverse is (a*R)^-1, and the Montgomery
+    // multiplication by R^3 returns a^-1*R
+    modinv_var_u64<BLS12_381_384_N64, 7>(r.v, a.v, modinv_info);
     BLS12_381_384_rawMMul(r.v, r.v,BLS12_381_384_rawR3);
-    mpz_clear(mr);
 }
 
 void RawBLS12_381_384::div(Element &r, const Element &a, const Element &b) {
@@ -1,4 +1,5 @@
 #include "fq.hpp"
+#include "modinv.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <gmp.h>
@@ -232,18 +233,15 @@ std::string RawFq::toString(const Element &a, uint32_t radix) {
     return resS;
 }
 
-void RawFq::inv(Element &r, const Element &a) {
-    mpz_t mr;
-    mpz_init(mr);
-    mpz_import(mr, Fq_N64, -1, 8, -1, 0, (const void *)(a.v));
-    mpz_invert(mr, mr, q);
-
-
-    for (int i=0; i<Fq_N64; i++) r.v[i] = 0;
-    mpz_export((void *)(r.v), NULL, -1, 8, -1, 0, mr);
+// Modulus of the field as signed limbs of 62 bits, for the safegcd inversion. The field values
+// are not secret, so the variable time version is used
+static const ModInvModInfo<5> modinv_info = modinv_modinfo<Fq_N64, 5>(Fq_rawq);
 
+void RawFq::inv(Element &r, const Element &a) {
+    // a is in Montgomery form (a*R), its raw inverse is (a*R)^-1, and the Montgomery
+    // multiplication by R^3 returns a^-1*R
+    modinv_var_u64<Fq_N64, 5>(r.v, a.v, modinv_info);
     Fq_rawMMul(r.v, r.v,Fq_rawR3);
-    mpz_clear(mr);
 }
 
 void RawFq::div(Element &r, const Element &a, const Element &b) {
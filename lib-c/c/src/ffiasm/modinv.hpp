@@ -0,0 +1,391 @@
+#ifndef MODINV_HPP
+#define MODINV_HPP
+
+#include <stdint.h>
+
+// Modular inversion using the safegcd algorithm of Bernstein and Yang
+// (https://gcd.cr.yp.to/safegcd-20190413.pdf), with the "half-delta" divsteps variant and
+// the layout of libsecp256k1 (modinv64): values are represented as L signed limbs of 62 bits,
+// and each iteration applies 59 divsteps to the low limbs, followed by the update of the
+// full values with the resulting 2x2 transition matrix. The sequence of operations of modinv
+// only depends on the modulus, never on the value to invert.
+//
+// modinv_var is the variable time version (modinv64_var): 62 divsteps per iteration, skipping
+// the zeros of g and cancelling several bits of g at once, and it stops as soon as g reaches 0.
+// It is faster than both modinv and mpz_invert, and it is the one used by the fields, whose
+// values are not secret.
+//
+// Divsteps needed, from the bound floor((45907 * d + 26313) / 19929) for d-bit values:
+//   d <= 256 bits: 10 iterations of 59 divsteps (590, tight bound proven for 256 bits)
+//   d <= 381 bits: 15 iterations of 59 divsteps (885 >= 878)
+
+typedef __int128 int128_t;
+
+#define MODINV_M62 (UINT64_MAX >> 2)
+
+// Hides the value from the optimizer, so masks are never turned into branches
+template <typename T>
+inline T modinv_barrier (T value)
+{
+    __asm__ ("" : "+r" (value));
+    return value;
+}
+
+template <int L>
+struct ModInvSigned62 {
+    int64_t v[L];
+};
+
+template <int L>
+struct ModInvModInfo {
+    ModInvSigned62<L> modulus;
+    uint64_t modulus_inv62; // modulus^-1 mod 2^62
+};
+
+struct ModInvTrans2x2 {
+    int64_t u, v, q, r;
+};
+
+// Converts N64 unsigned limbs of 64 bits to L signed limbs of 62 bits
+template <int N64, int L>
+inline void modinv_from_u64 (const uint64_t * a, ModInvSigned62<L> &r)
+{
+    for (int i = 0; i < L; i++)
+    {
+        const int bit = 62 * i;
+        const int w = bit / 64;
+        const int s = bit % 64;
+        uint64_t value = 0;
+        if (w < N64)
+        {
+            value = a[w] >> s;
+            if ((s > 2) && (w + 1 < N64))
+            {
+                value |= a[w + 1] << (64 - s);
+            }
+        }
+        r.v[i] = value & MODINV_M62;
+    }
+}
+
+// Converts L non-negative signed limbs of 62 bits to N64 unsigned limbs of 64 bits
+template <int N64, int L>
+inline void modinv_to_u64 (const ModInvSigned62<L> &a, uint64_t * r)
+{
+    unsigned __int128 acc = 0;
+    int bits = 0;
+    int j = 0;
+    for (int i = 0; i < L; i++)
+    {
+        acc |= (unsigned __int128)(uint64_t)a.v[i] << bits;
+        bits += 62;
+        if ((bits >= 64) && (j < N64))
+        {
+            r[j++] = (uint64_t)acc;
+            acc >>= 64;
+            bits -= 64;
+        }
+    }
+    while (j < N64)
+    {
+        r[j++] = (uint64_t)acc;
+        acc >>= 64;
+    }
+}
+
+// Builds the modulus information from N64 unsigned limbs of 64 bits
+template <int N64, int L>
+inline ModInvModInfo<L> modinv_modinfo (const uint64_t * modulus)
+{
+    ModInvModInfo<L> info;
+    modinv_from_u64<N64, L>(modulus, info.modulus);
+
+    // Newton iteration, each step doubles the correct low bits of the inverse
+    uint64_t inv = modulus[0];
+    for (int i = 0; i < 5; i++)
+    {
+        inv *= 2 - modulus[0] * inv;
+    }
+    info.modulus_inv62 = inv & MODINV_M62;
+    return info;
+}
+
+// Computes the transition matrix and new zeta after 59 divsteps, zeta = -(delta + 1/2).
+// The matrix is scaled by 2^62.
+inline int64_t modinv_divsteps_59 (int64_t zeta, uint64_t f0, uint64_t g0, ModInvTrans2x2 &t)
+{
+    // u, v, q, r start as the identity matrix times 8 (2^62 / 2^59), represented as unsigned
+    // to allow left shifts of negative values.
+    uint64_t u = 8, v = 0, q = 0, r = 8;
+    uint64_t mask1, mask2, f = f0, g = g0, x, y, z;
+
+    for (int i = 3; i < 62; ++i)
+    {
+        // Conditional masks for (zeta < 0) and for (g & 1)
+        mask1 = modinv_barrier((uint64_t)(zeta >> 63));
+        mask2 = -modinv_barrier(g & 1);
+        // x, y, z conditionally negated versions of f, u, v
+        x = (f ^ mask1) - mask1;
+        y = (u ^ mask1) - mask1;
+        z = (v ^ mask1) - mask1;
+        // Conditionally add x, y, z to g, q, r
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+        // mask1 is now the condition (zeta < 0) and (g & 1)
+        mask1 &= mask2;
+        // Conditionally change zeta into -zeta - 2 or zeta - 1
+        zeta = (zeta ^ (int64_t)mask1) - 1;
+        // Conditionally add g, q, r to f, u, v
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t.u = (int64_t)u;
+    t.v = (int64_t)v;
+    t.q = (int64_t)q;
+    t.r = (int64_t)r;
+    return zeta;
+}
+
+// Computes (t / 2^62) * [d, e] mod modulus, d and e in range (-2 * modulus, modulus)
+template <int L>
+inline void modinv_update_de_62 (ModInvSigned62<L> &d, ModInvSigned62<L> &e, const ModInvTrans2x2 &t, const ModInvModInfo<L> &info)
+{
+    const int64_t u = t.u, v = t.v, q = t.q, r = t.r;
+    int64_t md, me, sd, se;
+    int128_t cd, ce;
+
+    // md, me start as zero, plus [u, q] if d is negative, plus [v, r] if e is negative
+    sd = d.v[L - 1] >> 63;
+    se = e.v[L - 1] >> 63;
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+    cd = (int128_t)u * d.v[0] + (int128_t)v * e.v[0];
+    ce = (int128_t)q * d.v[0] + (int128_t)r * e.v[0];
+    // Correct md, me so that t * [d, e] + modulus * [md, me] has 62 zero bottom bits
+    md -= (info.modulus_inv62 * (uint64_t)cd + md) & MODINV_M62;
+    me -= (info.modulus_inv62 * (uint64_t)ce + me) & MODINV_M62;
+    cd += (int128_t)info.modulus.v[0] * md;
+    ce += (int128_t)info.modulus.v[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+    for (int i = 1; i < L; i++)
+    {
+        cd += (int128_t)u * d.v[i] + (int128_t)v * e.v[i];
+        ce += (int128_t)q * d.v[i] + (int128_t)r * e.v[i];
+        if (info.modulus.v[i])
+        {
+            cd += (int128_t)info.modulus.v[i] * md;
+            ce += (int128_t)info.modulus.v[i] * me;
+        }
+        d.v[i - 1] = (int64_t)((uint64_t)cd & MODINV_M62);
+        e.v[i - 1] = (int64_t)((uint64_t)ce & MODINV_M62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d.v[L - 1] = (int64_t)cd;
+    e.v[L - 1] = (int64_t)ce;
+}
+
+// Computes (t / 2^62) * [f, g] over the len low limbs of f and g
+template <int L>
+inline void modinv_update_fg_62 (int len, ModInvSigned62<L> &f, ModInvSigned62<L> &g, const ModInvTrans2x2 &t)
+{
+    const int64_t u = t.u, v = t.v, q = t.q, r = t.r;
+    int128_t cf, cg;
+
+    cf = (int128_t)u * f.v[0] + (int128_t)v * g.v[0];
+    cg = (int128_t)q * f.v[0] + (int128_t)r * g.v[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (int i = 1; i < len; i++)
+    {
+        cf += (int128_t)u * f.v[i] + (int128_t)v * g.v[i];
+        cg += (int128_t)q * f.v[i] + (int128_t)r * g.v[i];
+        f.v[i - 1] = (int64_t)((uint64_t)cf & MODINV_M62);
+        g.v[i - 1] = (int64_t)((uint64_t)cg & MODINV_M62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f.v[len - 1] = (int64_t)cf;
+    g.v[len - 1] = (int64_t)cg;
+}
+
+// Variable time version of modinv_divsteps_59, computing the transition matrix and new eta
+// after 62 divsteps, eta = -delta. Runs of zeros at the bottom of g are skipped at once, and up
+// to 6 (eta < 0) or 4 bits of g are cancelled with a single multiple of f. The matrix is scaled
+// by 2^62.
+inline int64_t modinv_divsteps_62_var (int64_t eta, uint64_t f0, uint64_t g0, ModInvTrans2x2 &t)
+{
+    uint64_t u = 1, v = 0, q = 0, r = 1;
+    uint64_t f = f0, g = g0, m, w;
+    int i = 62, limit, zeros;
+
+    for (;;)
+    {
+        // Divide g by two as many times as it has zeros at the bottom, the sentinel bit limits
+        // the zeros to the divsteps left
+        zeros = __builtin_ctzll(g | (UINT64_MAX << i));
+        g >>= zeros;
+        u <<= zeros;
+        v <<= zeros;
+        eta -= zeros;
+        i -= zeros;
+        if (i == 0) break;
+
+        // f and g are odd here. If eta is negative, negate it and replace f, g with g, -f
+        if (eta < 0)
+        {
+            uint64_t tmp;
+            eta = -eta;
+            tmp = f; f = g; g = -tmp;
+            tmp = u; u = q; q = -tmp;
+            tmp = v; v = r; r = -tmp;
+            // Cancel up to min(eta + 1, i, 6) bits of g
+            limit = ((int)eta + 1) > i ? i : ((int)eta + 1);
+            m = (UINT64_MAX >> (64 - limit)) & 63U;
+            w = (f * g * (f * f - 2)) & m;
+        }
+        else
+        {
+            // Cancel up to min(eta + 1, i, 4) bits of g, eta tends to be smaller here
+            limit = ((int)eta + 1) > i ? i : ((int)eta + 1);
+            m = (UINT64_MAX >> (64 - limit)) & 15U;
+            w = f + (((f + 1) & 4) << 1);
+            w = (-w * g) & m;
+        }
+        g += f * w;
+        q += u * w;
+        r += v * w;
+    }
+    t.u = (int64_t)u;
+    t.v = (int64_t)v;
+    t.q = (int64_t)q;
+    t.r = (int64_t)r;
+    return eta;
+}
+
+// Brings r from range (-2 * modulus, modulus) to [0, modulus), negating it if sign < 0
+template <int L>
+inline void modinv_normalize_62 (ModInvSigned62<L> &r, int64_t sign, const ModInvModInfo<L> &info)
+{
+    const int64_t M62 = (int64_t)MODINV_M62;
+    int64_t cond_add, cond_negate;
+
+    // Add the modulus if negative and negate if requested, range (-modulus, modulus)
+    cond_add = modinv_barrier(r.v[L - 1] >> 63);
+    for (int i = 0; i < L; i++) r.v[i] += info.modulus.v[i] & cond_add;
+    cond_negate = modinv_barrier(sign >> 63);
+    for (int i = 0; i < L; i++) r.v[i] = (r.v[i] ^ cond_negate) - cond_negate;
+    for (int i = 0; i < L - 1; i++)
+    {
+        r.v[i + 1] += r.v[i] >> 62;
+        r.v[i] &= M62;
+    }
+
+    // Add the modulus again if still negative, range [0, modulus)
+    cond_add = modinv_barrier(r.v[L - 1] >> 63);
+    for (int i = 0; i < L; i++) r.v[i] += info.modulus.v[i] & cond_add;
+    for (int i = 0; i < L - 1; i++)
+    {
+        r.v[i + 1] += r.v[i] >> 62;
+        r.v[i] &= M62;
+    }
+}
+
+// Computes x = x^-1 mod modulus, with 0 <= x < modulus. If x is zero, returns zero.
+template <int L, int ITERATIONS>
+inline void modinv (ModInvSigned62<L> &x, const ModInvModInfo<L> &info)
+{
+    ModInvSigned62<L> d = {{0}};
+    ModInvSigned62<L> e = {{1}};
+    ModInvSigned62<L> f = info.modulus;
+    ModInvSigned62<L> g = x;
+    int64_t zeta = -1; // delta starts at 1/2
+
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        ModInvTrans2x2 t;
+        zeta = modinv_divsteps_59(zeta, f.v[0], g.v[0], t);
+        modinv_update_de_62<L>(d, e, t, info);
+        modinv_update_fg_62<L>(L, f, g, t);
+    }
+
+    // g reached 0 and f = +/-1 (gcd), d is +/- the inverse
+    modinv_normalize_62<L>(d, f.v[L - 1], info);
+    x = d;
+}
+
+// Computes r = a^-1 mod modulus over N64 unsigned limbs of 64 bits, a and r can overlap
+template <int N64, int L, int ITERATIONS>
+inline void modinv_u64 (uint64_t * r, const uint64_t * a, const ModInvModInfo<L> &info)
+{
+    ModInvSigned62<L> x;
+    modinv_from_u64<N64, L>(a, x);
+    modinv<L, ITERATIONS>(x, info);
+    modinv_to_u64<N64, L>(x, r);
+}
+
+// Variable time version of modinv, for values that are not secret. Stops as soon as g reaches
+// 0, and drops the top limbs of f and g once both of them are 0 or -1
+template <int L>
+inline void modinv_var (ModInvSigned62<L> &x, const ModInvModInfo<L> &info)
+{
+    ModInvSigned62<L> d = {{0}};
+    ModInvSigned62<L> e = {{1}};
+    ModInvSigned62<L> f = info.modulus;
+    ModInvSigned62<L> g = x;
+    int len = L;
+    int64_t eta = -1; // eta = -delta, delta starts at 1
+    int64_t cond, fn, gn;
+
+    for (;;)
+    {
+        ModInvTrans2x2 t;
+        eta = modinv_divsteps_62_var(eta, f.v[0], g.v[0], t);
+        modinv_update_de_62<L>(d, e, t, info);
+        modinv_update_fg_62<L>(len, f, g, t);
+
+        // Done when g is zero, only possible if its bottom limb is zero
+        if (g.v[0] == 0)
+        {
+            cond = 0;
+            for (int j = 1; j < len; j++) cond |= g.v[j];
+            if (cond == 0) break;
+        }
+
+        // If len > 1 and the top limbs of f and g are both 0 or -1, move their sign to the limb
+        // below and drop them
+        fn = f.v[len - 1];
+        gn = g.v[len - 1];
+        cond = ((int64_t)len - 2) >> 63;
+        cond |= fn ^ (fn >> 63);
+        cond |= gn ^ (gn >> 63);
+        if (cond == 0)
+        {
+            f.v[len - 2] |= (uint64_t)fn << 62;
+            g.v[len - 2] |= (uint64_t)gn << 62;
+            len--;
+        }
+    }
+
+    // f = +/-1 (gcd), d is +/- the inverse
+    modinv_normalize_62<L>(d, f.v[len - 1], info);
+    x = d;
+}
+
+// Variable time version of modinv_u64
+template <int N64, int L>
+inline void modinv_var_u64 (uint64_t * r, const uint64_t * a, const ModInvModInfo<L> &info)
+{
+    ModInvSigned62<L> x;
+    modinv_from_u64<N64, L>(a, x);
+    modinv_var<L>(x, info);
+    modinv_to_u64<N64, L>(x, r);
+}
+
+#endif
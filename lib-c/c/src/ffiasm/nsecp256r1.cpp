@@ -1,4 +1,5 @@
 #include "nsecp256r1.hpp"
+#include "modinv.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <gmp.h>
@@ -232,18 +233,15 @@ std::string RawnSecp256r1::toString(const Element &a, uint32_t radix) {
     return resS;
 }
 
-void RawnSecp256r1::inv(Element &r, const Element &a) {
-    mpz_t mr;
-    mpz_init(mr);
-    mpz_import(mr, nSecp256r1_N64, -1, 8, -1, 0, (const void *)(a.v));
-    mpz_invert(mr, mr, q);
-
-
-    for (int i=0; i<nSecp256r1_N64; i++) r.v[i] = 0;
-    mpz_export((void *)(r.v), NULL, -1, 8, -1, 0, mr);
+// Modulus of the field as signed limbs of 62 bits, for the safegcd inversion. The field values
+// are not secret, so the variable time version is used
+static const ModInvModInfo<5> modinv_info = modinv_modinfo<nSecp256r1_N64, 5>(nSecp256r1_rawq);
 
+void RawnSecp256r1::inv(Element &r, const Element &a) {
+    // a is in Montgomery form (a*R), its raw inverse is (a*R)^-1, and the Montgomery
+    // multiplication by R^3 returns a^-1*R
+    modinv_var_u64<nSecp256r1_N64, 5>(r.v, a.v, modinv_info);
     nSecp256r1_rawMMul(r.v, r.v,nSecp256r1_rawR3);
-    mpz_clear(mr);
 }
 
 void RawnSecp256r1::div(Element &r, const Element &a, const Element &b) {
@@ -0,0 +1,184 @@
+#include <gmpxx.h>
+#include <string.h>
+#include "field_batch.hpp"
+#include "field_batch_ifma.hpp"
+#include "../common/utils.hpp"
+#include "../common/globals.hpp"
+#include "../ffiasm/fec.hpp"
+#include "../ffiasm/fq.hpp"
+#include "../ffiasm/bls12_381_384.hpp"
+#include <stdint.h>
+#include <atomic>
+
+/************************/
+/* FIELD BATCH DISPATCH */
+/************************/
+
+// Atomic, since it can be changed while other threads are running batches
+static std::atomic<bool> ifmaEnabled(true);
+
+static bool ifmaSupported (void)
+{
+    static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+    return supported;
+}
+
+int FieldBatchIfmaSupported (void)
+{
+    return (ifmaEnabled.load(std::memory_order_relaxed) && ifmaSupported()) ? 1 : 0;
+}
+
+void FieldBatchIfmaEnable (const uint64_t enable)
+{
+    ifmaEnabled.store(enable != 0, std::memory_order_relaxed);
+}
+
+// Splits value into n52 limbs of 52 bits
+static void split52 (const mpz_class &value, uint64_t * r, uint64_t n52)
+{
+    mpz_class v = value;
+    for (uint64_t j = 0; j < n52; j++)
+    {
+        r[j] = v.get_ui() & IFMA_MASK52;
+        v >>= 52;
+    }
+}
+
+// Builds the IFMA parameters of the field with prime q, given as N64 u64 LE
+template <int N64, int N52>
+static IfmaFieldParams<N64, N52> ifmaFieldParams (const uint64_t * q)
+{
+    IfmaFieldParams<N64, N52> params;
+    mpz_class p;
+    mpz_import(p.get_mpz_t(), N64, -1, 8, -1, 0, (const void *)q);
+    split52(p, params.p, N52);
+
+    mpz_class r2 = (mpz_class(1) << (2 * 52 * N52)) % p;
+    split52(r2, params.r2, N52);
+
+    // Newton iteration, each step doubles the correct low bits of the inverse
+    uint64_t inv = q[0];
+    for (int i = 0; i < 5; i++)
+    {
+        inv *= 2 - q[0] * inv;
+    }
+    params.mprime = (0 - inv) & IFMA_MASK52;
+    return params;
+}
+
+// Runs op over n elements on the IFMA kernel, 8 at a time. The last n % 8 elements are
+// copied to a zero padded buffer, so the kernel always works on full vectors
+template <int N64, int N52>
+IFMA_TARGET static void fieldBatchIfma (const IfmaFieldParams<N64, N52> &params, uint64_t op, uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    __m512i va[N52], vb[N52], vr[N52];
+    for (int j = 0; j < N52; j++)
+    {
+        va[j] = vb[j] = vr[j] = _mm512_setzero_si512();
+    }
+    uint64_t ta[8 * N64], tb[8 * N64], tr[8 * N64];
+    for (uint64_t i = 0; i < n; i += 8)
+    {
+        const uint64_t * pa = a + i * N64;
+        const uint64_t * pb = (op == FIELD_BATCH_SQUARE) ? pa : b + i * N64;
+        uint64_t * pr = r + i * N64;
+        const uint64_t lanes = (n - i) < 8 ? (n - i) : 8;
+        if (lanes < 8)
+        {
+            memset(ta, 0, sizeof(ta));
+            memset(tb, 0, sizeof(tb));
+            memcpy(ta, pa, lanes * N64 * sizeof(uint64_t));
+            memcpy(tb, pb, lanes * N64 * sizeof(uint64_t));
+            pa = ta;
+            pb = tb;
+            pr = tr;
+        }
+
+        ifmaLoad8<N64, N52>(pa, va);
+        ifmaLoad8<N64, N52>(pb, vb);
+        if (op == FIELD_BATCH_ADD)
+        {
+            ifmaAdd<N64, N52>(vr, va, vb, params);
+        }
+        else
+        {
+            ifmaMul<N64, N52>(vr, va, vb, params);
+        }
+        ifmaStore8<N64, N52>(vr, pr);
+
+        if (lanes < 8)
+        {
+            memcpy(r + i * N64, tr, lanes * N64 * sizeof(uint64_t));
+        }
+    }
+}
+
+// Runs op over n elements on the scalar ffiasm field, one at a time
+template <class Field>
+static void fieldBatchScalar (Field &field, uint64_t op, uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    const uint64_t n64 = sizeof(typename Field::Element) / sizeof(uint64_t);
+    typename Field::Element fa, fb, fr;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        array2fe(a + i * n64, fa);
+        if (op == FIELD_BATCH_SQUARE)
+        {
+            field.square(fr, fa);
+        }
+        else
+        {
+            array2fe(b + i * n64, fb);
+            if (op == FIELD_BATCH_ADD)
+            {
+                field.add(fr, fa, fb);
+            }
+            else
+            {
+                field.mul(fr, fa, fb);
+            }
+        }
+        fe2array(fr, r + i * n64);
+    }
+}
+
+template <class Field, int N64, int N52>
+static int fieldBatch (Field &field, const IfmaFieldParams<N64, N52> &params, uint64_t op, uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    if ((op != FIELD_BATCH_ADD) && (op != FIELD_BATCH_MUL) && (op != FIELD_BATCH_SQUARE))
+    {
+        printf("FieldBatch() got unsupported op=%lu\n", op);
+        return -1;
+    }
+    if (FieldBatchIfmaSupported())
+    {
+        fieldBatchIfma<N64, N52>(params, op, n, a, b, r);
+    }
+    else
+    {
+        fieldBatchScalar(field, op, n, a, b, r);
+    }
+    return 0;
+}
+
+/*************************/
+/* FIELD BATCH FUNCTIONS */
+/*************************/
+
+int Secp256k1FpBatch (const uint64_t op, const uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    static const IfmaFieldParams<4, 5> params = ifmaFieldParams<4, 5>(Fec_rawq);
+    return fieldBatch(fec, params, op, n, a, b, r);
+}
+
+int BN254FpBatch (const uint64_t op, const uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    static const IfmaFieldParams<4, 5> params = ifmaFieldParams<4, 5>(Fq_rawq);
+    return fieldBatch(bn254, params, op, n, a, b, r);
+}
+
+int BLS12_381FpBatch (const uint64_t op, const uint64_t n, const uint64_t * a, const uint64_t * b, uint64_t * r)
+{
+    static const IfmaFieldParams<6, 8> params = ifmaFieldParams<6, 8>(BLS12_381_384_rawq);
+    return fieldBatch(bls12_381, params, op, n, a, b, r);
+}
@@ -0,0 +1,65 @@
+#ifndef FIELD_BATCH_HPP
+#define FIELD_BATCH_HPP
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Operations supported by the field batch functions
+#define FIELD_BATCH_ADD 0
+#define FIELD_BATCH_MUL 1
+#define FIELD_BATCH_SQUARE 2
+
+/************************/
+/* Field batch dispatch */
+/************************/
+
+// Returns 1 if the field batch functions run on the AVX-512 IFMA kernel, 0 if they run on the
+// scalar ffiasm fields
+int FieldBatchIfmaSupported (void);
+
+// Enables (1) or disables (0) the AVX-512 IFMA kernel, if supported by the CPU. Enabled by
+// default, disabling it is only useful to compare both paths
+void FieldBatchIfmaEnable (
+    const uint64_t enable
+);
+
+/*************************/
+/* Field batch functions */
+/*************************/
+
+// Computes r[i] = a[i] op b[i] for n elements of the field in u64 LE format, all of them lower
+// than the prime. When op is FIELD_BATCH_SQUARE b is not used and can be null.
+// Returns -1 if op is not supported, 0 otherwise.
+
+int Secp256k1FpBatch (
+    const uint64_t op,
+    const uint64_t n,
+    const uint64_t * a, // n x 4 x 64 bits
+    const uint64_t * b, // n x 4 x 64 bits
+    uint64_t * r  // n x 4 x 64 bits
+);
+
+int BN254FpBatch (
+    const uint64_t op,
+    const uint64_t n,
+    const uint64_t * a, // n x 4 x 64 bits
+    const uint64_t * b, // n x 4 x 64 bits
+    uint64_t * r  // n x 4 x 64 bits
+);
+
+int BLS12_381FpBatch (
+    const uint64_t op,
+    const uint64_t n,
+    const uint64_t * a, // n x 6 x 64 bits
+    const uint64_t * b, // n x 6 x 64 bits
+    uint64_t * r  // n x 6 x 64 bits
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef FIELD_BATCH_IFMA_HPP
+#define FIELD_BATCH_IFMA_HPP
+
+#include <stdint.h>
+#include <immintrin.h>
+
+// Montgomery arithmetic over 8 independent field elements at once, using the AVX-512 IFMA
+// instructions (vpmadd52luq, vpmadd52huq). Each element is split into N52 limbs of 52 bits,
+// and limb j of the 8 elements is stored in one 512-bit vector (lane k = element k), so every
+// instruction works on the same limb of 8 different elements.
+// The modulus must be lower than 2^(52*N52-1), so that 2p < R = 2^(52*N52).
+// The functions are compiled for avx512f+avx512ifma only, and must not be called unless the
+// CPU supports them (see FieldBatchIfmaSupported).
+
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+#define IFMA_MASK52 0xFFFFFFFFFFFFFULL
+#define IFMA_ALL_LANES ((__mmask8)0xFF)
+
+// Shifts and gathers take a zero pass-through operand instead of _mm512_undefined_epi32(), used
+// by the unmasked intrinsics of GCC, which warns -Wmaybe-uninitialized once they are inlined.
+// With all lanes selected they generate the same instructions.
+IFMA_TARGET inline __m512i ifmaSrli (__m512i a, unsigned int s)
+{
+    return _mm512_maskz_srli_epi64(IFMA_ALL_LANES, a, s);
+}
+
+IFMA_TARGET inline __m512i ifmaSlli (__m512i a, unsigned int s)
+{
+    return _mm512_maskz_slli_epi64(IFMA_ALL_LANES, a, s);
+}
+
+template <int N64, int N52>
+struct IfmaFieldParams
+{
+    uint64_t p[N52];  // modulus, in 52 bits limbs
+    uint64_t r2[N52]; // R^2 mod p, in 52 bits limbs, to convert to and from Montgomery form
+    uint64_t mprime;  // -p^-1 mod 2^52
+};
+
+// Loads 8 elements of N64 u64 LE, stored consecutively from a, as N52 vectors of 52 bits limbs
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaLoad8 (const uint64_t * a, __m512i * r)
+{
+    const __m512i index = _mm512_setr_epi64(0, N64, 2 * N64, 3 * N64, 4 * N64, 5 * N64, 6 * N64, 7 * N64);
+    const __m512i mask = _mm512_set1_epi64(IFMA_MASK52);
+    __m512i w[N64];
+    for (int k = 0; k < N64; k++)
+    {
+        w[k] = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), IFMA_ALL_LANES, index, (const void *)(a + k), 8);
+    }
+    for (int j = 0; j < N52; j++)
+    {
+        const int k = (52 * j) / 64;
+        const int s = (52 * j) % 64;
+        __m512i limb = (k < N64) ? ifmaSrli(w[k], s) : _mm512_setzero_si512();
+        if ((s > 12) && (k + 1 < N64))
+        {
+            limb = _mm512_or_si512(limb, ifmaSlli(w[k + 1], 64 - s));
+        }
+        r[j] = _mm512_and_si512(limb, mask);
+    }
+}
+
+// Stores N52 vectors of normalized 52 bits limbs as 8 elements of N64 u64 LE from r
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaStore8 (const __m512i * a, uint64_t * r)
+{
+    const __m512i index = _mm512_setr_epi64(0, N64, 2 * N64, 3 * N64, 4 * N64, 5 * N64, 6 * N64, 7 * N64);
+    for (int k = 0; k < N64; k++)
+    {
+        __m512i w = _mm512_setzero_si512();
+        for (int j = 0; j < N52; j++)
+        {
+            const int offset = 52 * j - 64 * k;
+            if ((offset >= 0) && (offset < 64))
+            {
+                w = _mm512_or_si512(w, ifmaSlli(a[j], offset));
+            }
+            else if ((offset < 0) && (offset > -52))
+            {
+                w = _mm512_or_si512(w, ifmaSrli(a[j], -offset));
+            }
+        }
+        _mm512_i64scatter_epi64((void *)(r + k), index, w, 8);
+    }
+}
+
+// Propagates the carries of t so all limbs are lower than 2^52, and subtracts p once if t >= p.
+// The value of t must be lower than 2p
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaNormalize (__m512i * t, const IfmaFieldParams<N64, N52> &params)
+{
+    const __m512i mask = _mm512_set1_epi64(IFMA_MASK52);
+    for (int j = 0; j < N52 - 1; j++)
+    {
+        t[j + 1] = _mm512_add_epi64(t[j + 1], ifmaSrli(t[j], 52));
+        t[j] = _mm512_and_si512(t[j], mask);
+    }
+
+    // d = t - p, the borrow is the sign bit of each limb difference
+    __m512i d[N52];
+    __m512i borrow = _mm512_setzero_si512();
+    for (int j = 0; j < N52; j++)
+    {
+        d[j] = _mm512_sub_epi64(_mm512_sub_epi64(t[j], _mm512_set1_epi64(params.p[j])), borrow);
+        borrow = ifmaSrli(d[j], 63);
+        d[j] = _mm512_and_si512(d[j], mask);
+    }
+    const __mmask8 ge = _mm512_cmpeq_epi64_mask(borrow, _mm512_setzero_si512());
+    for (int j = 0; j < N52; j++)
+    {
+        t[j] = _mm512_mask_blend_epi64(ge, t[j], d[j]);
+    }
+}
+
+// Computes r = a * b * R^-1 mod p (CIOS Montgomery multiplication), a, b lower than p.
+// Limbs are accumulated without carry propagation, each one gets less than 2^54 per
+// iteration, so they never overflow 64 bits for N52 <= 8. r can be a or b
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaMontMul (__m512i * r, const __m512i * a, const __m512i * b, const IfmaFieldParams<N64, N52> &params)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i mprime = _mm512_set1_epi64(params.mprime);
+    __m512i p[N52];
+    __m512i t[N52 + 1];
+    for (int j = 0; j < N52; j++)
+    {
+        p[j] = _mm512_set1_epi64(params.p[j]);
+        t[j] = zero;
+    }
+    t[N52] = zero;
+
+    for (int i = 0; i < N52; i++)
+    {
+        // t += a * b[i]
+        for (int j = 0; j < N52; j++)
+        {
+            t[j] = _mm512_madd52lo_epu64(t[j], a[j], b[i]);
+            t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], a[j], b[i]);
+        }
+
+        // t += m * p, where m makes the lower 52 bits of t zero
+        const __m512i m = _mm512_madd52lo_epu64(zero, t[0], mprime);
+        for (int j = 0; j < N52; j++)
+        {
+            t[j] = _mm512_madd52lo_epu64(t[j], m, p[j]);
+            t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], m, p[j]);
+        }
+
+        // t = t / 2^52
+        t[1] = _mm512_add_epi64(t[1], ifmaSrli(t[0], 52));
+        for (int j = 0; j < N52; j++)
+        {
+            t[j] = t[j + 1];
+        }
+        t[N52] = zero;
+    }
+
+    ifmaNormalize<N64, N52>(t, params);
+    for (int j = 0; j < N52; j++)
+    {
+        r[j] = t[j];
+    }
+}
+
+// Computes r = a + b mod p, a, b lower than p. r can be a or b
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaAdd (__m512i * r, const __m512i * a, const __m512i * b, const IfmaFieldParams<N64, N52> &params)
+{
+    __m512i t[N52];
+    for (int j = 0; j < N52; j++)
+    {
+        t[j] = _mm512_add_epi64(a[j], b[j]);
+    }
+    ifmaNormalize<N64, N52>(t, params);
+    for (int j = 0; j < N52; j++)
+    {
+        r[j] = t[j];
+    }
+}
+
+// Computes r = a * b mod p over 8 elements in normal form, as (a * b * R^-1) * R^2 * R^-1
+template <int N64, int N52>
+IFMA_TARGET inline void ifmaMul (__m512i * r, const __m512i * a, const __m512i * b, const IfmaFieldParams<N64, N52> &params)
+{
+    __m512i r2[N52];
+    for (int j = 0; j < N52; j++)
+    {
+        r2[j] = _mm512_set1_epi64(params.r2[j]);
+    }
+    ifmaMontMul<N64, N52>(r, a, b, params);
+    ifmaMontMul<N64, N52>(r, r, r2, params);
+}
+
+#endif
@@ -5,6 +5,9 @@
 #include <cstring>
 #include <clocale>
 #include <cstdio>
+#include <thread>
+#include <vector>
+#include <atomic>
 
 #include "ec/ec.hpp"
 #include "fcall/fcall.hpp"
@@ -12,9 +15,12 @@
 #include "arith384/arith384.hpp"
 #include "bn254/bn254.hpp"
 #include "bls12_381/bls12_381.hpp"
+#include "secp256r1/secp256r1.hpp"
+#include "field_batch/field_batch.hpp"
 #include "bigint/add256.hpp"
 #include "ffiasm/fec.hpp"
 #include "ffiasm/fnec.hpp"
+#include "ffiasm/modinv.hpp"
 #include "common/utils.hpp"
 
 #define N_TESTS 1000000
@@ -64,6 +70,53 @@ uint64_t TimeDiff(const struct timeval &startTime)
 
 bool verbose = false;
 
+// Compares the conversion of limbs to/from FEC elements (array2fe + fe2array) with the
+// previous round trip through mpz_class (array2scalar + fromMpz, toMpz + scalar2array)
+void array2fe_benchmark(uint64_t *data)
+{
+    try {
+        const uint64_t TEST_SIZE_U64 = 2 * 4;
+        for (uint64_t i = 0; i<N_TESTS; i++)
+        {
+            for (uint64_t j = 0; j < TEST_SIZE_U64; j++) {
+                data[i * TEST_SIZE_U64 + j] = (uint64_t)rand();
+            }
+        }
+
+        struct timeval startTime;
+        gettimeofday(&startTime, NULL);
+        for (uint64_t i = 0; i<N_TESTS; i++)
+        {
+            uint64_t *test_data = data + i * TEST_SIZE_U64;
+            RawFec::Element fe;
+            array2fe(test_data, fe);
+            fe2array(fe, test_data + 4);
+        }
+        uint64_t duration = TimeDiff(startTime);
+        double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+        print_results("array2fe+fe2array", duration, tp);
+
+        gettimeofday(&startTime, NULL);
+        for (uint64_t i = 0; i<N_TESTS; i++)
+        {
+            uint64_t *test_data = data + i * TEST_SIZE_U64;
+            RawFec::Element fe;
+            mpz_class s;
+            array2scalar(test_data, s);
+            fec.fromMpz(fe, s.get_mpz_t());
+            mpz_class r;
+            fec.toMpz(r.get_mpz_t(), fe);
+            scalar2array(r, test_data + 4);
+        }
+        duration = TimeDiff(startTime);
+        tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+        print_results("array2fe+fe2array (mpz)", duration, tp);
+    }
+    catch (const std::exception & e) {
+        printf("array2fe+fe2array           |Exception: %s\n", e.what());
+    }
+}
+
 void secp256k1_add_benchmark(uint64_t *data)
 {
     try {
@@ -235,6 +288,74 @@ void InverseFpEc_benchmark(uint64_t *data)
     } 
 }
 
+// Reference inversion with mpz_invert, as done by the fields before safegcd
+void InverseFpEcMpz_benchmark(uint64_t *data)
+{
+    try {
+        const uint64_t TEST_SIZE_INPUT_U64 = 1 * 4;
+        const uint64_t TEST_SIZE_OUTPUT_U64 = 1 * 4;
+        const uint64_t TEST_SIZE_U64 = TEST_SIZE_INPUT_U64 + TEST_SIZE_OUTPUT_U64;
+        for (uint64_t i = 0; i<N_TESTS; i++)
+        {
+            for (uint64_t j = 0; j < TEST_SIZE_INPUT_U64; j++) {
+                uint64_t value = (uint64_t)rand();
+                data[i * TEST_SIZE_U64 + j] = value;
+            }
+            for (uint64_t j = 0; j < TEST_SIZE_OUTPUT_U64; j++) {
+                data[i * TEST_SIZE_U64 + j + TEST_SIZE_INPUT_U64] = 0;
+            }
+        }
+
+        mpz_class p("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F", 16);
+        struct timeval startTime;
+        gettimeofday(&startTime, NULL);
+        for (uint64_t i = 0; i<N_TESTS; i++)
+        {
+            uint64_t *test_data = data + i * TEST_SIZE_U64;
+            mpz_class a, r;
+            array2scalar(test_data, a);
+            mpz_invert(r.get_mpz_t(), a.get_mpz_t(), p.get_mpz_t());
+            scalar2array(r, test_data + TEST_SIZE_INPUT_U64);
+        }
+        uint64_t duration = TimeDiff(startTime);
+        double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+        print_results("InverseFpEc (mpz)", duration, tp);
+    }
+    catch (const std::exception & e) {
+        printf("InverseFpEc (mpz)           |Exception: %s\n", e.what());
+    }
+}
+
+// Raw safegcd inversions of modinv.hpp over the secp256k1 Fp modulus, constant time and
+// variable time, without the Montgomery conversion of the field. Same inputs as
+// InverseFpEc (mpz)
+template <bool VAR>
+void ModInv_benchmark(uint64_t *data, const char *name)
+{
+    const uint64_t TEST_SIZE_U64 = 2 * 4;
+    for (uint64_t i = 0; i<N_TESTS; i++)
+    {
+        for (uint64_t j = 0; j < 4; j++) {
+            data[i * TEST_SIZE_U64 + j] = (uint64_t)rand();
+            data[i * TEST_SIZE_U64 + j + 4] = 0;
+        }
+    }
+
+    const uint64_t p[4] = { 0xFFFFFFFEFFFFFC2F, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+    const ModInvModInfo<5> info = modinv_modinfo<4, 5>(p);
+    struct timeval startTime;
+    gettimeofday(&startTime, NULL);
+    for (uint64_t i = 0; i<N_TESTS; i++)
+    {
+        uint64_t *test_data = data + i * TEST_SIZE_U64;
+        if (VAR) modinv_var_u64<4, 5>(test_data + 4, test_data, info);
+        else modinv_u64<4, 5, 10>(test_data + 4, test_data, info);
+    }
+    uint64_t duration = TimeDiff(startTime);
+    double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+    print_results(name, duration, tp);
+}
+
 void InverseFnEc_benchmark(uint64_t *data)
 {
     try {
@@ -334,6 +455,71 @@ void BN254CurveAddP_benchmark(uint64_t *data)
     }    
 }
 
+#define BATCH_SIZE 1024
+
+void BN254CurveAddBatchP_benchmark(uint64_t *data)
+{
+    try {
+        // p1, p2 and p3 as separate arrays of N_TESTS points
+        uint64_t *p1 = data;
+        uint64_t *p2 = data + N_TESTS * 8;
+        uint64_t *p3 = data + N_TESTS * 16;
+        for (uint64_t i = 0; i < N_TESTS * 16; i++)
+        {
+            data[i] = (uint64_t)rand();
+        }
+
+        struct timeval startTime;
+        gettimeofday(&startTime, NULL);
+        for (uint64_t i = 0; i < N_TESTS; i += BATCH_SIZE)
+        {
+            uint64_t n = (N_TESTS - i) < BATCH_SIZE ? (N_TESTS - i) : BATCH_SIZE;
+            BN254CurveAddBatchP(n, p1 + i * 8, p2 + i * 8, p3 + i * 8);
+        }
+        uint64_t duration = TimeDiff(startTime);
+        double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+        print_results("BN254CurveAddBatchP", duration, tp);
+    }
+    catch (const std::exception & e) {
+        printf("BN254CurveAddBatchP         |Exception: %s\n", e.what());
+    }
+}
+
+// Multiplications of N_TESTS independent field elements, on the IFMA kernel and on the scalar
+// fields, throughput in lanes (elements) per microsecond
+typedef int (*FieldBatchFunc)(const uint64_t, const uint64_t, const uint64_t *, const uint64_t *, uint64_t *);
+
+void FieldBatchMul_benchmark(uint64_t *data, FieldBatchFunc func, uint64_t n64, const char *name)
+{
+    try {
+        uint64_t *a = data;
+        uint64_t *b = data + N_TESTS * n64;
+        uint64_t *r = data + N_TESTS * 2 * n64;
+        for (uint64_t i = 0; i < N_TESTS * 2 * n64; i++)
+        {
+            data[i] = (uint64_t)rand();
+        }
+
+        for (uint64_t ifma = 0; ifma < 2; ifma++)
+        {
+            FieldBatchIfmaEnable(ifma);
+            if (ifma && !FieldBatchIfmaSupported()) break;
+            struct timeval startTime;
+            gettimeofday(&startTime, NULL);
+            func(FIELD_BATCH_MUL, N_TESTS, a, b, r);
+            uint64_t duration = TimeDiff(startTime);
+            double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+            char label[64];
+            snprintf(label, sizeof(label), "%s (%s)", name, ifma ? "ifma" : "scalar");
+            print_results(label, duration, tp);
+        }
+        FieldBatchIfmaEnable(1);
+    }
+    catch (const std::exception & e) {
+        printf("%-28s|Exception: %s\n", name, e.what());
+    }
+}
+
 void BN254CurveDblP_benchmark(uint64_t *data) 
 {
     try {
@@ -591,6 +777,10 @@ void BN254TwistDblLineCoeffs_benchmark(uint64_t *data)
     }
 }
 
+typedef int (*Arith256ModFunc)(const uint64_t *, const uint64_t *, const uint64_t *, const uint64_t *, uint64_t *);
+typedef int (*Arith384Func)(const uint64_t *, const uint64_t *, const uint64_t *, uint64_t *, uint64_t *);
+typedef int (*Arith384ModFunc)(const uint64_t *, const uint64_t *, const uint64_t *, const uint64_t *, uint64_t *);
+
 void Arith256_benchmark(uint64_t *data) {
     try {
         const uint64_t TEST_SIZE_INPUT_U64 = 3 * 4;
@@ -656,7 +846,7 @@ void FastArith256_benchmark(uint64_t *data) {
     }
 }
 
-void Arith256Mod_benchmark(uint64_t *data) {
+void Arith256Mod_benchmark(uint64_t *data, Arith256ModFunc func, const char *name) {
     try {
         const uint64_t TEST_SIZE_INPUT_U64 = 4 * 4;
         const uint64_t TEST_SIZE_OUTPUT_U64 = 1 * 4;
@@ -676,18 +866,18 @@ void Arith256Mod_benchmark(uint64_t *data) {
         for (uint64_t i = 0; i<N_TESTS; i++)
         {
             uint64_t *test_data = data + i * TEST_SIZE_U64;
-            Arith256Mod(test_data, test_data + 4, test_data + 8, test_data + 12, test_data + 16);
+            func(test_data, test_data + 4, test_data + 8, test_data + 12, test_data + 16);
         }
         uint64_t duration = TimeDiff(startTime);
         double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
-        print_results("Arith256Mod", duration, tp);
+        print_results(name, duration, tp);
     }
     catch (const std::exception & e) {
-        printf("Arith256Mod                 |Exception: %s\n", e.what());
+        printf("%-28s|Exception: %s\n", name, e.what());
     }
 }
 
-void Arith384_benchmark(uint64_t *data) {
+void Arith384_benchmark(uint64_t *data, Arith384Func func, const char *name) {
     try {
         const uint64_t TEST_SIZE_INPUT_U64 = 3 * 6;
         const uint64_t TEST_SIZE_OUTPUT_U64 = 2 * 6;
@@ -707,20 +897,20 @@ void Arith384_benchmark(uint64_t *data) {
         for (uint64_t i = 0; i<N_TESTS; i++)
         {
             uint64_t *test_data = data + i * TEST_SIZE_U64;
-            Arith384(test_data, test_data + 6, test_data + 12, test_data + 18, test_data + 24);
+            func(test_data, test_data + 6, test_data + 12, test_data + 18, test_data + 24);
         }
 
         uint64_t duration = TimeDiff(startTime);
         double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
-        print_results("Arith384", duration, tp);
+        print_results(name, duration, tp);
     }
     catch (const std::exception & e) {
-        printf("Arith384                    |Exception: %s\n", e.what());
+        printf("%-28s|Exception: %s\n", name, e.what());
     }
     
 }
 
-void Arith384Mod_benchmark(uint64_t *data) {
+void Arith384Mod_benchmark(uint64_t *data, Arith384ModFunc func, const char *name) {
     try {
         const uint64_t TEST_SIZE_INPUT_U64 = 4 * 6;
         const uint64_t TEST_SIZE_OUTPUT_U64 = 1 * 6;
@@ -740,14 +930,14 @@ void Arith384Mod_benchmark(uint64_t *data) {
         for (uint64_t i = 0; i<N_TESTS; i++)
         {
             uint64_t *test_data = data + i * TEST_SIZE_U64;
-            Arith384Mod(test_data, test_data + 6, test_data + 12, test_data + 18, test_data + 24);
+            func(test_data, test_data + 6, test_data + 12, test_data + 18, test_data + 24);
         }
         uint64_t duration = TimeDiff(startTime);
         double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
-        print_results("Arith384Mod", duration, tp);
+        print_results(name, duration, tp);
     }
     catch (const std::exception & e) {
-        printf("Arith384Mod                 |Exception: %s\n", e.what());
+        printf("%-28s|Exception: %s\n", name, e.what());
     }
 }
 
@@ -1230,6 +1420,989 @@ void BN254TwistDblLineCoeffs_test()
     }
 }
 
+#define N_DIFF_TESTS 1000000
+
+// Random limb biased to edge values (0, 1, all ones), to test carries and modules with
+// leading zero limbs
+uint64_t random_limb()
+{
+    switch (rand() % 8)
+    {
+        case 0: return 0;
+        case 1: return 1;
+        case 2: return 0xFFFFFFFFFFFFFFFF;
+        default: return ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+    }
+}
+
+void random_limbs(uint64_t *a, uint64_t count)
+{
+    // all limbs random or only the lower ones
+    uint64_t limbs = (rand() % 4) ? count : 1 + rand() % count;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        a[i] = i < limbs ? random_limb() : 0;
+    }
+}
+
+bool compare_limbs(const char *name, uint64_t i, const uint64_t *result, const uint64_t *expected, uint64_t count)
+{
+    if (memcmp(result, expected, count * sizeof(uint64_t)) == 0) return true;
+    printf("ERROR! %s() returned unexpected result on test %lu\n", name, i);
+    for (uint64_t j = 0; j < count; j++)
+    {
+        printf("  [%lu] 0x%016lx expected 0x%016lx\n", j, result[j], expected[j]);
+    }
+    return false;
+}
+
+// Differential test of GMP-free Arith256Mod against GMP
+void Arith256Mod_test()
+{
+    uint64_t a[4], b[4], c[4], module[4], d[4], expected[4];
+    for (uint64_t i = 0; i < N_DIFF_TESTS; i++)
+    {
+        random_limbs(a, 4);
+        random_limbs(b, 4);
+        random_limbs(c, 4);
+        do {
+            random_limbs(module, 4);
+        } while ((module[0] | module[1] | module[2] | module[3]) == 0);
+        Arith256Mod(a, b, c, module, d);
+        Arith256ModGmp(a, b, c, module, expected);
+        if (!compare_limbs("Arith256Mod", i, d, expected, 4)) return;
+    }
+    if (verbose) printf("Arith256Mod() succeeded\n");
+}
+
+// Differential test of GMP-free Arith384 against GMP
+void Arith384_test()
+{
+    uint64_t a[6], b[6], c[6], d[12], expected[12];
+    for (uint64_t i = 0; i < N_DIFF_TESTS; i++)
+    {
+        random_limbs(a, 6);
+        random_limbs(b, 6);
+        random_limbs(c, 6);
+        Arith384(a, b, c, d, d + 6);
+        Arith384Gmp(a, b, c, expected, expected + 6);
+        if (!compare_limbs("Arith384", i, d, expected, 12)) return;
+    }
+    if (verbose) printf("Arith384() succeeded\n");
+}
+
+// Differential test of GMP-free Arith384Mod against GMP
+void Arith384Mod_test()
+{
+    uint64_t a[6], b[6], c[6], module[6], d[6], expected[6];
+    for (uint64_t i = 0; i < N_DIFF_TESTS; i++)
+    {
+        random_limbs(a, 6);
+        random_limbs(b, 6);
+        random_limbs(c, 6);
+        do {
+            random_limbs(module, 6);
+        } while ((module[0] | module[1] | module[2] | module[3] | module[4] | module[5]) == 0);
+        Arith384Mod(a, b, c, module, d);
+        Arith384ModGmp(a, b, c, module, expected);
+        if (!compare_limbs("Arith384Mod", i, d, expected, 6)) return;
+    }
+    if (verbose) printf("Arith384Mod() succeeded\n");
+}
+
+// Differential test of the safegcd inversion of each field (fcall hints) against mpz_invert
+typedef int (*InverseFunc)(const uint64_t *, uint64_t *);
+
+bool Inverse_test(const char *name, InverseFunc func, const char *modulus, uint64_t n64)
+{
+    mpz_class p(modulus, 16);
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 10; i++)
+    {
+        uint64_t a[6] = {0}, r[6] = {0}, expected[6] = {0};
+        mpz_class sa;
+        switch (i % 4)
+        {
+            case 0: sa = i + 1; break;
+            case 1: sa = p - 1 - i; break;
+            default:
+                random_limbs(a, n64);
+                mpz_import(sa.get_mpz_t(), n64, -1, 8, -1, 0, (const void *)a);
+                sa %= p;
+                if (sa == 0) sa = 1;
+        }
+        memset(a, 0, sizeof(a));
+        mpz_export((void *)a, NULL, -1, 8, -1, 0, sa.get_mpz_t());
+        mpz_class sr;
+        mpz_invert(sr.get_mpz_t(), sa.get_mpz_t(), p.get_mpz_t());
+        mpz_export((void *)expected, NULL, -1, 8, -1, 0, sr.get_mpz_t());
+        func(a, r);
+        if (!compare_limbs(name, i, r, expected, n64)) return false;
+    }
+    if (verbose) printf("%s() succeeded\n", name);
+    return true;
+}
+
+void Inverse_test()
+{
+    Inverse_test("InverseFpEc", InverseFpEc, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F", 4);
+    Inverse_test("InverseFnEc", InverseFnEc, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141", 4);
+    Inverse_test("BN254FpInv", BN254FpInv, "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47", 4);
+    Inverse_test("BLS12_381FpInv", BLS12_381FpInv, "1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab", 6);
+    Inverse_test("Secp256r1FpInv", Secp256r1FpInv, "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff", 4);
+    Inverse_test("Secp256r1FnInv", Secp256r1FnInv, "ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551", 4);
+}
+
+// Differential test of the constant time and the variable time safegcd inversions against
+// mpz_invert, including zero, whose inverse is returned as zero
+template <int N64, int L, int ITERATIONS>
+bool ModInv_test(const char *name, const char *modulus)
+{
+    mpz_class p(modulus, 16);
+    uint64_t q[N64] = {0};
+    mpz_export((void *)q, NULL, -1, 8, -1, 0, p.get_mpz_t());
+    const ModInvModInfo<L> info = modinv_modinfo<N64, L>(q);
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 10; i++)
+    {
+        uint64_t a[N64] = {0}, r[N64], expected[N64] = {0};
+        mpz_class sa;
+        switch (i % 4)
+        {
+            case 0: sa = i; break;
+            case 1: sa = p - 1 - i; break;
+            default:
+                random_limbs(a, N64);
+                mpz_import(sa.get_mpz_t(), N64, -1, 8, -1, 0, (const void *)a);
+                sa %= p;
+        }
+        memset(a, 0, sizeof(a));
+        mpz_export((void *)a, NULL, -1, 8, -1, 0, sa.get_mpz_t());
+        if (sa != 0)
+        {
+            mpz_class sr;
+            mpz_invert(sr.get_mpz_t(), sa.get_mpz_t(), p.get_mpz_t());
+            mpz_export((void *)expected, NULL, -1, 8, -1, 0, sr.get_mpz_t());
+        }
+        modinv_u64<N64, L, ITERATIONS>(r, a, info);
+        if (!compare_limbs(name, i, r, expected, N64)) return false;
+        modinv_var_u64<N64, L>(r, a, info);
+        if (!compare_limbs(name, i, r, expected, N64)) return false;
+    }
+    if (verbose) printf("%s() succeeded\n", name);
+    return true;
+}
+
+void ModInv_test()
+{
+    ModInv_test<4, 5, 10>("modinv secp256k1 Fp", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
+    ModInv_test<4, 5, 10>("modinv secp256k1 Fn", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141");
+    ModInv_test<4, 5, 10>("modinv BN254 Fq", "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47");
+    ModInv_test<6, 7, 15>("modinv BLS12_381 Fp", "1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab");
+    ModInv_test<4, 5, 10>("modinv secp256r1 Fp", "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff");
+    ModInv_test<4, 5, 10>("modinv secp256r1 Fn", "ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551");
+}
+
+// Reference square root on GMP, for p = 3 mod 4: r = a^((p+1)/4) if a is a quadratic residue,
+// otherwise r = (a * nqr)^((p+1)/4). Returns if a (unreduced) is a quadratic residue
+bool SqrtGmp(const uint64_t *a, uint64_t n64, const mpz_class &p, uint64_t nqr, uint64_t *r)
+{
+    mpz_class sa, sr, e = (p + 1) / 4;
+    mpz_import(sa.get_mpz_t(), n64, -1, 8, -1, 0, (const void *)a);
+    mpz_powm(sr.get_mpz_t(), sa.get_mpz_t(), e.get_mpz_t(), p.get_mpz_t());
+    bool exists = ((sr * sr) % p) == sa;
+    if (!exists)
+    {
+        mpz_class sa_nqr = (sa * nqr) % p;
+        mpz_powm(sr.get_mpz_t(), sa_nqr.get_mpz_t(), e.get_mpz_t(), p.get_mpz_t());
+    }
+    memset(r, 0, n64 * sizeof(uint64_t));
+    mpz_export((void *)r, NULL, -1, 8, -1, 0, sr.get_mpz_t());
+    return exists;
+}
+
+// Random input for the square root tests: squares, random values, values over p and edge cases
+void sqrt_test_input(uint64_t i, const mpz_class &p, uint64_t n64, uint64_t *a)
+{
+    mpz_class sa;
+    switch (i % 5)
+    {
+        case 0: sa = i / 5; break;
+        case 1: sa = p - 1 - i / 5; break;
+        case 2: sa = p + i / 5; break;
+        default:
+            random_limbs(a, n64);
+            mpz_import(sa.get_mpz_t(), n64, -1, 8, -1, 0, (const void *)a);
+            sa %= p;
+            if (i % 5 == 3) sa = (sa * sa) % p;
+    }
+    memset(a, 0, n64 * sizeof(uint64_t));
+    mpz_export((void *)a, NULL, -1, 8, -1, 0, sa.get_mpz_t());
+}
+
+// Differential test of a 4 limbs square root with parity (p = 3 mod 4, nqr = 3) against mpz_powm
+typedef int (*SqrtParityFunc)(const uint64_t *, const uint64_t, uint64_t *);
+
+bool SqrtParity_test(const char *name, SqrtParityFunc func, const char *prime)
+{
+    mpz_class p(prime, 16);
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 10; i++)
+    {
+        uint64_t a[4], r[5], expected[5];
+        sqrt_test_input(i, p, 4, a);
+        uint64_t parity = (i / 5) & 1;
+        expected[0] = SqrtGmp(a, 4, p, 3, expected + 1);
+        if (((expected[1] & 1) != parity) && (expected[1] | expected[2] | expected[3] | expected[4]))
+        {
+            mpz_class sr;
+            mpz_import(sr.get_mpz_t(), 4, -1, 8, -1, 0, (const void *)(expected + 1));
+            sr = p - sr;
+            memset(expected + 1, 0, 4 * sizeof(uint64_t));
+            mpz_export((void *)(expected + 1), NULL, -1, 8, -1, 0, sr.get_mpz_t());
+        }
+        func(a, parity, r);
+        if (!compare_limbs(name, i, r, expected, 5)) return false;
+    }
+    if (verbose) printf("%s() succeeded\n", name);
+    return true;
+}
+
+// Differential test of the addition chain square roots against mpz_powm
+void Sqrt_test()
+{
+    SqrtParity_test("SqrtFpEcParity", SqrtFpEcParity, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
+    SqrtParity_test("Secp256r1FpSqrt", Secp256r1FpSqrt, "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff");
+
+    mpz_class p("1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab", 16);
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 10; i++)
+    {
+        uint64_t a[6], r[7], expected[7];
+        sqrt_test_input(i, p, 6, a);
+        expected[0] = SqrtGmp(a, 6, p, 2, expected + 1);
+        BLS12_381FpSqrt(a, r);
+        if (!compare_limbs("BLS12_381FpSqrt", i, r, expected, 7)) return;
+    }
+    if (verbose) printf("BLS12_381FpSqrt() succeeded\n");
+}
+
+// Test of the batch curve operations against the single operations, including operations
+// with a zero denominator (x1 == x2 or y1 == 0) in the middle of the batch
+typedef int (*CurveAddFunc)(const uint64_t *, const uint64_t *, uint64_t *);
+typedef int (*CurveAddBatchFunc)(uint64_t, const uint64_t *, const uint64_t *, uint64_t *);
+typedef int (*CurveDblFunc)(const uint64_t *, uint64_t *);
+typedef int (*CurveDblBatchFunc)(uint64_t, const uint64_t *, uint64_t *);
+
+int AddPointEcAddP(const uint64_t *p1, const uint64_t *p2, uint64_t *p3) { return AddPointEcP(0, p1, p2, p3); }
+int AddPointEcAddBatchP(uint64_t n, const uint64_t *p1, const uint64_t *p2, uint64_t *p3) { return AddPointEcBatchP(0, n, p1, p2, p3); }
+int AddPointEcDblP(const uint64_t *p1, uint64_t *p2) { return AddPointEcP(1, p1, NULL, p2); }
+int AddPointEcDblBatchP(uint64_t n, const uint64_t *p1, uint64_t *p2) { return AddPointEcBatchP(1, n, p1, NULL, p2); }
+
+bool CurveBatch_test(const char *name, uint64_t n64, CurveAddFunc add, CurveAddBatchFunc add_batch, CurveDblFunc dbl, CurveDblBatchFunc dbl_batch)
+{
+    const uint64_t n = 100;
+    const uint64_t size = 2 * n64;
+    uint64_t p1[n * 12], p2[n * 12], p3[n * 12], expected[n * 12];
+    for (uint64_t i = 0; i < n * size; i++)
+    {
+        // values lower than any of the primes
+        p1[i] = (i % n64) == (n64 - 1) ? random_limb() >> 8 : random_limb();
+        p2[i] = (i % n64) == (n64 - 1) ? random_limb() >> 8 : random_limb();
+    }
+    memcpy(p2 + 17 * size, p1 + 17 * size, n64 * sizeof(uint64_t));
+    memset(p1 + 42 * size + n64, 0, n64 * sizeof(uint64_t));
+
+    int expected_result = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        if (add(p1 + i * size, p2 + i * size, expected + i * size) != 0)
+        {
+            memset(expected + i * size, 0, size * sizeof(uint64_t));
+            expected_result = -1;
+        }
+    }
+    int result = add_batch(n, p1, p2, p3);
+    if (result != expected_result)
+    {
+        printf("ERROR! %sAddBatchP() returned %d expected %d\n", name, result, expected_result);
+        return false;
+    }
+    if (!compare_limbs(name, 0, p3, expected, n * size)) return false;
+
+    expected_result = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        if (dbl(p1 + i * size, expected + i * size) != 0)
+        {
+            memset(expected + i * size, 0, size * sizeof(uint64_t));
+            expected_result = -1;
+        }
+    }
+    // in place
+    memcpy(p3, p1, n * size * sizeof(uint64_t));
+    result = dbl_batch(n, p3, p3);
+    if (result != expected_result)
+    {
+        printf("ERROR! %sDblBatchP() returned %d expected %d\n", name, result, expected_result);
+        return false;
+    }
+    if (!compare_limbs(name, 1, p3, expected, n * size)) return false;
+
+    if (verbose) printf("%s batch succeeded\n", name);
+    return true;
+}
+
+void CurveBatch_test()
+{
+    CurveBatch_test("AddPointEc", 4, AddPointEcAddP, AddPointEcAddBatchP, AddPointEcDblP, AddPointEcDblBatchP);
+    CurveBatch_test("BN254Curve", 4, BN254CurveAddP, BN254CurveAddBatchP, BN254CurveDblP, BN254CurveDblBatchP);
+    CurveBatch_test("BLS12_381Curve", 6, BLS12_381CurveAddP, BLS12_381CurveAddBatchP, BLS12_381CurveDblP, BLS12_381CurveDblBatchP);
+}
+
+// Exports a scalar to an array of u64 LE with a size multiple of 4 (at least 4), as the
+// big int division fcall does. Returns the size
+uint64_t export_padded(const mpz_class &s, uint64_t *a)
+{
+    size_t exported_size = 0;
+    mpz_export((void *)a, &exported_size, -1, 8, -1, 0, s.get_mpz_t());
+    size_t size = (exported_size == 0) ? 4 : ((exported_size + 3) / 4) * 4;
+    for (size_t i = exported_size; i < size; i++) a[i] = 0;
+    return size;
+}
+
+// Differential test of the big int division hints and the binary decomposition against GMP
+void BigIntDiv_test()
+{
+    static FcallContext ctx;
+    static uint64_t expected[FCALL_RESULT_MAX_SIZE];
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 10; i++)
+    {
+        // BigInt256Div
+        uint64_t a[8], r[8];
+        random_limbs(a, 4);
+        do {
+            random_limbs(a + 4, 4);
+        } while ((a[4] | a[5] | a[6] | a[7]) == 0);
+        mpz_class sa, sb, sq, sr;
+        array2scalar(a, sa);
+        array2scalar(a + 4, sb);
+        sq = sa / sb;
+        sr = sa % sb;
+        scalar2array(sq, expected);
+        scalar2array(sr, expected + 4);
+        BigInt256Div(a, r);
+        if (!compare_limbs("BigInt256Div", i, r, expected, 8)) return;
+
+        // BigIntDivCtx, with lengths (including leading zero limbs) up to 12 limbs
+        uint64_t len_a = rand() % 13;
+        uint64_t len_b = 1 + rand() % 12;
+        ctx.params[0] = len_a;
+        random_limbs(&ctx.params[1], len_a == 0 ? 1 : len_a);
+        if ((i % 3) == 0) memset(&ctx.params[1], 0, (len_a / 2) * sizeof(uint64_t));
+        ctx.params[1 + len_a] = len_b;
+        random_limbs(&ctx.params[2 + len_a], len_b);
+        if ((i % 5) == 0) ctx.params[2 + len_a + len_b - 1] = 0;
+        mpz_import(sa.get_mpz_t(), len_a, -1, 8, -1, 0, (const void *)&ctx.params[1]);
+        mpz_import(sb.get_mpz_t(), len_b, -1, 8, -1, 0, (const void *)&ctx.params[2 + len_a]);
+        if (sb == 0) continue;
+        sq = sa / sb;
+        sr = sa % sb;
+        uint64_t quotient_size = export_padded(sq, expected + 1);
+        expected[0] = quotient_size;
+        uint64_t remainder_size = export_padded(sr, expected + 2 + quotient_size);
+        expected[1 + quotient_size] = remainder_size;
+        int size = BigIntDivCtx(&ctx);
+        if (size != (int)(2 + quotient_size + remainder_size))
+        {
+            printf("ERROR! BigIntDivCtx() returned size %d expected %lu on test %lu\n", size, 2 + quotient_size + remainder_size, i);
+            return;
+        }
+        if (!compare_limbs("BigIntDivCtx", i, ctx.result, expected, size)) return;
+
+        // BinDecompCtx, with lengths (including leading zero limbs) up to 64 limbs
+        uint64_t len_x = rand() % 65;
+        ctx.params[0] = len_x;
+        random_limbs(&ctx.params[1], len_x == 0 ? 1 : len_x);
+        if ((i % 3) == 0) memset(&ctx.params[1 + len_x / 2], 0, (len_x - len_x / 2) * sizeof(uint64_t));
+        uint64_t bits = 0;
+        bool started = false;
+        for (int64_t j = len_x - 1; j >= 0; j--)
+        {
+            for (int64_t bit_pos = 63; bit_pos >= 0; bit_pos--)
+            {
+                uint64_t bit = (ctx.params[1 + j] >> bit_pos) & 1;
+                started = started || (bit == 1);
+                if (started) expected[1 + bits++] = bit;
+            }
+        }
+        expected[0] = bits;
+        BinDecompCtx(&ctx);
+        if (ctx.result_size != bits + 1)
+        {
+            printf("ERROR! BinDecompCtx() returned size %lu expected %lu on test %lu\n", ctx.result_size, bits + 1, i);
+            return;
+        }
+        if (!compare_limbs("BinDecompCtx", i, ctx.result, expected, bits + 1)) return;
+    }
+    if (verbose) printf("BigIntDiv() succeeded\n");
+}
+
+// Converts an hexadecimal string to an array of n64 u64 LE
+void hex2array(const char *hex, uint64_t *a, uint64_t n64)
+{
+    mpz_class s(hex, 16);
+    memset(a, 0, n64 * sizeof(uint64_t));
+    mpz_export((void *)a, NULL, -1, 8, -1, 0, s.get_mpz_t());
+}
+
+// Test of the Jacobian scalar multiplication hints against double and add with the affine
+// curve operations, plus the edge cases k = 0, k = order, k = order - 1 and p at infinity
+typedef int (*ScalarMulFunc)(const uint64_t *, uint64_t *);
+
+bool ScalarMul_test(const char *name, ScalarMulFunc func, CurveAddFunc add, CurveDblFunc dbl, uint64_t n64, const char *gx, const char *gy, const char *order, const char *prime)
+{
+    uint64_t a[16], r[12], expected[12], acc[12], aux[12];
+    hex2array(gx, a, n64);
+    hex2array(gy, a + n64, n64);
+    for (uint64_t i = 0; i < N_DIFF_TESTS / 1000; i++)
+    {
+        uint64_t *k = a + 2 * n64;
+        random_limbs(k, 4);
+        k[3] &= 0x0FFFFFFFFFFFFFFF; // lower than the order
+        if (i == 0) memset(k, 0, 4 * sizeof(uint64_t));
+        if (i == 1) hex2array(order, k, 4);
+        if (i == 2) { hex2array(order, k, 4); k[0] -= 1; }
+
+        // Double and add, with the affine operations
+        bool started = false;
+        for (int64_t limb = 3; limb >= 0; limb--)
+        {
+            for (int64_t bit = 63; bit >= 0; bit--)
+            {
+                if (started)
+                {
+                    dbl(acc, aux);
+                    memcpy(acc, aux, 2 * n64 * sizeof(uint64_t));
+                }
+                if ((k[limb] >> bit) & 1)
+                {
+                    if (!started)
+                    {
+                        memcpy(acc, a, 2 * n64 * sizeof(uint64_t));
+                        started = true;
+                    }
+                    else if (memcmp(acc, a, n64 * sizeof(uint64_t)) != 0)
+                    {
+                        add(acc, a, aux);
+                        memcpy(acc, aux, 2 * n64 * sizeof(uint64_t));
+                    }
+                    else
+                    {
+                        // acc = -p, the result (k = order) is the point at infinity
+                        started = false;
+                        memset(acc, 0, 2 * n64 * sizeof(uint64_t));
+                    }
+                }
+            }
+        }
+        if (!started)
+        {
+            memset(acc, 0, 2 * n64 * sizeof(uint64_t));
+            acc[n64] = 1;
+        }
+        memcpy(expected, acc, 2 * n64 * sizeof(uint64_t));
+
+        func(a, r);
+        if (!compare_limbs(name, i, r, expected, 2 * n64)) return false;
+    }
+
+    // k = order - 1 is -p
+    uint64_t *k = a + 2 * n64;
+    hex2array(order, k, 4);
+    k[0] -= 1;
+    func(a, r);
+    mpz_class y, p(prime, 16);
+    mpz_import(y.get_mpz_t(), n64, -1, 8, -1, 0, (const void *)(a + n64));
+    y = p - y;
+    memcpy(expected, a, n64 * sizeof(uint64_t));
+    memset(expected + n64, 0, n64 * sizeof(uint64_t));
+    mpz_export((void *)(expected + n64), NULL, -1, 8, -1, 0, y.get_mpz_t());
+    if (!compare_limbs(name, 0, r, expected, 2 * n64)) return false;
+
+    // p at infinity
+    memset(a, 0, 2 * n64 * sizeof(uint64_t));
+    a[n64] = 1;
+    random_limbs(k, 4);
+    func(a, r);
+    if (!compare_limbs(name, 0, r, a, 2 * n64)) return false;
+
+    if (verbose) printf("%s() succeeded\n", name);
+    return true;
+}
+
+void ScalarMul_test()
+{
+    ScalarMul_test("Secp256k1ScalarMul", Secp256k1ScalarMul, AddPointEcAddP, AddPointEcDblP, 4,
+        "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798",
+        "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
+    ScalarMul_test("BN254ScalarMul", BN254ScalarMul, BN254CurveAddP, BN254CurveDblP, 4,
+        "1",
+        "2",
+        "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001",
+        "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47");
+    ScalarMul_test("BLS12_381ScalarMul", BLS12_381ScalarMul, BLS12_381CurveAddP, BLS12_381CurveDblP, 6,
+        "17f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb",
+        "08b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1",
+        "73eda753299d7d483339d80809a1d80553bda402fffe5bfeffffffff00000001",
+        "1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab");
+}
+
+// Test of the secp256r1 curve operations with the known multiples 2G and 3G of the generator
+void Secp256r1Curve_test()
+{
+    uint64_t g[8], g2[8], g3[8], r[8];
+    hex2array("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296", g, 4);
+    hex2array("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5", g + 4, 4);
+    hex2array("7cf27b188d034f7e8a52380304b51ac3c08969e277f21b35a60b48fc47669978", g2, 4);
+    hex2array("07775510db8ed040293d9ac69f7430dbba7dade63ce982299e04b79d227873d1", g2 + 4, 4);
+    hex2array("5ecbe4d1a6330a44c8f7ef951d4bf165e6c6b721efada985fb41661bc6e7fd6c", g3, 4);
+    hex2array("8734640c4998ff7e374b06ce1a64a2ecd82ab036384fb83d9a79b127a27d5032", g3 + 4, 4);
+
+    Secp256r1CurveDblP(g, r);
+    if (!compare_limbs("Secp256r1CurveDblP", 0, r, g2, 8)) return;
+    Secp256r1CurveAddP(g, g2, r);
+    if (!compare_limbs("Secp256r1CurveAddP", 0, r, g3, 8)) return;
+    Secp256r1CurveAdd(g2, g2 + 4, g, g + 4, r, r + 4);
+    if (!compare_limbs("Secp256r1CurveAdd", 0, r, g3, 8)) return;
+    if (Secp256r1CurveAddP(g, g, r) != -1)
+    {
+        printf("ERROR! Secp256r1CurveAddP() should fail with p1 == p2\n");
+        return;
+    }
+    if (verbose) printf("Secp256r1Curve() succeeded\n");
+}
+
+// Test of the field batch functions against GMP, both on the IFMA kernel (if supported) and
+// on the scalar fields, with a number of elements that is not a multiple of the 8 lanes
+bool FieldBatch_test(const char *name, FieldBatchFunc func, uint64_t n64, const char *prime)
+{
+    const uint64_t n = 101;
+    uint64_t a[n * 6], b[n * 6], r[n * 6], expected[n * 6];
+    mpz_class p(prime, 16);
+    for (uint64_t ifma = 0; ifma < 2; ifma++)
+    {
+        FieldBatchIfmaEnable(ifma);
+        for (uint64_t i = 0; i < N_DIFF_TESTS / 1000; i++)
+        {
+            mpz_class sa[n], sb[n];
+            for (uint64_t j = 0; j < n; j++)
+            {
+                random_limbs(a + j * n64, n64);
+                random_limbs(b + j * n64, n64);
+                mpz_import(sa[j].get_mpz_t(), n64, -1, 8, -1, 0, (const void *)(a + j * n64));
+                mpz_import(sb[j].get_mpz_t(), n64, -1, 8, -1, 0, (const void *)(b + j * n64));
+                sa[j] %= p;
+                sb[j] %= p;
+                if (j == 0) sa[j] = sb[j] = p - 1;
+                memset(a + j * n64, 0, n64 * sizeof(uint64_t));
+                memset(b + j * n64, 0, n64 * sizeof(uint64_t));
+                mpz_export((void *)(a + j * n64), NULL, -1, 8, -1, 0, sa[j].get_mpz_t());
+                mpz_export((void *)(b + j * n64), NULL, -1, 8, -1, 0, sb[j].get_mpz_t());
+            }
+            for (uint64_t op = FIELD_BATCH_ADD; op <= FIELD_BATCH_SQUARE; op++)
+            {
+                for (uint64_t j = 0; j < n; j++)
+                {
+                    mpz_class sr = (op == FIELD_BATCH_ADD) ? mpz_class(sa[j] + sb[j]) : mpz_class(sa[j] * ((op == FIELD_BATCH_MUL) ? sb[j] : sa[j]));
+                    sr %= p;
+                    memset(expected + j * n64, 0, n64 * sizeof(uint64_t));
+                    mpz_export((void *)(expected + j * n64), NULL, -1, 8, -1, 0, sr.get_mpz_t());
+                }
+                func(op, n, a, (op == FIELD_BATCH_SQUARE) ? NULL : b, r);
+                if (!compare_limbs(name, i, r, expected, n * n64)) return false;
+            }
+        }
+    }
+    FieldBatchIfmaEnable(1);
+    if (verbose) printf("%s() succeeded (ifma=%d)\n", name, FieldBatchIfmaSupported());
+    return true;
+}
+
+void FieldBatch_test()
+{
+    FieldBatch_test("Secp256k1FpBatch", Secp256k1FpBatch, 4, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F");
+    FieldBatch_test("BN254FpBatch", BN254FpBatch, 4, "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47");
+    FieldBatch_test("BLS12_381FpBatch", BLS12_381FpBatch, 6, "1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab");
+}
+
+// Entry points called from several threads at once by Threads_test and Threads_benchmark, with
+// a common signature over an input and an output of THREADS_IO_SIZE u64. The table covers every
+// function exported by the library headers, and every fcall id through Fcall(), that also covers
+// the *Ctx functions
+#define THREADS_IO_SIZE 64
+
+typedef void (*ThreadsFunc)(const uint64_t *in, uint64_t *out);
+
+struct ThreadsCase
+{
+    const char *name;
+    ThreadsFunc func;
+};
+
+// ec
+void ThreadsAddPointEc(const uint64_t *in, uint64_t *out) { out[8] = AddPointEc(0, in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsDblPointEc(const uint64_t *in, uint64_t *out) { out[8] = AddPointEc(1, in, in + 4, NULL, NULL, out, out + 4); }
+void ThreadsAddPointEcP(const uint64_t *in, uint64_t *out) { out[8] = AddPointEcP(0, in, in + 8, out); }
+void ThreadsDblPointEcP(const uint64_t *in, uint64_t *out) { out[8] = AddPointEcP(1, in, NULL, out); }
+void ThreadsAddPointEcBatch(const uint64_t *in, uint64_t *out) { out[16] = AddPointEcBatchP(0, 2, in, in + 16, out); }
+void ThreadsDblPointEcBatch(const uint64_t *in, uint64_t *out) { out[16] = AddPointEcBatchP(1, 2, in, NULL, out); }
+
+// bn254
+void ThreadsBN254CurveAddP(const uint64_t *in, uint64_t *out) { out[8] = BN254CurveAddP(in, in + 8, out); }
+void ThreadsBN254CurveAdd(const uint64_t *in, uint64_t *out) { out[8] = BN254CurveAdd(in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsBN254CurveAddBatch(const uint64_t *in, uint64_t *out) { out[16] = BN254CurveAddBatchP(2, in, in + 16, out); }
+void ThreadsBN254CurveDbl(const uint64_t *in, uint64_t *out) { out[8] = BN254CurveDbl(in, in + 4, out, out + 4); }
+void ThreadsBN254CurveDblP(const uint64_t *in, uint64_t *out) { out[8] = BN254CurveDblP(in, out); }
+void ThreadsBN254CurveDblBatch(const uint64_t *in, uint64_t *out) { out[16] = BN254CurveDblBatchP(2, in, out); }
+void ThreadsBN254ComplexAdd(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexAdd(in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsBN254ComplexAddP(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexAddP(in, in + 8, out); }
+void ThreadsBN254ComplexSub(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexSub(in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsBN254ComplexSubP(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexSubP(in, in + 8, out); }
+void ThreadsBN254ComplexMul(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexMul(in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsBN254ComplexMulP(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexMulP(in, in + 8, out); }
+
+// bls12_381
+void ThreadsBLS12_381CurveAdd(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381CurveAdd(in, in + 6, in + 12, in + 18, out, out + 6); }
+void ThreadsBLS12_381CurveAddP(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381CurveAddP(in, in + 12, out); }
+void ThreadsBLS12_381CurveAddBatch(const uint64_t *in, uint64_t *out) { out[24] = BLS12_381CurveAddBatchP(2, in, in + 24, out); }
+void ThreadsBLS12_381CurveDbl(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381CurveDbl(in, in + 6, out, out + 6); }
+void ThreadsBLS12_381CurveDblP(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381CurveDblP(in, out); }
+void ThreadsBLS12_381CurveDblBatch(const uint64_t *in, uint64_t *out) { out[24] = BLS12_381CurveDblBatchP(2, in, out); }
+void ThreadsBLS12_381ComplexAdd(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexAdd(in, in + 6, in + 12, in + 18, out, out + 6); }
+void ThreadsBLS12_381ComplexAddP(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexAddP(in, in + 12, out); }
+void ThreadsBLS12_381ComplexSub(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexSub(in, in + 6, in + 12, in + 18, out, out + 6); }
+void ThreadsBLS12_381ComplexSubP(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexSubP(in, in + 12, out); }
+void ThreadsBLS12_381ComplexMul(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexMul(in, in + 6, in + 12, in + 18, out, out + 6); }
+void ThreadsBLS12_381ComplexMulP(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexMulP(in, in + 12, out); }
+
+// secp256r1
+void ThreadsSecp256r1CurveAdd(const uint64_t *in, uint64_t *out) { out[8] = Secp256r1CurveAdd(in, in + 4, in + 8, in + 12, out, out + 4); }
+void ThreadsSecp256r1CurveAddP(const uint64_t *in, uint64_t *out) { out[8] = Secp256r1CurveAddP(in, in + 8, out); }
+void ThreadsSecp256r1CurveDbl(const uint64_t *in, uint64_t *out) { out[8] = Secp256r1CurveDbl(in, in + 4, out, out + 4); }
+void ThreadsSecp256r1CurveDblP(const uint64_t *in, uint64_t *out) { out[8] = Secp256r1CurveDblP(in, out); }
+
+// fcall, u64 array format
+void ThreadsInverseFpEc(const uint64_t *in, uint64_t *out) { out[4] = InverseFpEc(in, out); }
+void ThreadsInverseFnEc(const uint64_t *in, uint64_t *out) { out[4] = InverseFnEc(in, out); }
+void ThreadsSqrtFpEcParity(const uint64_t *in, uint64_t *out) { out[5] = SqrtFpEcParity(in, in[4] & 1, out); }
+void ThreadsMsbPos256(const uint64_t *in, uint64_t *out) { out[2] = MsbPos256(in, out); }
+void ThreadsBN254FpInv(const uint64_t *in, uint64_t *out) { out[4] = BN254FpInv(in, out); }
+void ThreadsBN254ComplexInv(const uint64_t *in, uint64_t *out) { out[8] = BN254ComplexInv(in, out); }
+void ThreadsBN254TwistAddLineCoeffs(const uint64_t *in, uint64_t *out) { out[16] = BN254TwistAddLineCoeffs(in, out); }
+void ThreadsBN254TwistDblLineCoeffs(const uint64_t *in, uint64_t *out) { out[16] = BN254TwistDblLineCoeffs(in, out); }
+void ThreadsBLS12_381FpInv(const uint64_t *in, uint64_t *out) { out[6] = BLS12_381FpInv(in, out); }
+void ThreadsBLS12_381FpSqrt(const uint64_t *in, uint64_t *out) { out[7] = BLS12_381FpSqrt(in, out); }
+void ThreadsBLS12_381ComplexInv(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ComplexInv(in, out); }
+void ThreadsBLS12_381TwistAddLineCoeffs(const uint64_t *in, uint64_t *out) { out[24] = BLS12_381TwistAddLineCoeffs(in, out); }
+void ThreadsBLS12_381TwistDblLineCoeffs(const uint64_t *in, uint64_t *out) { out[24] = BLS12_381TwistDblLineCoeffs(in, out); }
+void ThreadsMsbPos384(const uint64_t *in, uint64_t *out) { out[2] = MsbPos384(in, out); }
+void ThreadsBigInt256Div(const uint64_t *in, uint64_t *out) { out[8] = BigInt256Div(in, out); }
+void ThreadsSecp256k1ScalarMul(const uint64_t *in, uint64_t *out) { out[8] = Secp256k1ScalarMul(in, out); }
+void ThreadsBN254ScalarMul(const uint64_t *in, uint64_t *out) { out[8] = BN254ScalarMul(in, out); }
+void ThreadsBLS12_381ScalarMul(const uint64_t *in, uint64_t *out) { out[12] = BLS12_381ScalarMul(in, out); }
+void ThreadsSecp256r1FpInv(const uint64_t *in, uint64_t *out) { out[4] = Secp256r1FpInv(in, out); }
+void ThreadsSecp256r1FnInv(const uint64_t *in, uint64_t *out) { out[4] = Secp256r1FnInv(in, out); }
+void ThreadsSecp256r1FpSqrt(const uint64_t *in, uint64_t *out) { out[5] = Secp256r1FpSqrt(in, in[4] & 1, out); }
+
+// arith256, arith384 and add256
+void ThreadsArith256(const uint64_t *in, uint64_t *out) { out[8] = Arith256(in, in + 4, in + 8, out, out + 4); }
+void ThreadsFastArith256(const uint64_t *in, uint64_t *out) { out[8] = FastArith256(in, in + 4, in + 8, out, out + 4); }
+void ThreadsArith256Mod(const uint64_t *in, uint64_t *out) { out[4] = Arith256Mod(in, in + 4, in + 8, in + 12, out); }
+void ThreadsArith256ModGmp(const uint64_t *in, uint64_t *out) { out[4] = Arith256ModGmp(in, in + 4, in + 8, in + 12, out); }
+void ThreadsArith384(const uint64_t *in, uint64_t *out) { out[12] = Arith384(in, in + 6, in + 12, out, out + 6); }
+void ThreadsArith384Gmp(const uint64_t *in, uint64_t *out) { out[12] = Arith384Gmp(in, in + 6, in + 12, out, out + 6); }
+void ThreadsArith384Mod(const uint64_t *in, uint64_t *out) { out[6] = Arith384Mod(in, in + 6, in + 12, in + 18, out); }
+void ThreadsArith384ModGmp(const uint64_t *in, uint64_t *out) { out[6] = Arith384ModGmp(in, in + 6, in + 12, in + 18, out); }
+void ThreadsAdd256(const uint64_t *in, uint64_t *out) { out[4] = Add256(in, in + 4, in[8] & 1, out); }
+
+// field_batch, toggling the IFMA kernel while the other threads use it
+void ThreadsSecp256k1FpBatch(const uint64_t *in, uint64_t *out) { out[16] = Secp256k1FpBatch(FIELD_BATCH_MUL, 4, in, in + 16, out); }
+void ThreadsBN254FpBatch(const uint64_t *in, uint64_t *out) { out[16] = BN254FpBatch(FIELD_BATCH_ADD, 4, in, in + 16, out); }
+void ThreadsBLS12_381FpBatch(const uint64_t *in, uint64_t *out) { out[24] = BLS12_381FpBatch(FIELD_BATCH_SQUARE, 4, in, NULL, out); }
+void ThreadsFieldBatchIfma(const uint64_t *in, uint64_t *out)
+{
+    FieldBatchIfmaEnable(1);
+    out[0] = FieldBatchIfmaSupported();
+    out[17] = BN254FpBatch(FIELD_BATCH_MUL, 4, in, in + 16, out + 1);
+}
+
+// Calls Fcall() with the given parameters, and returns the result code and the result
+void threads_fcall(uint64_t id, const uint64_t *params, uint64_t params_size, uint64_t *out)
+{
+    // The fcall context is too big for the stack of the worker threads
+    static thread_local FcallContext ctx;
+    ctx.function_id = id;
+    ctx.params_max_size = FCALL_PARAMS_MAX_SIZE;
+    ctx.params_size = params_size;
+    memcpy(ctx.params, params, params_size * sizeof(uint64_t));
+    ctx.result_max_size = FCALL_RESULT_MAX_SIZE;
+    ctx.result_size = 0;
+    int iresult = Fcall(&ctx);
+    out[0] = iresult;
+
+    // BigIntDivCtx returns the result size instead of setting it
+    uint64_t size = (iresult > 0) ? iresult : ctx.result_size;
+    if (size > THREADS_IO_SIZE - 1) size = THREADS_IO_SIZE - 1;
+    memcpy(out + 1, ctx.result, size * sizeof(uint64_t));
+}
+
+// Fcall ids with a fixed number of parameters, taken from the input. The square roots take the
+// parity as the last parameter
+template <uint64_t id, uint64_t params_size>
+void ThreadsFcall(const uint64_t *in, uint64_t *out) { threads_fcall(id, in, params_size, out); }
+
+template <uint64_t id>
+void ThreadsFcallSqrt(const uint64_t *in, uint64_t *out)
+{
+    uint64_t params[5] = { in[0], in[1], in[2], in[3], in[4] & 1 };
+    threads_fcall(id, params, 5, out);
+}
+
+// Big int division over 4 limbs (len_a, a, len_b, b), or over GMP for larger operands
+template <uint64_t len_a, uint64_t len_b>
+void ThreadsFcallBigIntDiv(const uint64_t *in, uint64_t *out)
+{
+    uint64_t params[2 + len_a + len_b];
+    params[0] = len_a;
+    memcpy(&params[1], in, len_a * sizeof(uint64_t));
+    params[1 + len_a] = len_b;
+    memcpy(&params[2 + len_a], in + len_a, len_b * sizeof(uint64_t));
+    threads_fcall(FCALL_BIG_INT_DIV_ID, params, 2 + len_a + len_b, out);
+}
+
+// Binary decomposition of a single limb, so the result fits in the output
+void ThreadsFcallBinDecomp(const uint64_t *in, uint64_t *out)
+{
+    uint64_t params[2] = { 1, in[0] };
+    threads_fcall(FCALL_BIN_DECOMP_ID, params, 2, out);
+}
+
+const ThreadsCase threads_cases[] = {
+    // ec
+    { "AddPointEc (add)", ThreadsAddPointEc },
+    { "AddPointEc (dbl)", ThreadsDblPointEc },
+    { "AddPointEcP (add)", ThreadsAddPointEcP },
+    { "AddPointEcP (dbl)", ThreadsDblPointEcP },
+    { "AddPointEcBatchP (add)", ThreadsAddPointEcBatch },
+    { "AddPointEcBatchP (dbl)", ThreadsDblPointEcBatch },
+
+    // bn254
+    { "BN254CurveAdd", ThreadsBN254CurveAdd },
+    { "BN254CurveAddP", ThreadsBN254CurveAddP },
+    { "BN254CurveAddBatchP", ThreadsBN254CurveAddBatch },
+    { "BN254CurveDbl", ThreadsBN254CurveDbl },
+    { "BN254CurveDblP", ThreadsBN254CurveDblP },
+    { "BN254CurveDblBatchP", ThreadsBN254CurveDblBatch },
+    { "BN254ComplexAdd", ThreadsBN254ComplexAdd },
+    { "BN254ComplexAddP", ThreadsBN254ComplexAddP },
+    { "BN254ComplexSub", ThreadsBN254ComplexSub },
+    { "BN254ComplexSubP", ThreadsBN254ComplexSubP },
+    { "BN254ComplexMul", ThreadsBN254ComplexMul },
+    { "BN254ComplexMulP", ThreadsBN254ComplexMulP },
+
+    // bls12_381
+    { "BLS12_381CurveAdd", ThreadsBLS12_381CurveAdd },
+    { "BLS12_381CurveAddP", ThreadsBLS12_381CurveAddP },
+    { "BLS12_381CurveAddBatchP", ThreadsBLS12_381CurveAddBatch },
+    { "BLS12_381CurveDbl", ThreadsBLS12_381CurveDbl },
+    { "BLS12_381CurveDblP", ThreadsBLS12_381CurveDblP },
+    { "BLS12_381CurveDblBatchP", ThreadsBLS12_381CurveDblBatch },
+    { "BLS12_381ComplexAdd", ThreadsBLS12_381ComplexAdd },
+    { "BLS12_381ComplexAddP", ThreadsBLS12_381ComplexAddP },
+    { "BLS12_381ComplexSub", ThreadsBLS12_381ComplexSub },
+    { "BLS12_381ComplexSubP", ThreadsBLS12_381ComplexSubP },
+    { "BLS12_381ComplexMul", ThreadsBLS12_381ComplexMul },
+    { "BLS12_381ComplexMulP", ThreadsBLS12_381ComplexMulP },
+
+    // secp256r1
+    { "Secp256r1CurveAdd", ThreadsSecp256r1CurveAdd },
+    { "Secp256r1CurveAddP", ThreadsSecp256r1CurveAddP },
+    { "Secp256r1CurveDbl", ThreadsSecp256r1CurveDbl },
+    { "Secp256r1CurveDblP", ThreadsSecp256r1CurveDblP },
+
+    // fcall, u64 array format
+    { "InverseFpEc", ThreadsInverseFpEc },
+    { "InverseFnEc", ThreadsInverseFnEc },
+    { "SqrtFpEcParity", ThreadsSqrtFpEcParity },
+    { "MsbPos256", ThreadsMsbPos256 },
+    { "BN254FpInv", ThreadsBN254FpInv },
+    { "BN254ComplexInv", ThreadsBN254ComplexInv },
+    { "BN254TwistAddLineCoeffs", ThreadsBN254TwistAddLineCoeffs },
+    { "BN254TwistDblLineCoeffs", ThreadsBN254TwistDblLineCoeffs },
+    { "BLS12_381FpInv", ThreadsBLS12_381FpInv },
+    { "BLS12_381FpSqrt", ThreadsBLS12_381FpSqrt },
+    { "BLS12_381ComplexInv", ThreadsBLS12_381ComplexInv },
+    { "BLS12_381TwistAddLineCoeffs", ThreadsBLS12_381TwistAddLineCoeffs },
+    { "BLS12_381TwistDblLineCoeffs", ThreadsBLS12_381TwistDblLineCoeffs },
+    { "MsbPos384", ThreadsMsbPos384 },
+    { "BigInt256Div", ThreadsBigInt256Div },
+    { "Secp256k1ScalarMul", ThreadsSecp256k1ScalarMul },
+    { "BN254ScalarMul", ThreadsBN254ScalarMul },
+    { "BLS12_381ScalarMul", ThreadsBLS12_381ScalarMul },
+    { "Secp256r1FpInv", ThreadsSecp256r1FpInv },
+    { "Secp256r1FnInv", ThreadsSecp256r1FnInv },
+    { "Secp256r1FpSqrt", ThreadsSecp256r1FpSqrt },
+
+    // fcall, every id through Fcall()
+    { "Fcall INVERSE_FP_EC", ThreadsFcall<FCALL_ID_INVERSE_FP_EC, 4> },
+    { "Fcall INVERSE_FN_EC", ThreadsFcall<FCALL_ID_INVERSE_FN_EC, 4> },
+    { "Fcall SQRT_FP_EC_PARITY", ThreadsFcallSqrt<FCALL_ID_SQRT_FP_EC_PARITY> },
+    { "Fcall MSB_POS_256", ThreadsFcall<FCALL_ID_MSB_POS_256, 8> },
+    { "Fcall BN254_FP_INV", ThreadsFcall<FCALL_ID_BN254_FP_INV, 4> },
+    { "Fcall BN254_FP2_INV", ThreadsFcall<FCALL_ID_BN254_FP2_INV, 8> },
+    { "Fcall BN254_TWIST_ADD_LINE_COEFFS", ThreadsFcall<FCALL_ID_BN254_TWIST_ADD_LINE_COEFFS, 32> },
+    { "Fcall BN254_TWIST_DBL_LINE_COEFFS", ThreadsFcall<FCALL_ID_BN254_TWIST_DBL_LINE_COEFFS, 16> },
+    { "Fcall BLS12_381_FP_INV", ThreadsFcall<FCALL_BLS12_381_FP_INV_ID, 6> },
+    { "Fcall BLS12_381_FP_SQRT", ThreadsFcall<FCALL_BLS12_381_FP_SQRT_ID, 6> },
+    { "Fcall BLS12_381_FP2_INV", ThreadsFcall<FCALL_BLS12_381_FP2_INV_ID, 12> },
+    { "Fcall BLS12_381_TWIST_ADD_LINE_COEFFS", ThreadsFcall<FCALL_BLS12_381_TWIST_ADD_LINE_COEFFS_ID, 48> },
+    { "Fcall BLS12_381_TWIST_DBL_LINE_COEFFS", ThreadsFcall<FCALL_BLS12_381_TWIST_DBL_LINE_COEFFS_ID, 24> },
+    { "Fcall MSB_POS_384", ThreadsFcall<FCALL_MSB_POS_384_ID, 12> },
+    { "Fcall BIGINT256_DIV", ThreadsFcall<FCALL_BIGINT256_DIV_ID, 8> },
+    { "Fcall BIG_INT_DIV (limbs)", ThreadsFcallBigIntDiv<4, 2> },
+    { "Fcall BIG_INT_DIV (gmp)", ThreadsFcallBigIntDiv<6, 3> },
+    { "Fcall BIN_DECOMP", ThreadsFcallBinDecomp },
+    { "Fcall SECP256K1_SCALAR_MUL", ThreadsFcall<FCALL_SECP256K1_SCALAR_MUL_ID, 12> },
+    { "Fcall BN254_SCALAR_MUL", ThreadsFcall<FCALL_BN254_SCALAR_MUL_ID, 12> },
+    { "Fcall BLS12_381_SCALAR_MUL", ThreadsFcall<FCALL_BLS12_381_SCALAR_MUL_ID, 16> },
+    { "Fcall SECP256R1_FP_INV", ThreadsFcall<FCALL_SECP256R1_FP_INV_ID, 4> },
+    { "Fcall SECP256R1_FN_INV", ThreadsFcall<FCALL_SECP256R1_FN_INV_ID, 4> },
+    { "Fcall SECP256R1_FP_SQRT", ThreadsFcallSqrt<FCALL_SECP256R1_FP_SQRT_ID> },
+
+    // arith256, arith384 and add256
+    { "Arith256", ThreadsArith256 },
+    { "FastArith256", ThreadsFastArith256 },
+    { "Arith256Mod", ThreadsArith256Mod },
+    { "Arith256ModGmp", ThreadsArith256ModGmp },
+    { "Arith384", ThreadsArith384 },
+    { "Arith384Gmp", ThreadsArith384Gmp },
+    { "Arith384Mod", ThreadsArith384Mod },
+    { "Arith384ModGmp", ThreadsArith384ModGmp },
+    { "Add256", ThreadsAdd256 },
+
+    // field_batch
+    { "Secp256k1FpBatch", ThreadsSecp256k1FpBatch },
+    { "BN254FpBatch", ThreadsBN254FpBatch },
+    { "BLS12_381FpBatch", ThreadsBLS12_381FpBatch },
+    { "FieldBatchIfmaEnable", ThreadsFieldBatchIfma },
+};
+
+// Random input for the threads tests, with every limb lower than 2^56 so the values are lower
+// than any of the primes, and odd so no limb is zero. Zero values make the inversions and the
+// divisions fail, leaving the output undefined
+void threads_input(uint64_t *in)
+{
+    for (uint64_t i = 0; i < THREADS_IO_SIZE; i++)
+    {
+        in[i] = (random_limb() >> 8) | 1;
+    }
+}
+
+// Calls every entry point from several threads at once, each thread walking the same inputs in
+// a different order, and checks the results against a single-threaded run. Build with
+// make tsan=1 and run with -t to also check it with ThreadSanitizer
+bool Threads_test()
+{
+    const uint64_t n_inputs = 64;
+    const uint64_t rounds = 4;
+    const uint64_t n_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<uint64_t> in(n_inputs * THREADS_IO_SIZE), expected(n_inputs * THREADS_IO_SIZE);
+    bool result = true;
+    for (const ThreadsCase &test : threads_cases)
+    {
+        for (uint64_t i = 0; i < n_inputs; i++)
+        {
+            threads_input(&in[i * THREADS_IO_SIZE]);
+            memset(&expected[i * THREADS_IO_SIZE], 0, THREADS_IO_SIZE * sizeof(uint64_t));
+            test.func(&in[i * THREADS_IO_SIZE], &expected[i * THREADS_IO_SIZE]);
+        }
+
+        std::atomic<uint64_t> errors(0);
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < n_threads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                uint64_t out[THREADS_IO_SIZE];
+                for (uint64_t round = 0; round < rounds; round++)
+                {
+                    for (uint64_t i = 0; i < n_inputs; i++)
+                    {
+                        const uint64_t j = (i * (2 * t + 1) + round) % n_inputs;
+                        memset(out, 0, sizeof(out));
+                        test.func(&in[j * THREADS_IO_SIZE], out);
+                        if (memcmp(out, &expected[j * THREADS_IO_SIZE], sizeof(out)) != 0) errors++;
+                    }
+                }
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+
+        if (errors != 0)
+        {
+            printf("ERROR! %s() got %lu wrong results from %lu threads\n", test.name, errors.load(), n_threads);
+            result = false;
+        }
+        else if (verbose)
+        {
+            printf("%s() succeeded from %lu threads\n", test.name, n_threads);
+        }
+    }
+    return result;
+}
+
+// Aggregate throughput of N_TESTS calls split between 1, 2, 4... threads, up to the number of
+// cores, over a pool of inputs that fits in the cache
+void Threads_benchmark(uint64_t *data)
+{
+    const uint64_t n_inputs = 1024;
+    const ThreadsCase cases[] = {
+        { "AddPointEcP", ThreadsAddPointEcP },
+        { "BN254CurveAddP", ThreadsBN254CurveAddP },
+        { "BLS12_381CurveAddP", ThreadsBLS12_381CurveAddP },
+        { "InverseFpEc", ThreadsInverseFpEc },
+    };
+    for (uint64_t i = 0; i < n_inputs; i++)
+    {
+        threads_input(data + i * THREADS_IO_SIZE);
+    }
+
+    const uint64_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (const ThreadsCase &test : cases)
+    {
+        for (uint64_t n_threads = 1; n_threads <= max_threads; n_threads = (n_threads * 2 > max_threads && n_threads < max_threads) ? max_threads : n_threads * 2)
+        {
+            struct timeval startTime;
+            gettimeofday(&startTime, NULL);
+            std::vector<std::thread> threads;
+            for (uint64_t t = 0; t < n_threads; t++)
+            {
+                threads.emplace_back([&, t]() {
+                    uint64_t out[THREADS_IO_SIZE];
+                    for (uint64_t i = t; i < N_TESTS; i += n_threads)
+                    {
+                        test.func(data + (i % n_inputs) * THREADS_IO_SIZE, out);
+                    }
+                });
+            }
+            for (std::thread &thread : threads) thread.join();
+            uint64_t duration = TimeDiff(startTime);
+            double tp = duration == 0 ? 0 : double(N_TESTS)/duration;
+            char label[64];
+            snprintf(label, sizeof(label), "%s x%lu", test.name, n_threads);
+            print_results(label, duration, tp);
+        }
+    }
+}
+
 void Div256_benchmark(uint64_t *data) {
 
     try {
@@ -1271,6 +2444,12 @@ int main(int argc, char *argv[])
         {
             verbose = true;
         } 
+        else if (strcmp(argv[1], "-t") == 0)
+        {
+            // Only the threads test, to run it under ThreadSanitizer
+            verbose = true;
+            return Threads_test() ? 0 : 1;
+        }
     }
 
     setlocale(LC_NUMERIC, "en_US.UTF-8");  // usa locale del sistema
@@ -1279,14 +2458,22 @@ int main(int argc, char *argv[])
     printf("Test                        |duration   (us)|average    (ns)|TP (Mcalls/sec)\n");
     printf("----------------------------|---------------|---------------|---------------\n");
 
+    array2fe_benchmark(data);
     secp256k1_add_benchmark(data);
     secp256k1_dbl_benchmark(data);
     // secp256k1_add_fe_benchmark(data);
     // secp256k1_dbl_fe_benchmark(data);
     InverseFpEc_benchmark(data);
+    InverseFpEcMpz_benchmark(data);
+    ModInv_benchmark<false>(data, "modinv secp256k1 (ct)");
+    ModInv_benchmark<true>(data, "modinv secp256k1 (var)");
     InverseFnEc_benchmark(data);
     SqrtFpEcParity_benchmark(data);
     BN254CurveAddP_benchmark(data);
+    BN254CurveAddBatchP_benchmark(data);
+    FieldBatchMul_benchmark(data, BN254FpBatch, 4, "BN254FpBatch mul");
+    FieldBatchMul_benchmark(data, BLS12_381FpBatch, 6, "BLS12_381FpBatch mul");
+    Threads_benchmark(data);
     BN254CurveDblP_benchmark(data);
     BN254FpInv_benchmark(data);
     BN254ComplexAddP_benchmark(data);
@@ -1297,9 +2484,12 @@ int main(int argc, char *argv[])
     BN254TwistDblLineCoeffs_benchmark(data);
     Arith256_benchmark(data);
     FastArith256_benchmark(data);
-    Arith256Mod_benchmark(data);
-    Arith384_benchmark(data);
-    Arith384Mod_benchmark(data);
+    Arith256Mod_benchmark(data, Arith256Mod, "Arith256Mod");
+    Arith256Mod_benchmark(data, Arith256ModGmp, "Arith256Mod (gmp)");
+    Arith384_benchmark(data, Arith384, "Arith384");
+    Arith384_benchmark(data, Arith384Gmp, "Arith384 (gmp)");
+    Arith384Mod_benchmark(data, Arith384Mod, "Arith384Mod");
+    Arith384Mod_benchmark(data, Arith384ModGmp, "Arith384Mod (gmp)");
     BLS12_381CurveAddP_benchmark(data);
     BLS12_381CurveDblP_benchmark(data);
     BLS12_381ComplexAddP_benchmark(data);
@@ -1311,6 +2501,18 @@ int main(int argc, char *argv[])
     BN254ComplexInv_test();
     BN254TwistAddLineCoeffs_test();
     BN254TwistDblLineCoeffs_test();
+    Arith256Mod_test();
+    Arith384_test();
+    Arith384Mod_test();
+    Inverse_test();
+    ModInv_test();
+    Sqrt_test();
+    CurveBatch_test();
+    BigIntDiv_test();
+    ScalarMul_test();
+    Secp256r1Curve_test();
+    FieldBatch_test();
+    Threads_test();
     
     Div256_benchmark(data);
 
@@ -0,0 +1,83 @@
+#include <gmpxx.h>
+#include "secp256r1.hpp"
+#include "secp256r1_fe.hpp"
+#include "../ffiasm/psecp256r1.hpp"
+#include "../common/utils.hpp"
+#include "../common/globals.hpp"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************/
+/* SECP256R1 CURVE ADD */
+/***********************/
+
+int Secp256r1CurveAdd (const uint64_t * _x1, const uint64_t * _y1, const uint64_t * _x2, const uint64_t * _y2, uint64_t * _x3, uint64_t * _y3)
+{
+    RawpSecp256r1::Element x1, y1, x2, y2, x3, y3;
+    array2fe(_x1, x1);
+    array2fe(_y1, y1);
+    array2fe(_x2, x2);
+    array2fe(_y2, y2);
+
+    int result = Secp256r1CurveAddFe (x1, y1, x2, y2, x3, y3);
+
+    fe2array(x3, _x3);
+    fe2array(y3, _y3);
+
+    return result;
+}
+
+int Secp256r1CurveAddP (const uint64_t * p1, const uint64_t * p2, uint64_t * p3)
+{
+    RawpSecp256r1::Element x1, y1, x2, y2, x3, y3;
+    array2fe(p1, x1);
+    array2fe(p1 + 4, y1);
+    array2fe(p2, x2);
+    array2fe(p2 + 4, y2);
+
+    int result = Secp256r1CurveAddFe (x1, y1, x2, y2, x3, y3);
+
+    fe2array(x3, p3);
+    fe2array(y3, p3 + 4);
+
+    return result;
+}
+
+/**************************/
+/* SECP256R1 CURVE DOUBLE */
+/**************************/
+
+int Secp256r1CurveDbl (const uint64_t * _x1, const uint64_t * _y1, uint64_t * _x2, uint64_t * _y2)
+{
+    RawpSecp256r1::Element x1, y1, x2, y2;
+    array2fe(_x1, x1);
+    array2fe(_y1, y1);
+
+    int result = Secp256r1CurveDblFe (x1, y1, x2, y2);
+
+    fe2array(x2, _x2);
+    fe2array(y2, _y2);
+
+    return result;
+}
+
+int Secp256r1CurveDblP (const uint64_t * p1, uint64_t * p2)
+{
+    RawpSecp256r1::Element x1, y1, x2, y2;
+    array2fe(p1, x1);
+    array2fe(p1 + 4, y1);
+
+    int result = Secp256r1CurveDblFe (x1, y1, x2, y2);
+
+    fe2array(x2, p2);
+    fe2array(y2, p2 + 4);
+
+    return result;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,49 @@
+#ifndef SECP256R1_HPP
+#define SECP256R1_HPP
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************/
+/* secp256r1 curve add */
+/***********************/
+
+int Secp256r1CurveAdd (
+    const uint64_t * x1, // 4 x 64 bits
+    const uint64_t * y1, // 4 x 64 bits
+    const uint64_t * x2, // 4 x 64 bits
+    const uint64_t * y2, // 4 x 64 bits
+    uint64_t * x3, // 4 x 64 bits
+    uint64_t * y3  // 4 x 64 bits
+);
+
+int Secp256r1CurveAddP (
+    const uint64_t * p1, // 8 x 64 bits
+    const uint64_t * p2, // 8 x 64 bits
+    uint64_t * p3  // 8 x 64 bits
+);
+
+/**************************/
+/* secp256r1 curve double */
+/**************************/
+
+int Secp256r1CurveDbl (
+    const uint64_t * x1, // 4 x 64 bits
+    const uint64_t * y1, // 4 x 64 bits
+    uint64_t * x2, // 4 x 64 bits
+    uint64_t * y2  // 4 x 64 bits
+);
+
+int Secp256r1CurveDblP (
+    const uint64_t * p1, // 8 x 64 bits
+    uint64_t * p2  // 8 x 64 bits
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SECP256R1_FE_HPP
+#define SECP256R1_FE_HPP
+
+#include <stdint.h>
+#include "../ffiasm/psecp256r1.hpp"
+#include "../common/globals.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// secp256r1 (P-256) curve: y^2 = x^3 + a*x + b, with a = -3
+
+int inline Secp256r1CurveAddFe (const RawpSecp256r1::Element &x1, const RawpSecp256r1::Element &y1, const RawpSecp256r1::Element &x2, const RawpSecp256r1::Element &y2, RawpSecp256r1::Element &x3, RawpSecp256r1::Element &y3)
+{
+    RawpSecp256r1::Element aux1, aux2, s;
+
+    // s = (y2-y1)/(x2-x1)
+    psecp256r1.sub(aux1, y2, y1);
+    psecp256r1.sub(aux2, x2, x1);
+    if (psecp256r1.isZero(aux2))
+    {
+        printf("Secp256r1CurveAddFe() got denominator=0 2\n");
+        return -1;
+    }
+    psecp256r1.div(s, aux1, aux2);
+
+    // Required for x3 calculation
+    psecp256r1.add(aux2, x1, x2);
+
+    // x3 = s*s - (x1+x2)
+    psecp256r1.mul(aux1, s, s);
+    // aux2 was calculated before
+    psecp256r1.sub(x3, aux1, aux2);
+
+    // y3 = s*(x1-x3) - y1
+    psecp256r1.sub(aux1, x1, x3);
+    psecp256r1.mul(aux1, aux1, s);
+    psecp256r1.sub(y3, aux1, y1);
+
+    return 0;
+}
+
+int inline Secp256r1CurveDblFe (const RawpSecp256r1::Element &x1, const RawpSecp256r1::Element &y1, RawpSecp256r1::Element &x2, RawpSecp256r1::Element &y2)
+{
+    RawpSecp256r1::Element aux1, aux2, s;
+
+    // s = (3*x1*x1 + a)/2*y1 = 3*(x1*x1 - 1)/2*y1
+    psecp256r1.mul(aux1, x1, x1);
+    psecp256r1.sub(aux1, aux1, psecp256r1.one());
+    psecp256r1.fromUI(aux2, 3);
+    psecp256r1.mul(aux1, aux1, aux2);
+    psecp256r1.add(aux2, y1, y1);
+    if (psecp256r1.isZero(aux2))
+    {
+        printf("Secp256r1CurveDblFe() got denominator=0 1\n");
+        return -1;
+    }
+    psecp256r1.div(s, aux1, aux2);
+
+    // Required for x3 calculation
+    psecp256r1.add(aux2, x1, x1);
+
+    // x2 = s*s - (x1+x1)
+    psecp256r1.mul(aux1, s, s);
+    // aux2 was calculated before
+    psecp256r1.sub(x2, aux1, aux2);
+
+    // y2 = s*(x1-x2) - y1
+    psecp256r1.sub(aux1, x1, x2);
+    psecp256r1.mul(aux1, aux1, s);
+    psecp256r1.sub(y2, aux1, y1);
+
+    return 0;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
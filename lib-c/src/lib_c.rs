@@ -32,6 +32,69 @@ pub fn add_point_ec_p_c(dbl: u64, p1: &[u64; 8], p2: &[u64; 8], p3: &mut [u64; 8
     run_on_linux!(AddPointEcP(dbl, &p1[0], &p2[0], &mut p3[0]))
 }
 
+/// Computes `p1.len() / 8` secp256k1 additions (or doublings if `dbl`) sharing a single field
+/// inversion. Points are (x, y) as 8 u64 LE, `p2` is ignored when doubling.
+pub fn add_point_ec_batch_p_c(dbl: u64, p1: &[u64], p2: &[u64], p3: &mut [u64]) -> i32 {
+    let n = p1.len() / 8;
+    assert!(p3.len() >= n * 8 && (dbl != 0 || p2.len() >= n * 8));
+    run_on_linux!(AddPointEcBatchP(dbl, n as u64, p1.as_ptr(), p2.as_ptr(), p3.as_mut_ptr()))
+}
+
+/// Computes `p1.len() / 8` BN254 additions sharing a single field inversion.
+pub fn bn254_curve_add_batch_p_c(p1: &[u64], p2: &[u64], p3: &mut [u64]) -> i32 {
+    let n = p1.len() / 8;
+    assert!(p2.len() >= n * 8 && p3.len() >= n * 8);
+    run_on_linux!(BN254CurveAddBatchP(n as u64, p1.as_ptr(), p2.as_ptr(), p3.as_mut_ptr()))
+}
+
+/// Computes `p1.len() / 8` BN254 doublings sharing a single field inversion.
+pub fn bn254_curve_dbl_batch_p_c(p1: &[u64], p2: &mut [u64]) -> i32 {
+    let n = p1.len() / 8;
+    assert!(p2.len() >= n * 8);
+    run_on_linux!(BN254CurveDblBatchP(n as u64, p1.as_ptr(), p2.as_mut_ptr()))
+}
+
+/// Computes `p1.len() / 12` BLS12-381 additions sharing a single field inversion.
+pub fn bls12_381_curve_add_batch_p_c(p1: &[u64], p2: &[u64], p3: &mut [u64]) -> i32 {
+    let n = p1.len() / 12;
+    assert!(p2.len() >= n * 12 && p3.len() >= n * 12);
+    run_on_linux!(BLS12_381CurveAddBatchP(n as u64, p1.as_ptr(), p2.as_ptr(), p3.as_mut_ptr()))
+}
+
+/// Computes `p1.len() / 12` BLS12-381 doublings sharing a single field inversion.
+pub fn bls12_381_curve_dbl_batch_p_c(p1: &[u64], p2: &mut [u64]) -> i32 {
+    let n = p1.len() / 12;
+    assert!(p2.len() >= n * 12);
+    run_on_linux!(BLS12_381CurveDblBatchP(n as u64, p1.as_ptr(), p2.as_mut_ptr()))
+}
+
+/// Returns true if the field batch functions run on the AVX-512 IFMA kernel.
+pub fn field_batch_ifma_supported_c() -> bool {
+    run_on_linux!(FieldBatchIfmaSupported()) != 0
+}
+
+/// Computes `r[i] = a[i] op b[i]` over `a.len() / 4` secp256k1 Fp elements, `op` being one of
+/// `FIELD_BATCH_ADD`, `FIELD_BATCH_MUL` or `FIELD_BATCH_SQUARE` (`b` is ignored when squaring).
+pub fn secp256k1_fp_batch_c(op: u64, a: &[u64], b: &[u64], r: &mut [u64]) -> i32 {
+    let n = a.len() / 4;
+    assert!(r.len() >= n * 4 && (op == FIELD_BATCH_SQUARE || b.len() >= n * 4));
+    run_on_linux!(Secp256k1FpBatch(op, n as u64, a.as_ptr(), b.as_ptr(), r.as_mut_ptr()))
+}
+
+/// Computes `r[i] = a[i] op b[i]` over `a.len() / 4` BN254 Fp elements.
+pub fn bn254_fp_batch_c(op: u64, a: &[u64], b: &[u64], r: &mut [u64]) -> i32 {
+    let n = a.len() / 4;
+    assert!(r.len() >= n * 4 && (op == FIELD_BATCH_SQUARE || b.len() >= n * 4));
+    run_on_linux!(BN254FpBatch(op, n as u64, a.as_ptr(), b.as_ptr(), r.as_mut_ptr()))
+}
+
+/// Computes `r[i] = a[i] op b[i]` over `a.len() / 6` BLS12-381 Fp elements.
+pub fn bls12_381_fp_batch_c(op: u64, a: &[u64], b: &[u64], r: &mut [u64]) -> i32 {
+    let n = a.len() / 6;
+    assert!(r.len() >= n * 6 && (op == FIELD_BATCH_SQUARE || b.len() >= n * 6));
+    run_on_linux!(BLS12_381FpBatch(op, n as u64, a.as_ptr(), b.as_ptr(), r.as_mut_ptr()))
+}
+
 pub fn secp256k1_fp_inv_c(params: &[u64], result: &mut [u64]) -> i32 {
     run_on_linux!(InverseFpEc(&params[0], &mut result[0]))
 }
@@ -44,6 +107,18 @@ pub fn secp256k1_fp_parity_sqrt_c(params: &[u64], parity: u64, result: &mut [u64
     run_on_linux!(SqrtFpEcParity(&params[0], parity, &mut result[0]))
 }
 
+pub fn secp256r1_fp_inv_c(params: &[u64], result: &mut [u64]) -> i32 {
+    run_on_linux!(Secp256r1FpInv(&params[0], &mut result[0]))
+}
+
+pub fn secp256r1_fn_inv_c(params: &[u64], result: &mut [u64]) -> i32 {
+    run_on_linux!(Secp256r1FnInv(&params[0], &mut result[0]))
+}
+
+pub fn secp256r1_fp_parity_sqrt_c(params: &[u64], parity: u64, result: &mut [u64]) -> i32 {
+    run_on_linux!(Secp256r1FpSqrt(&params[0], parity, &mut result[0]))
+}
+
 pub fn inverse_fp_ec_c(params: &[u64; 32], result: &mut [u64; 32]) -> i32 {
     run_on_linux!(InverseFpEc(&params[0], &mut result[0]))
 }
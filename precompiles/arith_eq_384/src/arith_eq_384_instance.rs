@@ -158,6 +158,17 @@ impl ArithEq384Collector {
     pub fn new(num_operations: u64, collect_skipper: CollectSkipper) -> Self {
         Self { inputs: Vec::new(), num_operations, collect_skipper }
     }
+
+    /// Returns the number of operations still to be skipped before collecting.
+    pub fn pending_skip(&self) -> u64 {
+        self.collect_skipper.pending()
+    }
+
+    /// Skips `count` operations that happened before the chunk checkpoint the collection
+    /// resumes from.
+    pub fn fast_forward(&mut self, count: u64) {
+        self.collect_skipper.fast_forward(count);
+    }
 }
 
 impl BusDevice<PayloadType> for ArithEq384Collector {
@@ -162,6 +162,17 @@ impl KeccakfCollector {
             collect_skipper,
         }
     }
+
+    /// Returns the number of operations still to be skipped before collecting.
+    pub fn pending_skip(&self) -> u64 {
+        self.collect_skipper.pending()
+    }
+
+    /// Skips `count` operations that happened before the chunk checkpoint the collection
+    /// resumes from.
+    pub fn fast_forward(&mut self, count: u64) {
+        self.collect_skipper.fast_forward(count);
+    }
 }
 
 impl BusDevice<PayloadType> for KeccakfCollector {
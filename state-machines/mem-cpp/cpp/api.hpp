@@ -15,6 +15,9 @@ extern "C"
     typedef struct MemCountersBusData MemCountersBusData;
     typedef struct MemCheckPoint MemCheckPoint;
     typedef struct MemAlignChunkCounters MemAlignChunkCounters;
+    typedef struct MemAlignCheckPoint MemAlignCheckPoint;
+    typedef struct MemTelemetryEvent MemTelemetryEvent;
+    typedef struct MemShardBoundary MemShardBoundary;
 
     // C-compatible API (opaque to Rust)
     MemCountAndPlan *create_mem_count_and_plan(void);
@@ -32,6 +35,22 @@ extern "C"
     const MemAlignChunkCounters *get_mem_align_counters(MemCountAndPlan *mcp, uint32_t &count);
     const MemAlignChunkCounters *get_mem_align_total_counters(MemCountAndPlan *mcp);
 
+    // Mem align instances planned on plan phase, instance_type is one of MEM_ALIGN_xxx_ID
+    uint32_t get_mem_align_segment_count(MemCountAndPlan *mcp, uint32_t instance_type);
+    const MemAlignCheckPoint *get_mem_align_segment_check_points(MemCountAndPlan *mcp, uint32_t instance_type, uint32_t segment_id, uint32_t &count);
+
+    // Sharded mode: count and plan only addresses in [from_addr, to_addr], must be called
+    // before execute. After count phase, boundaries (MEM_TYPES) of this shard are published,
+    // and plan phase waits the accumulated boundaries of all previous shards.
+    void set_mem_shard(MemCountAndPlan *mcp, uint32_t from_addr, uint32_t to_addr, bool count_mem_align);
+    const MemShardBoundary *wait_mem_shard_counted(MemCountAndPlan *mcp);
+    void set_mem_shard_previous(MemCountAndPlan *mcp, const MemShardBoundary *previous);
+    uint32_t get_mem_shard_first_segment_id(MemCountAndPlan *mcp, uint32_t mem_id);
+
+    // Always-on telemetry, drain events of all threads (not sorted by time)
+    uint32_t drain_mem_telemetry(MemCountAndPlan *mcp, MemTelemetryEvent *events, uint32_t max_events);
+    uint64_t get_mem_telemetry_dropped(MemCountAndPlan *mcp);
+
     // Additional functions for memory statistics
     uint64_t get_mem_stats_len(MemCountAndPlan * mcp);
     uint64_t get_mem_stats_ptr(MemCountAndPlan * mcp);
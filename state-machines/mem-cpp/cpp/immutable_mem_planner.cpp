@@ -1,4 +1,5 @@
 #include "immutable_mem_planner.hpp"
+#include "mem_telemetry.hpp"
 
 ImmutableMemPlanner::ImmutableMemPlanner(uint32_t rows, uint32_t from_addr, uint32_t mb_size, bool intermediate_rows):
     rows_by_segment(rows),
@@ -94,6 +95,7 @@ void ImmutableMemPlanner::close_segment() {
     #endif
 
     segments.emplace_back(current_segment);
+    mem_telemetry_event(MEM_EVENT_SEGMENT_CLOSED, segments.size() - 1);
     #ifdef MEM_CHECK_POINT_MAP
     current_segment = new MemSegment();
     #else
@@ -202,6 +204,18 @@ uint32_t ImmutableMemPlanner::add_intermediates(uint32_t addr) {
     return count;
 }
 
+void ImmutableMemPlanner::set_previous(uint64_t previous_rows, uint32_t chunk_id, uint32_t addr, uint32_t count) {
+    uint32_t rows_offset = previous_rows % rows_by_segment;
+    rows_available = rows_by_segment - rows_offset;
+    if (rows_offset == 0 && previous_rows > 0 && chunk_id != NO_CHUNK_ID) {
+        // previous shard closed its last segment, this segment starts with the reference
+        // of last address as open_segment does.
+        set_reference(chunk_id, addr);
+        reference_skip = count;
+        add_chunk_to_segment(chunk_id, addr, 0, count);
+    }
+}
+
 void ImmutableMemPlanner::collect_segments(MemSegments &mem_segments) {
     uint32_t segment_id = 0;
     for (auto segment :segments) {
@@ -82,6 +82,7 @@ public:
     void collect_segments(MemSegments &mem_segments);
     void stats();
     void set_last_addr(uint32_t addr) { initial_last_addr = addr; }    
+    void set_previous(uint64_t previous_rows, uint32_t chunk_id, uint32_t addr, uint32_t count);
 };
 
 void ImmutableMemPlanner::add_to_current_segment(uint32_t chunk_id, uint32_t addr, uint32_t count) {
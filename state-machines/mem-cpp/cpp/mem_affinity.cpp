@@ -0,0 +1,201 @@
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "mem_affinity.hpp"
+
+#define SYSFS_NODE_PATH "/sys/devices/system/node"
+#define SYSFS_CPU_PATH "/sys/devices/system/cpu"
+
+MemAffinity::MemAffinity() : enabled(false), node(MEM_AFFINITY_NO_NODE) {
+}
+
+void MemAffinity::configure_from_env() {
+    configure(getenv(MEM_AFFINITY_ENV), getenv(MEM_AFFINITY_NODE_ENV));
+}
+
+void MemAffinity::configure(const char *policy, const char *node_policy) {
+    enabled = false;
+    node = MEM_AFFINITY_NO_NODE;
+    cpus.clear();
+
+    if (policy == nullptr || policy[0] == 0 || strcmp(policy, "none") == 0) {
+        return;
+    }
+
+    std::vector<int> allowed = get_allowed_cpus();
+    if (strcmp(policy, "auto") == 0) {
+        if (node_policy != nullptr && node_policy[0] != 0) {
+            node = atoi(node_policy);
+        } else {
+            node = get_cpu_node(sched_getcpu());
+        }
+        if (node == MEM_AFFINITY_NO_NODE) {
+            // no numa information (sysfs not available), nothing to place
+            return;
+        }
+        for (int cpu: get_node_cpus(node)) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (cpus.empty()) {
+            std::ostringstream msg;
+            msg << "ERROR: MemAffinity no allowed cpus on node " << node;
+            throw std::runtime_error(msg.str());
+        }
+    } else {
+        cpus = parse_cpu_list(policy);
+        for (int cpu: cpus) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) == allowed.end()) {
+                std::ostringstream msg;
+                msg << "ERROR: MemAffinity cpu " << cpu << " not allowed (" << MEM_AFFINITY_ENV << "=" << policy << ")";
+                throw std::runtime_error(msg.str());
+            }
+        }
+        node = cpus.empty() ? MEM_AFFINITY_NO_NODE : get_cpu_node(cpus[0]);
+    }
+    enabled = !cpus.empty();
+}
+
+int MemAffinity::get_cpu(uint32_t slot) const {
+    if (!enabled) {
+        return MEM_AFFINITY_NO_CPU;
+    }
+    return cpus[slot % cpus.size()];
+}
+
+bool MemAffinity::pin(uint32_t slot) const {
+    if (!enabled) {
+        return false;
+    }
+    return pin_current_thread({get_cpu(slot)});
+}
+
+bool MemAffinity::pin_node() const {
+    if (!enabled) {
+        return false;
+    }
+    return pin_current_thread(cpus);
+}
+
+std::string MemAffinity::to_string() const {
+    if (!enabled) {
+        return "none";
+    }
+    std::ostringstream out;
+    out << "node " << node << " cpus";
+    for (uint32_t index = 0; index < cpus.size(); ++index) {
+        out << (index ? "," : " ") << cpus[index];
+    }
+    return out.str();
+}
+
+std::vector<int> MemAffinity::parse_cpu_list(const char *list) {
+    // format used by sysfs and taskset: "0-3,8,10-11"
+    std::vector<int> result;
+    const char *cursor = list;
+    while (*cursor) {
+        char *end;
+        long from = strtol(cursor, &end, 10);
+        long to = from;
+        if (end == cursor || from < 0) {
+            std::ostringstream msg;
+            msg << "ERROR: MemAffinity invalid cpu list '" << list << "'";
+            throw std::runtime_error(msg.str());
+        }
+        cursor = end;
+        if (*cursor == '-') {
+            ++cursor;
+            to = strtol(cursor, &end, 10);
+            if (end == cursor || to < from) {
+                std::ostringstream msg;
+                msg << "ERROR: MemAffinity invalid cpu range on list '" << list << "'";
+                throw std::runtime_error(msg.str());
+            }
+            cursor = end;
+        }
+        for (long cpu = from; cpu <= to; ++cpu) {
+            result.push_back((int) cpu);
+        }
+        while (*cursor == ',' || *cursor == '\n' || *cursor == ' ') {
+            ++cursor;
+        }
+    }
+    return result;
+}
+
+std::vector<int> MemAffinity::get_node_cpus(int node) {
+    char filename[256];
+    snprintf(filename, sizeof(filename), SYSFS_NODE_PATH "/node%d/cpulist", node);
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        return {};
+    }
+    char line[4096];
+    std::vector<int> result;
+    if (fgets(line, sizeof(line), fp) != NULL) {
+        result = parse_cpu_list(line);
+    }
+    fclose(fp);
+    return result;
+}
+
+std::vector<int> MemAffinity::get_allowed_cpus() {
+    std::vector<int> result;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        perror("sched_getaffinity");
+        return result;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &mask)) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+int MemAffinity::get_cpu_node(int cpu) {
+    if (cpu < 0) {
+        return MEM_AFFINITY_NO_NODE;
+    }
+    // each cpu directory has a link "nodeN" to its numa node
+    char path[256];
+    snprintf(path, sizeof(path), SYSFS_CPU_PATH "/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (dir == NULL) {
+        return MEM_AFFINITY_NO_NODE;
+    }
+    int node = MEM_AFFINITY_NO_NODE;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+bool MemAffinity::pin_current_thread(const std::vector<int> &cpus) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu: cpus) {
+        CPU_SET(cpu, &mask);
+    }
+    int res = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (res != 0) {
+        fprintf(stderr, "MemAffinity: pthread_setaffinity_np error %d\n", res);
+        return false;
+    }
+    return true;
+}
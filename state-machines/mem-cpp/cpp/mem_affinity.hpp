@@ -0,0 +1,62 @@
+#ifndef __MEM_AFFINITY_HPP__
+#define __MEM_AFFINITY_HPP__
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#include "mem_config.hpp"
+
+// Placement policy of count and plan threads, read from environment:
+//
+//   MEM_CPP_AFFINITY=none         (default) no pinning, threads placed by the OS
+//   MEM_CPP_AFFINITY=auto         pin all threads to cpus of one numa node, discovered
+//                                 through sysfs. Node is MEM_CPP_NODE if defined, otherwise
+//                                 the node of the thread that prepares the planner.
+//   MEM_CPP_AFFINITY=0-3,8,10-11  explicit cpu list, assigned in slot order (round-robin)
+//
+// Thread slots (MEM_*_SLOT in mem_config.hpp) are assigned in order: counters, mem align
+// counter, planners. In this way counters always get different cpus when list has
+// MAX_THREADS or more cpus.
+//
+// Producer placement is not handled here. In mem_test the loader thread is the producer and
+// it is pinned with pin_node(). In the prover the chunks are written to shared memory by the
+// assembly emulator process, and add_chunk is called from the caller thread of the MO runner,
+// pinning it would leave the caller pinned after the run. To keep chunks near the counters,
+// launch the emulator on the same node, e.g. numactl --cpunodebind=N --membind=N with
+// MEM_CPP_AFFINITY=auto MEM_CPP_NODE=N.
+
+#define MEM_AFFINITY_ENV "MEM_CPP_AFFINITY"
+#define MEM_AFFINITY_NODE_ENV "MEM_CPP_NODE"
+
+#define MEM_AFFINITY_NO_NODE -1
+#define MEM_AFFINITY_NO_CPU -1
+
+class MemAffinity {
+private:
+    bool enabled;
+    int node;
+    std::vector<int> cpus;
+public:
+    MemAffinity();
+    void configure(const char *policy, const char *node_policy = nullptr);
+    void configure_from_env();
+    bool is_enabled() const {
+        return enabled;
+    }
+    int get_node() const {
+        return node;
+    }
+    int get_cpu(uint32_t slot) const;
+    bool pin(uint32_t slot) const;
+    bool pin_node() const;
+    std::string to_string() const;
+
+    static std::vector<int> parse_cpu_list(const char *list);
+    static std::vector<int> get_node_cpus(int node);
+    static std::vector<int> get_allowed_cpus();
+    static int get_cpu_node(int cpu);
+    static bool pin_current_thread(const std::vector<int> &cpus);
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "mem_types.hpp"
 #include "mem_context.hpp"
 #include "tools.hpp"
+#include "mem_telemetry.hpp"
 #include <vector>
 #include <assert.h>
 
@@ -133,6 +134,7 @@ void MemAlignCounter::execute_chunk(uint32_t chunk_id, const MemCountersBusData
     if (total_counters_processed > 0) {
         counters.push_back({chunk_id, full_5, full_3, full_2, read_byte, write_byte});
     };
+    mem_telemetry_event(MEM_EVENT_CHUNK_COUNTED, chunk_id);
 }
 
 void MemAlignCounter::debug (void) {
@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "mem_align_planner.hpp"
+#include "mem_telemetry.hpp"
+#include "tools.hpp"
+
+#define ROWS_WRITE_BYTE 3
+#define ROWS_READ_BYTE 2
+#define WORSE_FRAGMENTATION 4   // worse case fragmentation rows per full instance
+
+// Base columns cost by instance
+#define MEM_ALIGN_BCOLS 56
+#define MEM_ALIGN_READ_BYTE_BCOLS 25
+#define MEM_ALIGN_WRITE_BYTE_BCOLS 32
+#define MEM_ALIGN_BYTE_BCOLS 32
+
+static const uint32_t read_byte_costs[MEM_ALIGN_OP_TYPES] = {0, 0, 0, 1, 0};
+static const uint32_t write_byte_costs[MEM_ALIGN_OP_TYPES] = {0, 0, 0, 0, 1};
+static const uint32_t byte_costs[MEM_ALIGN_OP_TYPES] = {0, 0, 0, 1, 1};
+static const uint32_t full_costs[MEM_ALIGN_OP_TYPES] = {5, 3, 2, 2, 3};
+
+MemAlignInstanceCounter::MemAlignInstanceCounter(uint32_t num_rows, const uint32_t costs[MEM_ALIGN_OP_TYPES], const std::vector<uint32_t> &order)
+: instances(0), instances_available(0), order(order), num_rows(num_rows), rows_available(0) {
+    memcpy(this->costs, costs, sizeof(this->costs));
+    memset(skip, 0, sizeof(skip));
+    memset(count, 0, sizeof(count));
+    memset(used, 0, sizeof(used));
+}
+
+void MemAlignInstanceCounter::add_to_instance(uint32_t chunk_id, const uint32_t totals[MEM_ALIGN_OP_TYPES], uint32_t pendings[MEM_ALIGN_OP_TYPES]) {
+    bool updated = false;
+    for (uint32_t i: order) {
+        const uint32_t cost = costs[i];
+        // no cost implies that this operation type is not supported
+        if (cost == 0) continue;
+        while (pendings[i] > 0) {
+            // if there is not enough space even for a single operation, it is necessary to open
+            // a new instance, closing the chunk on current instance if it has data.
+            if (rows_available < cost) {
+                if (updated) {
+                    close_chunk(chunk_id);
+                    updated = false;
+                }
+                if (!close_and_open_instance()) {
+                    // no more instances free
+                    break;
+                }
+            }
+            const uint32_t pending = pendings[i];
+            const uint32_t skip_ops = totals[i] - pending;
+
+            // if there is enough space to add all pending operations, do it.
+            if (cost * pending <= rows_available) {
+                if (count[i] == 0) skip[i] = skip_ops;
+                count[i] += pending;
+                used[i] += pending;
+                rows_available -= cost * pending;
+                pendings[i] = 0;
+                updated = true;
+                break;
+            }
+
+            // not enough rows for all pending operations, but enough for at least one of them
+            const uint32_t partial = rows_available / cost;
+            if (count[i] == 0) skip[i] = skip_ops;
+            count[i] += partial;
+            used[i] += partial;
+            rows_available -= partial * cost;
+            pendings[i] -= partial;
+            updated = true;
+        }
+    }
+    // if any operation was added to the instance, close the chunk for this instance
+    if (updated) {
+        close_chunk(chunk_id);
+    }
+}
+
+void MemAlignInstanceCounter::close_chunk(uint32_t chunk_id) {
+    MemAlignCheckPoint &checkpoint = current.emplace_back();
+    checkpoint.chunk_id = chunk_id;
+    memcpy(checkpoint.skip, skip, sizeof(skip));
+    memcpy(checkpoint.count, count, sizeof(count));
+    memset(skip, 0, sizeof(skip));
+    memset(count, 0, sizeof(count));
+}
+
+bool MemAlignInstanceCounter::close_and_open_instance() {
+    close_instance();
+    return open_new_instance();
+}
+
+bool MemAlignInstanceCounter::open_new_instance() {
+    if (instances_available == 0) {
+        return false;
+    }
+    rows_available = num_rows;
+    --instances_available;
+    current.clear();
+    return true;
+}
+
+void MemAlignInstanceCounter::close_instance() {
+    if (rows_available == num_rows || current.empty()) {
+        return;
+    }
+    segments.emplace_back(std::move(current));
+    current.clear();
+}
+
+MemAlignPlanner::MemAlignPlanner()
+: elapsed_us(0),
+  instances{
+    MemAlignInstanceCounter(MEM_ALIGN_READ_BYTE_ROWS, read_byte_costs, {3}),
+    MemAlignInstanceCounter(MEM_ALIGN_WRITE_BYTE_ROWS, write_byte_costs, {4}),
+    MemAlignInstanceCounter(MEM_ALIGN_BYTE_ROWS, byte_costs, {4, 3}),
+    MemAlignInstanceCounter(MEM_ALIGN_ROWS, full_costs, {0, 1, 2, 3, 4})
+  } {
+}
+
+void MemAlignPlanner::execute(const MemAlignChunkCounters *counters, uint32_t count, const MemAlignChunkCounters &totals) {
+    uint64_t init = get_usec();
+    if (count > 0) {
+        const uint32_t full_rows = totals.full_2 * 2 + totals.full_3 * 3 + totals.full_5 * 5;
+        calculate_strategy(full_rows, totals.read_byte, totals.write_byte);
+        for (uint32_t index = 0; index < count; ++index) {
+            add_chunk(counters[index]);
+        }
+        for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+            instances[instance_type].close_instance();
+            for (uint32_t segment_id = 0; segment_id < instances[instance_type].segments.size(); ++segment_id) {
+                mem_telemetry_event(MEM_EVENT_SEGMENT_CLOSED, segment_id);
+            }
+        }
+    }
+    elapsed_us = get_usec() - init;
+}
+
+void MemAlignPlanner::add_chunk(const MemAlignChunkCounters &counters) {
+    const uint32_t totals[MEM_ALIGN_OP_TYPES] = {counters.full_5, counters.full_3, counters.full_2, counters.read_byte, counters.write_byte};
+    uint32_t pendings[MEM_ALIGN_OP_TYPES];
+    memcpy(pendings, totals, sizeof(pendings));
+    for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+        instances[instance_type].add_to_instance(counters.chunk_id, totals, pendings);
+    }
+    check_pendings(pendings);
+}
+
+void MemAlignPlanner::check_pendings(const uint32_t pendings[MEM_ALIGN_OP_TYPES]) {
+    for (uint32_t i = 0; i < MEM_ALIGN_OP_TYPES; ++i) {
+        if (pendings[i] == 0) continue;
+        const char *names[MEM_ALIGN_INSTANCE_TYPES] = {"ReadByte", "WriteByte", "Byte", "Full"};
+        for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+            MemAlignInstanceCounter &instance = instances[instance_type];
+            printf("[%s] Instances:%d/%d Rows:%d/%d used:(%d,%d,%d,%d,%d)\n", names[instance_type],
+                instance.get_instances_available(), instance.get_instances(), instance.rows_available,
+                instance.num_rows, instance.used[0], instance.used[1], instance.used[2], instance.used[3],
+                instance.used[4]);
+        }
+        printf("[Pending] (F5,F3,F2,RB,WB) (%d,%d,%d,%d,%d)\n", pendings[0], pendings[1], pendings[2],
+            pendings[3], pendings[4]);
+        throw std::runtime_error("MemAlignPlanner: some counters are pending");
+    }
+}
+
+void MemAlignPlanner::calculate_strategy(uint32_t full_rows, uint32_t read_byte, uint32_t write_byte) {
+    MemAlignInstanceCounter &read_byte_instance = instances[MEM_ALIGN_READ_BYTE_ID];
+    MemAlignInstanceCounter &write_byte_instance = instances[MEM_ALIGN_WRITE_BYTE_ID];
+    MemAlignInstanceCounter &byte_instance = instances[MEM_ALIGN_BYTE_ID];
+    MemAlignInstanceCounter &full_instance = instances[MEM_ALIGN_FULL_ID];
+
+    const uint32_t read_byte_instance_cost = MEM_ALIGN_READ_BYTE_BCOLS * read_byte_instance.num_rows;
+    const uint32_t write_byte_instance_cost = MEM_ALIGN_WRITE_BYTE_BCOLS * write_byte_instance.num_rows;
+    const uint32_t byte_instance_cost = MEM_ALIGN_BYTE_BCOLS * byte_instance.num_rows;
+    const uint32_t full_instance_cost = MEM_ALIGN_BCOLS * full_instance.num_rows;
+
+    uint32_t byte_instances = 0;
+    uint32_t read_byte_instances = read_byte / read_byte_instance.num_rows;
+    uint32_t write_byte_instances = write_byte / write_byte_instance.num_rows;
+    uint32_t full_instances = (full_rows / full_instance.num_rows) + ((full_rows % full_instance.num_rows) > 0 ? 1 : 0);
+
+    const uint32_t p_read_byte = read_byte % read_byte_instance.num_rows;
+    const uint32_t p_write_byte = write_byte % write_byte_instance.num_rows;
+
+    // calculate the worse case of fragmentation at end of instance
+    const uint32_t fragmentation_rows = WORSE_FRAGMENTATION * full_instances;
+    const uint32_t max_full_free_rows = (full_instances * full_instance.num_rows) - full_rows;
+
+    // for security reasons, the worst case was that last 4 rows are lost.
+    const uint32_t full_free_rows = max_full_free_rows > fragmentation_rows ? max_full_free_rows - fragmentation_rows : 0;
+    const uint32_t full_free_byte = full_free_rows / ROWS_WRITE_BYTE;
+
+    if ((ROWS_READ_BYTE * p_read_byte + ROWS_WRITE_BYTE * p_write_byte) <= full_free_rows) {
+        // no need extra instances, use free space on full mem_align
+    } else if ((ROWS_WRITE_BYTE * p_write_byte) <= full_free_rows) {
+        // all writes fit in the free rows, only need one instance for pending reads.
+        read_byte_instances += 1;
+    } else if ((ROWS_READ_BYTE * p_read_byte) <= full_free_rows) {
+        // all reads fit in the free rows, only need one instance for pending writes.
+        write_byte_instances += 1;
+    } else if ((p_write_byte + p_read_byte) <= byte_instance.num_rows) {
+        // all pending reads and writes fit in one read-write byte instance.
+        byte_instances += 1;
+    } else if ((p_read_byte + p_write_byte - full_free_byte) <= byte_instance.num_rows &&
+               byte_instance_cost <= (read_byte_instance_cost + write_byte_instance_cost)) {
+        // a part of reads fit in the full free rows, the rest of reads and all pending writes
+        // fit in one byte instance.
+        byte_instances += 1;
+    } else if ((p_read_byte * ROWS_READ_BYTE + p_write_byte * ROWS_WRITE_BYTE) < (full_free_rows + full_instance.num_rows - WORSE_FRAGMENTATION) &&
+               full_instance_cost <= (read_byte_instance_cost + write_byte_instance_cost)) {
+        // all pending reads and writes fit on last free rows plus one new full instance.
+        full_instances += 1;
+    } else {
+        // more than one instance is needed for pending reads and writes, better use two
+        // specific and cheaper instances.
+        read_byte_instances += 1;
+        write_byte_instances += 1;
+    }
+    byte_instance.set_instances(byte_instances);
+    read_byte_instance.set_instances(read_byte_instances);
+    write_byte_instance.set_instances(write_byte_instances);
+    full_instance.set_instances(full_instances);
+}
+
+const MemAlignCheckPoint *MemAlignPlanner::get_check_points(uint32_t instance_type, uint32_t segment_id, uint32_t &count) {
+    if (instance_type >= MEM_ALIGN_INSTANCE_TYPES || segment_id >= instances[instance_type].segments.size()) {
+        count = 0;
+        return nullptr;
+    }
+    const std::vector<MemAlignCheckPoint> &segment = instances[instance_type].segments[segment_id];
+    count = segment.size();
+    return segment.data();
+}
+
+void MemAlignPlanner::stats() {
+    printf("MemAlignPlanner segments RB:%ld WB:%ld B:%ld F:%ld T(ms):%04.2f\n",
+        instances[MEM_ALIGN_READ_BYTE_ID].segments.size(), instances[MEM_ALIGN_WRITE_BYTE_ID].segments.size(),
+        instances[MEM_ALIGN_BYTE_ID].segments.size(), instances[MEM_ALIGN_FULL_ID].segments.size(),
+        elapsed_us / 1000.0);
+}
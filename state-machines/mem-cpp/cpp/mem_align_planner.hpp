@@ -0,0 +1,73 @@
+#ifndef __MEM_ALIGN_PLANNER_HPP__
+#define __MEM_ALIGN_PLANNER_HPP__
+
+#include <stdint.h>
+#include <vector>
+#include <stdexcept>
+
+#include "mem_config.hpp"
+#include "mem_align_counter.hpp"
+
+// operation types: full_5, full_3, full_2, read_byte, write_byte
+#define MEM_ALIGN_OP_TYPES 5
+
+// Checkpoint of one chunk inside a mem align instance, for each operation type the
+// operations skipped (consumed by previous instances) and the operations collected.
+struct MemAlignCheckPoint {
+    uint32_t chunk_id;
+    uint32_t skip[MEM_ALIGN_OP_TYPES];
+    uint32_t count[MEM_ALIGN_OP_TYPES];
+};
+
+// Emulates the "fill" of instances of one mem align type using the chunk counters, same
+// algorithm of MemAlignInstanceCounter (mem-common) used by rust.
+class MemAlignInstanceCounter {
+private:
+    uint32_t instances;
+    uint32_t instances_available;
+    uint32_t costs[MEM_ALIGN_OP_TYPES];
+    uint32_t skip[MEM_ALIGN_OP_TYPES];
+    uint32_t count[MEM_ALIGN_OP_TYPES];
+    std::vector<uint32_t> order;
+    std::vector<MemAlignCheckPoint> current;
+    void close_chunk(uint32_t chunk_id);
+    bool close_and_open_instance();
+    bool open_new_instance();
+public:
+    uint32_t num_rows;
+    uint32_t rows_available;
+    uint32_t used[MEM_ALIGN_OP_TYPES];
+    std::vector<std::vector<MemAlignCheckPoint>> segments;
+    MemAlignInstanceCounter(uint32_t num_rows, const uint32_t costs[MEM_ALIGN_OP_TYPES], const std::vector<uint32_t> &order);
+    void set_instances(uint32_t instances) {
+        this->instances = instances;
+        instances_available = instances;
+    }
+    uint32_t get_instances() {
+        return instances;
+    }
+    uint32_t get_instances_available() {
+        return instances_available;
+    }
+    void add_to_instance(uint32_t chunk_id, const uint32_t totals[MEM_ALIGN_OP_TYPES], uint32_t pendings[MEM_ALIGN_OP_TYPES]);
+    void close_instance();
+};
+
+class MemAlignPlanner {
+private:
+    uint32_t elapsed_us;
+    void calculate_strategy(uint32_t full_rows, uint32_t read_byte, uint32_t write_byte);
+    void add_chunk(const MemAlignChunkCounters &counters);
+    void check_pendings(const uint32_t pendings[MEM_ALIGN_OP_TYPES]);
+public:
+    MemAlignInstanceCounter instances[MEM_ALIGN_INSTANCE_TYPES];
+    MemAlignPlanner();
+    void execute(const MemAlignChunkCounters *counters, uint32_t count, const MemAlignChunkCounters &totals);
+    uint32_t size(uint32_t instance_type) {
+        return instances[instance_type].segments.size();
+    }
+    const MemAlignCheckPoint *get_check_points(uint32_t instance_type, uint32_t segment_id, uint32_t &count);
+    void stats();
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __MEM_CONFIG_HPP__
 #define __MEM_CONFIG_HPP__
 
+#include <stdint.h>
+
 #define ROM_ADDR 0x80000000
 #define INPUT_ADDR 0x90000000
 #define RAM_ADDR 0xA0000000
@@ -8,7 +10,11 @@
 #define CHUNK_SIZE_BITS 18
 #define CHUNK_SIZE (1 << CHUNK_SIZE_BITS)
 #define MAX_LOCATORS 2048
+// MAX_MEM_PLANNERS, THREAD_BITS and rows by instance could be overridden on the build of
+// tests (mem_oracle_test) to verify other configurations.
+#ifndef MAX_MEM_PLANNERS
 #define MAX_MEM_PLANNERS 8
+#endif
 #define USE_ADDR_COUNT_TABLE
 #define MAX_SEGMENTS 512
 // #define MEM_PLANNER_STATS
@@ -24,18 +30,55 @@
 #define INPUT_ID 1
 #define RAM_ID 2
 
+#ifndef RAM_ROWS
 #define RAM_ROWS (1 << 22)
+#endif
+#ifndef ROM_ROWS
 #define ROM_ROWS (1 << 21)
+#endif
+#ifndef INPUT_ROWS
 #define INPUT_ROWS (1 << 21)
+#endif
 #define MEM_ROWS (1 << 22)
+
+// mem align instance types, in the order that instances are filled
+#define MEM_ALIGN_INSTANCE_TYPES 4
+#define MEM_ALIGN_READ_BYTE_ID 0
+#define MEM_ALIGN_WRITE_BYTE_ID 1
+#define MEM_ALIGN_BYTE_ID 2
+#define MEM_ALIGN_FULL_ID 3
+
+#ifndef MEM_ALIGN_ROWS
+#define MEM_ALIGN_ROWS (1 << 21)
+#endif
+#ifndef MEM_ALIGN_BYTE_ROWS
+#define MEM_ALIGN_BYTE_ROWS (1 << 22)
+#endif
+#ifndef MEM_ALIGN_READ_BYTE_ROWS
+#define MEM_ALIGN_READ_BYTE_ROWS (1 << 22)
+#endif
+#ifndef MEM_ALIGN_WRITE_BYTE_ROWS
+#define MEM_ALIGN_WRITE_BYTE_ROWS (1 << 22)
+#endif
 #define MAX_CHUNKS 8192     // 2^13 * 2^18 = 2^31
 
 // THREAD_BITS >= 1
+#ifndef THREAD_BITS
 #define THREAD_BITS 2
+#endif
 #define ADDR_LOW_BITS (THREAD_BITS + 3)
 #define MAX_THREADS (1 << THREAD_BITS)
 #define ADDR_MASK ((MAX_THREADS - 1) * 8)
 
+// Thread slots, used to identify threads for affinity and telemetry
+#define MEM_COUNTER_SLOT(index) (index)
+#define MEM_ALIGN_COUNTER_SLOT (MAX_THREADS)
+#define MEM_PLANNER_SLOT(index) (MAX_THREADS + 1 + (index))
+#define MEM_ALIGN_PLANNER_SLOT (MEM_PLANNER_SLOT(MAX_MEM_PLANNERS + 3))
+#define MEM_PLANNER_SLOTS (MAX_MEM_PLANNERS + 4)
+#define MEM_MAIN_SLOT (MEM_PLANNER_SLOT(MEM_PLANNER_SLOTS))
+#define MEM_SLOTS (MEM_MAIN_SLOT + 1)
+
 #define MAX_PAGES 12
 #define ADDR_PAGE_BITS (23 - THREAD_BITS)
 #define ADDR_PAGE_SIZE (1 << ADDR_PAGE_BITS)
@@ -58,4 +101,21 @@
 #define MEM_WRITE_FLAG 0x10
 #define MEM_WRITE_BYTE_CLEAR_FLAG 0x20
 
+// On test builds (MEM_TEST_INTERLEAVE) threads call a hook on critical points to force
+// random interleavings, the hook is defined by the test. Some points are named, so the
+// test can stall them on purpose to open a specific window.
+#define MEM_POINT_ANY 0
+#define MEM_POINT_LOCATOR_PUSH 1        // locator written, not yet published
+#define MEM_POINT_LOCATORS_COMPLETED 2  // all locators published, not yet completed
+#define MEM_POINT_LOCATOR_WAIT 3        // planner found no locator, before checking completed
+#define MEM_POINTS 4
+
+#ifdef MEM_TEST_INTERLEAVE
+void mem_test_interleave(uint32_t point);
+#define MEM_INTERLEAVE_AT(point) mem_test_interleave(point)
+#else
+#define MEM_INTERLEAVE_AT(point)
+#endif
+#define MEM_INTERLEAVE() MEM_INTERLEAVE_AT(MEM_POINT_ANY)
+
 #endif
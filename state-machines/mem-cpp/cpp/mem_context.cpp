@@ -2,6 +2,7 @@
 #include "mem_types.hpp"
 #include "mem_config.hpp"
 #include "mem_locators.hpp"
+#include "mem_telemetry.hpp"
 #include <condition_variable>
 #include <mutex>
 #include <assert.h>
@@ -27,11 +28,14 @@ const MemChunk *MemContext::get_chunk(uint32_t thread_id, uint32_t chunk_id, int
     uint64_t t_ini = get_usec();
 
     // semaphore used for synchronization, means that a new chunk data is available
+    mem_telemetry_event(MEM_EVENT_WAIT_START, chunk_id);
     while (sem_wait(&semaphores[thread_id]) < 0) {
         if (errno != EINTR) {
             throw std::runtime_error("MemContext::get_chunk: sem_wait error");
         }
     }
+    mem_telemetry_event(MEM_EVENT_WAIT_END, chunk_id);
+    MEM_INTERLEAVE();
 
     if (chunk_id < chunks_count.load(std::memory_order_acquire)) {
         #ifdef COUNT_CHUNK_STATS
@@ -1,4 +1,5 @@
 #include <memory>
+#include <sched.h>
 #include "api.hpp"
 #include "tools.hpp"
 #include "mem_count_and_plan.hpp"
@@ -7,6 +8,8 @@
 MemCountAndPlan::MemCountAndPlan() {
     context = std::make_shared<MemContext>();
     sem_init(&sem_mem_align_created, 0, 0);
+    sem_init(&sem_shard_counted, 0, 0);
+    sem_init(&sem_shard_previous, 0, 0);
 #ifdef MEM_STATS_ACTIVE
     mem_stats = new MemStats();
 #endif
@@ -16,6 +19,8 @@ MemCountAndPlan::~MemCountAndPlan() {
     
     // Call clear
     clear();
+    sem_destroy(&sem_shard_counted);
+    sem_destroy(&sem_shard_previous);
 
 #ifdef MEM_STATS_ACTIVE
     delete mem_stats;
@@ -52,6 +57,8 @@ void MemCountAndPlan::prepare() {
         delete worker;
     }
     count_workers.clear();
+
+    affinity.configure_from_env();
     
     for (size_t i = 0; i < MAX_THREADS; ++i) {
         count_workers.push_back(new MemCounter(i, context));
@@ -60,7 +67,9 @@ void MemCountAndPlan::prepare() {
         count_workers[i]->mem_stats = mem_stats;
 #endif // MEM_STATS_ACTIVE
     }
+    first_touch_counters();
     mem_align_counter = std::make_unique<MemAlignCounter>(context);
+    mem_align_planner = std::make_unique<MemAlignPlanner>();
     plan_workers.clear();
     plan_workers.reserve(MAX_MEM_PLANNERS);
     rom_data_planner = std::make_unique<ImmutableMemPlanner>(ROM_ROWS, ROM_ADDR, 128, false);
@@ -73,6 +82,91 @@ void MemCountAndPlan::prepare() {
     t_prepare_us = get_usec() - init;
 }
 
+void MemCountAndPlan::first_touch_counters() {
+    if (!affinity.is_enabled()) {
+        for (auto* worker : count_workers) {
+            worker->first_touch();
+        }
+        return;
+    }
+    // tables are touched from a thread pinned on the same cpu that the counter will use,
+    // in this way the pages are allocated on the numa node of this cpu.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < MAX_THREADS; ++i) {
+        threads.emplace_back([this, i](){
+            affinity.pin(MEM_COUNTER_SLOT(i));
+            count_workers[i]->first_touch();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void MemCountAndPlan::setup_thread(uint32_t slot) {
+    affinity.pin(slot);
+    telemetry.attach(slot);
+    mem_telemetry_event(MEM_EVENT_THREAD_CPU, sched_getcpu());
+}
+
+void MemCountAndPlan::set_shard(uint32_t from_addr, uint32_t to_addr, bool count_mem_align) {
+    if (parallel_execute) {
+        throw std::runtime_error("MemCountAndPlan::set_shard: called after execute");
+    }
+    shard = std::make_unique<MemShard>(from_addr, to_addr, count_mem_align);
+    for (auto* worker : count_workers) {
+        worker->set_window(from_addr, to_addr);
+    }
+}
+
+void MemCountAndPlan::shard_exchange() {
+    // publish boundaries of this shard and wait boundaries of previous shards
+    shard->calculate_boundaries(count_workers);
+    sem_post(&sem_shard_counted);
+
+    mem_telemetry_event(MEM_EVENT_WAIT_START);
+    while (sem_wait(&sem_shard_previous) < 0) {
+        if (errno != EINTR) {
+            throw std::runtime_error("MemCountAndPlan::shard_exchange: sem_wait error");
+        }
+    }
+    mem_telemetry_event(MEM_EVENT_WAIT_END);
+
+    uint32_t rows_offset = shard->get_rows_offset(RAM_ID);
+    quick_mem_planner->set_rows_offset(rows_offset);
+    for (auto &plan_worker : plan_workers) {
+        plan_worker.set_rows_offset(rows_offset);
+    }
+    const MemShardBoundary &rom = shard->previous[ROM_ID];
+    rom_data_planner->set_previous(rom.rows, rom.last_chunk_id, rom.last_addr, rom.last_count);
+    const MemShardBoundary &input = shard->previous[INPUT_ID];
+    input_data_planner->set_previous(input.rows, input.last_chunk_id, input.last_addr, input.last_count);
+}
+
+const MemShardBoundary *MemCountAndPlan::wait_shard_counted() {
+    // without set_shard nobody posts the semaphore
+    if (shard == nullptr) {
+        return nullptr;
+    }
+    while (sem_wait(&sem_shard_counted) < 0) {
+        if (errno != EINTR) {
+            throw std::runtime_error("MemCountAndPlan::wait_shard_counted: sem_wait error");
+        }
+    }
+    sem_post(&sem_shard_counted);
+    return shard->boundaries;
+}
+
+void MemCountAndPlan::set_shard_previous(const MemShardBoundary *previous) {
+    if (shard == nullptr) {
+        throw std::runtime_error("MemCountAndPlan::set_shard_previous: not in sharded mode");
+    }
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        shard->previous[mem_id] = previous[mem_id];
+    }
+    sem_post(&sem_shard_previous);
+}
+
 void MemCountAndPlan::add_chunk(MemCountersBusData *chunk_data, uint32_t chunk_size) {
     context->add_chunk(chunk_data, chunk_size);
 }
@@ -82,6 +176,7 @@ void MemCountAndPlan::execute(void) {
 }
 
 void MemCountAndPlan::detach_execute_mem_align_counter() {
+    setup_thread(MEM_ALIGN_COUNTER_SLOT);
     mem_align_counter->execute();
 }   
 void MemCountAndPlan::count_phase() {
@@ -95,16 +190,28 @@ void MemCountAndPlan::count_phase() {
     uint64_t init = t_init_us = get_usec();
     std::vector<std::thread> threads;
     context->init();
+    mem_telemetry_event(MEM_EVENT_COUNT_PHASE_BEGIN);
 
+    MemTelemetryPhase running_counters(MAX_THREADS);
     for (int i = 0; i < MAX_THREADS; ++i) {
-        threads.emplace_back([this, i](){count_workers[i]->execute();});
+        threads.emplace_back([this, i, &running_counters](){
+            setup_thread(MEM_COUNTER_SLOT(i));
+            count_workers[i]->execute();
+            running_counters.done();
+        });
     }
     // threads.emplace_back([this](){ mem_align_counter->execute();});
-    mem_align_execute = std::make_unique<std::thread>(&MemCountAndPlan::detach_execute_mem_align_counter, this);
+    if (!shard || shard->count_mem_align) {
+        // on sharded mode, mem align counters are calculated only by one shard
+        mem_align_execute = std::make_unique<std::thread>(&MemCountAndPlan::detach_execute_mem_align_counter, this);
+    }
     if (sem_post(&sem_mem_align_created) != 0) {
         perror("sem_post");
     }
 
+    // counters emit events for each chunk, collect their rings while they run so they
+    // never overflow on long executions.
+    running_counters.collect_until_done(telemetry);
     for (auto& t : threads) {
         t.join();
     }
@@ -125,6 +232,7 @@ void MemCountAndPlan::count_phase() {
     wait_mem_align_counters();
 
     t_count_us = (uint32_t) (get_usec() - init);
+    mem_telemetry_event(MEM_EVENT_COUNT_PHASE_END);
 
 #ifdef MEM_STATS_ACTIVE
     // Add stats for count phase
@@ -149,14 +257,46 @@ void MemCountAndPlan::plan_phase() {
 
     uint64_t init = get_usec();
     std::vector<std::thread> threads;
-
-    plan_threads.emplace_back([this](){ quick_mem_planner->generate_locators(count_workers, context->locators);});
-    plan_threads.emplace_back([this](){ rom_data_planner->execute(count_workers);});
-    plan_threads.emplace_back([this](){ input_data_planner->execute(count_workers);});
+    mem_telemetry_event(MEM_EVENT_PLAN_PHASE_BEGIN);
+
+    MemTelemetryPhase running_planners(3 + (mem_align_execute ? 1 : 0) + MAX_MEM_PLANNERS);
+    plan_threads.emplace_back([this, &running_planners](){
+        setup_thread(MEM_PLANNER_SLOT(0));
+        quick_mem_planner->generate_locators(count_workers, context->locators);
+        running_planners.done();
+    });
+    plan_threads.emplace_back([this, &running_planners](){
+        setup_thread(MEM_PLANNER_SLOT(1));
+        rom_data_planner->execute(count_workers);
+        running_planners.done();
+    });
+    plan_threads.emplace_back([this, &running_planners](){
+        setup_thread(MEM_PLANNER_SLOT(2));
+        input_data_planner->execute(count_workers);
+        running_planners.done();
+    });
+    if (mem_align_execute) {
+        // mem align counters are completed at end of count phase, plan them in parallel
+        // with memory planners.
+        plan_threads.emplace_back([this, &running_planners](){
+            setup_thread(MEM_ALIGN_PLANNER_SLOT);
+            mem_align_planner->execute(mem_align_counter->get_counters(), mem_align_counter->size(),
+                *mem_align_counter->get_total_counters());
+            running_planners.done();
+        });
+    }
     segments[RAM_ID].clear();
     for (int i = 0; i < MAX_MEM_PLANNERS; ++i) {
-        threads.emplace_back([this, i](){ plan_workers[i].execute_from_locators(count_workers, context->locators, segments[RAM_ID]);});
+        threads.emplace_back([this, i, &running_planners](){
+            setup_thread(MEM_PLANNER_SLOT(3 + i));
+            plan_workers[i].execute_from_locators(count_workers, context->locators, segments[RAM_ID]);
+            running_planners.done();
+        });
     }
+
+    // planners emit events for each locator and segment, collect their rings while they run
+    // as in the count phase.
+    running_planners.collect_until_done(telemetry);
     for (auto& t : threads) {
         t.join();
     }
@@ -170,6 +310,7 @@ void MemCountAndPlan::plan_phase() {
 
     segments[INPUT_ID].clear();
     input_data_planner->collect_segments(segments[INPUT_ID]);
+    mem_telemetry_event(MEM_EVENT_PLAN_PHASE_END);
 
 #ifdef MEM_STATS_ACTIVE
     // Add stats for plan phase
@@ -203,6 +344,7 @@ void MemCountAndPlan::stats() {
     }
     #endif
     printf("\n> threads: %d\n", MAX_THREADS);
+    printf("> affinity: %s\n", affinity.to_string().c_str());
     printf("> address table: %ld MB\n", (ADDR_TABLE_SIZE * ADDR_TABLE_ELEMENT_SIZE * MAX_THREADS)>>20);
     printf("> memory slots: %ld MB (used: %ld MB)\n", (ADDR_SLOTS_SIZE * sizeof(uint32_t) * MAX_THREADS)>>20, (tot_used_slots * ADDR_SLOT_SIZE * sizeof(uint32_t))>> 20);
     printf("> page table: %ld MB\n\n", (ADDR_PAGE_SIZE * sizeof(uint32_t))>> 20);
@@ -210,6 +352,7 @@ void MemCountAndPlan::stats() {
     for (uint32_t i = 0; i < plan_workers.size(); ++i) {
         plan_workers[i].stats();
     }
+    mem_align_planner->stats();
     printf("prepare: %04.2f ms\n", t_prepare_us / 1000.0);
     printf("execution: %04.2f ms\n", (TIME_US_BY_CHUNK * context->size()) / 1000.0);
     printf("completed: %04.2f ms\n", context->get_completed_us() / 1000.0);
@@ -304,6 +447,16 @@ const MemAlignChunkCounters *get_mem_align_total_counters(MemCountAndPlan *mcp)
     return mcp->mem_align_counter->get_total_counters();
 }
 
+uint32_t get_mem_align_segment_count(MemCountAndPlan *mcp, uint32_t instance_type)
+{
+    return mcp->mem_align_planner->size(instance_type);
+}
+
+const MemAlignCheckPoint *get_mem_align_segment_check_points(MemCountAndPlan *mcp, uint32_t instance_type, uint32_t segment_id, uint32_t &count)
+{
+    return mcp->mem_align_planner->get_check_points(instance_type, segment_id, count);
+}
+
 void MemCountAndPlan::wait_mem_align_counters() {
     while (sem_wait(&sem_mem_align_created) < 0) {
         if (errno != EINTR) {
@@ -330,7 +483,11 @@ void MemCountAndPlan::wait() {
 }
 
 void MemCountAndPlan::detach_execute() {
+    setup_thread(MEM_MAIN_SLOT);
     count_phase();
+    if (shard) {
+        shard_exchange();
+    }
     plan_phase();
     //stats();
     // printf("MemCountAndPlan count(ms):%ld plan(ms):%ld tot(ms):%ld\n", 
@@ -338,6 +495,36 @@ void MemCountAndPlan::detach_execute() {
 }
 
 
+void set_mem_shard(MemCountAndPlan *mcp, uint32_t from_addr, uint32_t to_addr, bool count_mem_align)
+{
+    mcp->set_shard(from_addr, to_addr, count_mem_align);
+}
+
+const MemShardBoundary *wait_mem_shard_counted(MemCountAndPlan *mcp)
+{
+    return mcp->wait_shard_counted();
+}
+
+void set_mem_shard_previous(MemCountAndPlan *mcp, const MemShardBoundary *previous)
+{
+    mcp->set_shard_previous(previous);
+}
+
+uint32_t get_mem_shard_first_segment_id(MemCountAndPlan *mcp, uint32_t mem_id)
+{
+    return mcp->get_shard_first_segment_id(mem_id);
+}
+
+uint32_t drain_mem_telemetry(MemCountAndPlan *mcp, MemTelemetryEvent *events, uint32_t max_events)
+{
+    return mcp->drain_telemetry(events, max_events);
+}
+
+uint64_t get_mem_telemetry_dropped(MemCountAndPlan *mcp)
+{
+    return mcp->get_telemetry_dropped();
+}
+
 uint64_t get_mem_stats_len(MemCountAndPlan *mcp)
 {
 #ifdef MEM_STATS_ACTIVE
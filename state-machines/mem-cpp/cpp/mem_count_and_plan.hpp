@@ -27,11 +27,15 @@
 #include "tools.hpp"
 #include "mem_counter.hpp"
 #include "mem_align_counter.hpp"
+#include "mem_align_planner.hpp"
 #include "mem_planner.hpp"
 #include "mem_locator.hpp"
 #include "mem_context.hpp"
 #include "immutable_mem_planner.hpp"
 #include "mem_segments.hpp"
+#include "mem_affinity.hpp"
+#include "mem_telemetry.hpp"
+#include "mem_shard.hpp"
 
 typedef struct {
     int thread_index;
@@ -52,6 +56,11 @@ private:
     std::unique_ptr<std::thread> parallel_execute;
     std::unique_ptr<std::thread> mem_align_execute;
     sem_t sem_mem_align_created;
+    MemAffinity affinity;
+    MemTelemetry telemetry;
+    std::unique_ptr<MemShard> shard;
+    sem_t sem_shard_counted;
+    sem_t sem_shard_previous;
     uint64_t t_init_us;
     uint64_t t_count_us;
     uint64_t t_prepare_us;
@@ -65,6 +74,7 @@ public:
 public:
     MemSegments segments[MEM_TYPES];
     std::unique_ptr<MemAlignCounter> mem_align_counter;
+    std::unique_ptr<MemAlignPlanner> mem_align_planner;
 
     MemCountAndPlan();
     ~MemCountAndPlan();
@@ -74,11 +84,26 @@ public:
     void detach_execute();
     void execute(void);
     void detach_execute_mem_align_counter();
+    void first_touch_counters();
+    void setup_thread(uint32_t slot);
+    void shard_exchange();
     void count_phase();
     void plan_phase();
     void stats();
     void wait(); 
     void wait_mem_align_counters(); 
+    uint32_t drain_telemetry(MemTelemetryEvent *events, uint32_t max_events) {
+        return telemetry.drain(events, max_events);
+    }
+    uint64_t get_telemetry_dropped() {
+        return telemetry.get_dropped();
+    }
+    void set_shard(uint32_t from_addr, uint32_t to_addr, bool count_mem_align);
+    const MemShardBoundary *wait_shard_counted();
+    void set_shard_previous(const MemShardBoundary *previous);
+    uint32_t get_shard_first_segment_id(uint32_t mem_id) {
+        return shard ? shard->get_first_segment_id(mem_id) : 0;
+    }
 
     void set_completed() {
         context->set_completed();
@@ -96,7 +121,8 @@ void set_completed_mem_count_and_plan(MemCountAndPlan *mcp);
 void wait_mem_count_and_plan(MemCountAndPlan *mcp);
 uint32_t get_mem_segment_count(MemCountAndPlan *mcp, uint32_t mem_id);
 const MemCheckPoint *get_mem_segment_check_points(MemCountAndPlan *mcp, uint32_t mem_id, uint32_t segment_id, uint32_t &count);
-const MemAlignCheckPoint *get_mem_align_check_points(MemCountAndPlan *mcp, uint32_t &count);
+uint32_t get_mem_align_segment_count(MemCountAndPlan *mcp, uint32_t instance_type);
+const MemAlignCheckPoint *get_mem_align_segment_check_points(MemCountAndPlan *mcp, uint32_t instance_type, uint32_t segment_id, uint32_t &count);
 */
 
 #endif
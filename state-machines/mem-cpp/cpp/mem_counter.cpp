@@ -1,4 +1,5 @@
 #include "mem_counter.hpp"
+#include "mem_telemetry.hpp"
 #include <assert.h>
 #include <string.h>
 
@@ -16,8 +17,9 @@ MemCounter::MemCounter(uint32_t id, std::shared_ptr<MemContext> context)
     queue_full = 0;
     first_chunk_us = 0;
     tot_wait_us = 0;
+    // pages of tables are touched later (first_touch), by the thread that uses them, to
+    // allocate them on the numa node where this thread runs.
     addr_count_table = (AddrCount *)malloc(ADDR_TABLE_SIZE * sizeof(AddrCount));
-    explicit_bzero(addr_count_table, ADDR_TABLE_SIZE * sizeof(AddrCount));
 
     // no memset because informations is overrided.
     addr_slots = (uint32_t *)std::aligned_alloc(64, ADDR_SLOTS_SIZE * sizeof(uint32_t));
@@ -27,6 +29,10 @@ MemCounter::MemCounter(uint32_t id, std::shared_ptr<MemContext> context)
 
     free_slot = 0;
     addr_count = 0;
+
+    // by default all addresses, only restricted on sharded mode
+    window_from_addr = 0;
+    window_to_addr = 0xFFFFFFFF;
 }
 
 MemCounter::~MemCounter() {
@@ -34,6 +40,10 @@ MemCounter::~MemCounter() {
     free(addr_slots);
 }
 
+void MemCounter::first_touch() {
+    explicit_bzero(addr_count_table, ADDR_TABLE_SIZE * sizeof(AddrCount));
+}
+
 void MemCounter::execute() {
     uint64_t init_us = get_usec();
     
@@ -95,6 +105,7 @@ void MemCounter::execute_chunk(uint32_t chunk_id, const MemCountersBusData *chun
 #endif // MEM_STATS_ACTIVE
 
     current_chunk = chunk_id;
+    MEM_INTERLEAVE();
 
     for (const MemCountersBusData *chunk_eod = chunk_data + chunk_size; chunk_eod != chunk_data; chunk_data++) {
         const uint8_t bytes = chunk_data->flags & 0x0F;
@@ -127,6 +138,7 @@ void MemCounter::execute_chunk(uint32_t chunk_id, const MemCountersBusData *chun
             }
         }
     }
+    mem_telemetry_event(MEM_EVENT_CHUNK_COUNTED, chunk_id);
 
 #ifdef MEM_STATS_ACTIVE
     // Add stats for this chunk execution
@@ -142,6 +154,9 @@ void MemCounter::execute_chunk(uint32_t chunk_id, const MemCountersBusData *chun
 }
 
 void MemCounter::incr_counter(uint32_t addr, uint32_t chunk_id, bool is_aligned, bool is_write) {
+    if (addr < window_from_addr || addr > window_to_addr) {
+        return;
+    }
     uint32_t offset = addr_to_offset(addr, current_chunk);
     uint32_t pos = addr_count_table[offset].pos;    
     bool is_ram = (addr >= RAM_ADDR);
@@ -48,6 +48,8 @@ private:
     uint32_t queue_full;
     uint64_t first_chunk_us;
     const uint32_t addr_mask;
+    uint32_t window_from_addr;
+    uint32_t window_to_addr;
 #ifdef COUNT_CHUNK_STATS
     uint64_t chunks_us[MAX_CHUNKS];
     int64_t wait_chunks_us[MAX_CHUNKS];
@@ -70,6 +72,11 @@ public:
     inline uint32_t get_count();
     inline uint32_t get_used_slots();
     ~MemCounter();
+    void first_touch();
+    void set_window(uint32_t from_addr, uint32_t to_addr) {
+        window_from_addr = from_addr;
+        window_to_addr = to_addr;
+    }
     void execute();
     void execute_chunk(uint32_t chunk_id, const MemCountersBusData *chunk_data, uint32_t chunk_size);
     inline uint32_t get_initial_block_pos(uint32_t pos);
@@ -83,11 +90,14 @@ public:
     inline uint32_t get_addr_table(uint32_t index) const;
     inline uint32_t get_count_table(uint32_t index) const;
     inline uint32_t get_next_slot_pos();
-    inline void update_addr_count(uint32_t &count, bool is_aligned, bool is_write, bool is_ram);
-    inline uint32_t init_addr_count(bool is_aligned, bool is_write, bool is_ram);
+    static void update_addr_count(uint32_t &count, bool is_aligned, bool is_write, bool is_ram);
+    static uint32_t init_addr_count(bool is_aligned, bool is_write, bool is_ram);
     void incr_counter(uint32_t addr, uint32_t chunk_id, bool is_aligned, bool is_write);
-    inline uint32_t incr_st_counter_aligned(uint32_t count, bool is_write);
-    inline uint32_t incr_st_counter_unaligned(uint32_t count, bool is_write);
+    static uint32_t incr_st_counter_aligned(uint32_t count, bool is_write);
+    static uint32_t incr_st_counter_unaligned(uint32_t count, bool is_write);
+    static uint32_t addr_count_to_rows(uint32_t count) {
+        return (count & ST_BITS_COUNTER_MASK) + ((count & ST_BITS_ST_MASK) ? 1:0);
+    }
 
     
     uint32_t get_elapsed_ms() {
@@ -109,7 +119,7 @@ uint32_t MemCounter::get_pos_value(uint32_t pos) const {
 }
 
 uint32_t MemCounter::get_pos_count(uint32_t pos) const {    
-    return (addr_slots[pos] & ST_BITS_COUNTER_MASK) + ((addr_slots[pos] & ST_BITS_ST_MASK) ? 1:0);
+    return addr_count_to_rows(addr_slots[pos]);
 }
 
 
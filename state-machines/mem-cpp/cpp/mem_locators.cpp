@@ -1,5 +1,6 @@
 #include <assert.h>
 #include "mem_locators.hpp"
+#include "mem_telemetry.hpp"
 
 MemLocators::MemLocators() {
 }
@@ -11,7 +12,10 @@ void MemLocators::push_locator(uint32_t thread_index, uint32_t offset, uint32_t
     locators[pos].offset = offset;
     locators[pos].cpos = cpos;
     locators[pos].skip = skip;
-    write_pos.store(pos + 1, std::memory_order_relaxed);
+    MEM_INTERLEAVE_AT(MEM_POINT_LOCATOR_PUSH);
+    // release: locator must be visible before the consumers see the new write_pos
+    write_pos.store(pos + 1, std::memory_order_release);
+    mem_telemetry_event(MEM_EVENT_LOCATOR_EMITTED, pos);
 }
 
 MemLocator *MemLocators::get_locator(uint32_t &segment_id) {
@@ -23,6 +27,7 @@ MemLocator *MemLocators::get_locator(uint32_t &segment_id) {
         current_write = write_pos.load(std::memory_order_acquire);
         if (current_read == current_write) return nullptr;
         item = &locators[current_read];
+        MEM_INTERLEAVE();
     } while (!read_pos.compare_exchange_weak(
         current_read,
         current_read + 1,
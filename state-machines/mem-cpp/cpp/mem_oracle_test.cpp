@@ -0,0 +1,766 @@
+// Oracle test of the threaded count and plan pipeline. For each seed a random memory-op
+// trace is generated, the full pipeline (counters, locators, planners) is executed with
+// random thread interleavings (MEM_TEST_INTERLEAVE hooks) and every segment checkpoint is
+// compared byte by byte with a simple single-threaded reference planner. Mem align
+// checkpoints are verified against the operations of each chunk (see compare_mem_align).
+//
+// Runs of each seed cycle through random interleaving, parked planners, where every locator
+// is published while all the RAM planners wait between an empty read and their completed
+// check, and sharded, where the trace is also planned shard by shard and the merged
+// segments are compared byte by byte with the single-process run.
+//
+// The Makefile builds it for several THREAD_BITS / MAX_MEM_PLANNERS configurations, with
+// small segments to force many locators and segments (make test, make test-tsan).
+//
+// usage: mem_oracle_test [seeds] [first_seed] [runs_by_seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <vector>
+#include <map>
+#include <set>
+#include <array>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+#include "api.hpp"
+#include "mem_types.hpp"
+#include "mem_config.hpp"
+#include "mem_check_point.hpp"
+#include "mem_align_planner.hpp"
+#include "mem_shard.hpp"
+
+static std::atomic<uint64_t> interleave_seed{0};
+static thread_local uint64_t interleave_state = 0;
+
+static uint64_t xorshift64(uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// RUN_PARKED_PLANNERS state: planners parked between an empty read and their completed check,
+// and whether the locators generator has reached set_completed
+static std::atomic<bool> park_planners{false};
+static std::atomic<uint32_t> parked_planners{0};
+static std::atomic<bool> locators_completing{false};
+static thread_local uint32_t locator_waits = 0;
+
+static void park_planner(void) {
+    // first wait of a planner is before its first empty read, park it on the next one
+    if (++locator_waits < 2) return;
+    parked_planners.fetch_add(1, std::memory_order_acq_rel);
+    while (!locators_completing.load(std::memory_order_acquire)) {
+        usleep(50);
+    }
+    // give time to the generator to call set_completed
+    usleep(200);
+    parked_planners.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+static void wait_parked_planners(void) {
+    for (uint32_t retry = 0; retry < 20000; ++retry) {
+        if (parked_planners.load(std::memory_order_acquire) == MAX_MEM_PLANNERS) return;
+        usleep(50);
+    }
+}
+
+void mem_test_interleave(uint32_t point) {
+    if (park_planners.load(std::memory_order_relaxed)) {
+        switch (point) {
+            case MEM_POINT_LOCATOR_WAIT: park_planner(); return;
+            case MEM_POINT_LOCATOR_PUSH: wait_parked_planners(); return;
+            case MEM_POINT_LOCATORS_COMPLETED:
+                locators_completing.store(true, std::memory_order_release);
+                return;
+        }
+    }
+    if (interleave_state == 0) {
+        interleave_state = (interleave_seed.load(std::memory_order_relaxed) * 0x9E3779B97F4A7C15ULL) ^
+                           std::hash<std::thread::id>{}(std::this_thread::get_id());
+        interleave_state |= 1;
+    }
+    uint64_t value = xorshift64(interleave_state);
+    switch (value % 16) {
+        case 10: case 11: case 12: case 13:
+            sched_yield();
+            break;
+        case 14: case 15:
+            usleep((value >> 8) % 64);
+            break;
+        default:
+            break;
+    }
+}
+
+typedef std::vector<MemCheckPoint> RefSegment;
+
+class RefSegmentBuilder {
+    std::unordered_map<uint32_t, uint32_t> mapping;
+public:
+    RefSegment checkpoints;
+    void add_or_update(uint32_t chunk_id, uint32_t addr, uint32_t skip, uint32_t count) {
+        auto it = mapping.find(chunk_id);
+        if (it != mapping.end()) {
+            checkpoints[it->second].add_rows(addr, count);
+            return;
+        }
+        mapping.emplace(chunk_id, checkpoints.size());
+        checkpoints.emplace_back().set(chunk_id, addr, skip, count);
+    }
+    void close(std::vector<RefSegment> &segments) {
+        segments.emplace_back(std::move(checkpoints));
+        checkpoints.clear();
+        mapping.clear();
+    }
+};
+
+struct RefAddrChunk {
+    uint32_t addr;
+    uint32_t chunk_id;
+    uint32_t rows;
+};
+
+// Rows used by the accesses of one chunk to one address, written from the row layout and not
+// from the packed state counters of MemCounter. On RAM a row holds one access or a dual
+// access, any access followed by a read of the same address. A write always opens a new row,
+// a read joins the last row when it holds a single access. An unaligned access is a read,
+// followed by a write when it writes. On ROM and INPUT each access uses its own rows.
+class RefAddrRows {
+    bool single = false;  // last row holds a single access, a read can join it
+    void read() {
+        if (single) {
+            single = false;
+            return;
+        }
+        ++rows;
+        single = true;
+    }
+    void write() {
+        ++rows;
+        single = true;
+    }
+public:
+    uint32_t rows = 0;
+    void add(bool is_aligned, bool is_write, bool is_ram) {
+        if (!is_ram) {
+            rows += (is_aligned || !is_write) ? 1 : 2;
+            return;
+        }
+        if (!is_aligned) {
+            read();
+            if (is_write) write();
+            return;
+        }
+        if (is_write) {
+            write();
+        } else {
+            read();
+        }
+    }
+};
+
+class RefPlanner {
+    // by address, list of (chunk_id, rows) in chunk order
+    std::map<uint32_t, std::vector<std::pair<uint32_t, RefAddrRows>>> counters;
+    void incr(uint32_t addr, uint32_t chunk_id, bool is_aligned, bool is_write) {
+        auto &chunks = counters[addr];
+        if (chunks.empty() || chunks.back().first != chunk_id) {
+            chunks.emplace_back(chunk_id, RefAddrRows());
+        }
+        chunks.back().second.add(is_aligned, is_write, addr >= RAM_ADDR);
+    }
+    std::vector<RefAddrChunk> get_range(uint32_t from_addr, uint32_t to_addr) {
+        std::vector<RefAddrChunk> result;
+        for (auto it = counters.lower_bound(from_addr); it != counters.end() && it->first <= to_addr; ++it) {
+            for (auto &[chunk_id, addr_rows]: it->second) {
+                result.push_back({it->first, chunk_id, addr_rows.rows});
+            }
+        }
+        return result;
+    }
+    // mem align operation type (full_5, full_3, full_2, read_byte, write_byte) of an access,
+    // MEM_ALIGN_OP_TYPES if it's aligned
+    static uint32_t mem_align_op_type(uint32_t addr, uint32_t bytes, bool is_write, bool is_clear) {
+        const uint32_t offset = addr & 0x07;
+        if (bytes == 8 && offset == 0) return MEM_ALIGN_OP_TYPES;
+        if (bytes == 1) {
+            if (!is_write) return 3;
+            return is_clear ? 4 : 1;
+        }
+        const bool two_words = offset + bytes > 8;
+        if (is_write) return two_words ? 0 : 1;
+        return two_words ? 1 : 2;
+    }
+public:
+    std::vector<RefSegment> segments[MEM_TYPES];
+    // addresses of [from_addr, to_addr] where a segment of rows ends exactly, followed by
+    // more addresses of the range. A shard starting after one of them starts on a segment edge.
+    std::vector<uint32_t> segment_edges(uint32_t from_addr, uint32_t to_addr, uint32_t rows) {
+        std::vector<uint32_t> edges;
+        uint64_t total = 0;
+        for (auto it = counters.lower_bound(from_addr); it != counters.end() && it->first <= to_addr; ++it) {
+            for (auto &[chunk_id, addr_rows]: it->second) {
+                total += addr_rows.rows;
+            }
+            auto next = std::next(it);
+            if (total % rows == 0 && next != counters.end() && next->first <= to_addr) {
+                edges.push_back(it->first);
+            }
+        }
+        return edges;
+    }
+    // consecutive addresses of [from_addr, to_addr] with unused addresses between them
+    std::vector<std::pair<uint32_t, uint32_t>> gaps(uint32_t from_addr, uint32_t to_addr) {
+        std::vector<std::pair<uint32_t, uint32_t>> result;
+        for (auto it = counters.lower_bound(from_addr); it != counters.end() && it->first <= to_addr; ++it) {
+            auto next = std::next(it);
+            if (next != counters.end() && next->first <= to_addr && next->first > it->first + 8) {
+                result.emplace_back(it->first, next->first);
+            }
+        }
+        return result;
+    }
+    // mem align operations of each chunk by type
+    std::map<uint32_t, std::array<uint32_t, MEM_ALIGN_OP_TYPES>> mem_align_ops;
+    void count(uint32_t chunk_id, const MemCountersBusData *data, uint32_t size) {
+        for (uint32_t i = 0; i < size; ++i) {
+            const uint32_t bytes = data[i].flags & 0x0F;
+            const uint32_t addr = data[i].addr;
+            const bool is_write = data[i].flags & MEM_WRITE_FLAG;
+            const uint32_t op_type = mem_align_op_type(addr, bytes, is_write, data[i].flags & MEM_WRITE_BYTE_CLEAR_FLAG);
+            if (op_type < MEM_ALIGN_OP_TYPES) {
+                mem_align_ops[chunk_id][op_type] += 1;
+            }
+            if (bytes == 8 && (addr & 0x07) == 0) {
+                incr(addr, chunk_id, true, is_write);
+                continue;
+            }
+            incr(addr & 0xFFFFFFF8, chunk_id, false, is_write);
+            if ((bytes + (addr & 0x07)) > 8) {
+                incr((addr & 0xFFFFFFF8) + 8, chunk_id, false, is_write);
+            }
+        }
+    }
+    // RAM: a new segment is opened as soon as the previous one is full
+    void plan_ram(uint32_t rows) {
+        RefSegmentBuilder current;
+        uint32_t available = rows;
+        for (auto &item: get_range(RAM_ADDR, 0xFFFFFFFF)) {
+            uint32_t skip = 0;
+            while (true) {
+                uint32_t consumed = std::min(item.rows - skip, available);
+                current.add_or_update(item.chunk_id, item.addr, skip, consumed);
+                skip += consumed;
+                available -= consumed;
+                if (available == 0) {
+                    current.close(segments[RAM_ID]);
+                    available = rows;
+                    current.add_or_update(item.chunk_id, item.addr, skip, 0);
+                }
+                if (skip == item.rows) break;
+            }
+        }
+        if (!current.checkpoints.empty()) {
+            current.close(segments[RAM_ID]);
+        }
+    }
+    // ROM, INPUT: a new segment is opened only when there are rows to add
+    void plan_immutable(uint32_t mem_id, uint32_t rows, uint32_t from_addr) {
+        RefSegmentBuilder current;
+        uint32_t available = rows;
+        bool has_reference = false;
+        uint32_t reference_chunk = 0, reference_addr = 0, reference_skip = 0;
+        auto open_segment = [&]() {
+            current.close(segments[mem_id]);
+            available = rows;
+            if (has_reference) {
+                current.add_or_update(reference_chunk, reference_addr, reference_skip, 0);
+            }
+        };
+        for (auto &item: get_range(from_addr, from_addr + (128 << 20) - 1)) {
+            if (available == 0) {
+                open_segment();
+            }
+            has_reference = true;
+            reference_chunk = item.chunk_id;
+            reference_addr = item.addr;
+            reference_skip = 0;
+            uint32_t pending = item.rows;
+            while (pending > 0) {
+                uint32_t consumed = std::min(pending, available);
+                if (available == 0) {
+                    open_segment();
+                }
+                current.add_or_update(item.chunk_id, item.addr, item.rows - pending, consumed);
+                available -= consumed;
+                reference_skip += consumed;
+                pending -= consumed;
+            }
+        }
+        if (available < rows) {
+            current.close(segments[mem_id]);
+        }
+    }
+};
+
+struct TestTrace {
+    std::vector<std::vector<MemCountersBusData>> chunks;
+};
+
+static void generate_trace(uint64_t seed, TestTrace &trace) {
+    uint64_t state = seed * 0x2545F4914F6CDD1DULL + 1;
+    auto next = [&state](uint32_t max) -> uint32_t { return xorshift64(state) % max; };
+
+    const uint32_t regions[MEM_TYPES] = {ROM_ADDR, INPUT_ADDR, RAM_ADDR};
+    const uint32_t region_sizes[MEM_TYPES] = {128 << 20, 128 << 20, 512 << 20};
+    // small sets of hot addresses produce many chunks by address
+    std::vector<uint32_t> hot;
+    for (uint32_t i = 0; i < 64 + next(256); ++i) {
+        uint32_t region = next(MEM_TYPES);
+        hot.push_back(regions[region] + (next(region_sizes[region] >> 3) << 3));
+    }
+    const uint32_t chunks = 1 + next(12);
+    const uint32_t hot_percent = next(100);
+    trace.chunks.resize(chunks);
+    for (auto &chunk: trace.chunks) {
+        chunk.resize(1 + next(CHUNK_SIZE >> 2));
+        for (auto &op: chunk) {
+            uint32_t addr;
+            if (next(100) < hot_percent) {
+                addr = hot[next(hot.size())];
+            } else {
+                uint32_t region = next(MEM_TYPES);
+                // most of accesses on first MB of each region, some on the full region
+                uint32_t size = next(8) == 0 ? region_sizes[region] : (1 << 20);
+                addr = regions[region] + next(size);
+            }
+            uint32_t bytes = 8;
+            bool is_write = next(3) == 0;
+            if (next(4) == 0) {
+                bytes = 1 << next(4);
+            } else {
+                addr &= 0xFFFFFFF8;
+            }
+            // unaligned accesses never cross the end of the region
+            if (((addr + 8) & 0x0FFFFFF8) == 0) {
+                addr &= 0xFFFFFFF8;
+            }
+            op.addr = addr;
+            op.flags = bytes | (is_write ? MEM_WRITE_FLAG : 0);
+            if (is_write && bytes == 1 && next(2) == 0) {
+                op.flags |= MEM_WRITE_BYTE_CLEAR_FLAG;
+            }
+        }
+    }
+}
+
+static void collect_segments(MemCountAndPlan *mcp, std::vector<RefSegment> *segments) {
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        segments[mem_id].clear();
+        uint32_t count = get_mem_segment_count(mcp, mem_id);
+        for (uint32_t segment_id = 0; segment_id < count; ++segment_id) {
+            uint32_t size = 0;
+            const MemCheckPoint *checkpoints = get_mem_segment_check_points(mcp, mem_id, segment_id, size);
+            segments[mem_id].emplace_back(checkpoints, checkpoints + size);
+        }
+    }
+}
+
+static uint32_t compare_segment_lists(const char *label, const std::vector<RefSegment> *segments,
+                                      const std::vector<RefSegment> *expected, uint64_t seed, uint32_t run) {
+    const char *names[MEM_TYPES] = {"ROM", "INPUT", "RAM"};
+    uint32_t errors = 0;
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        if (segments[mem_id].size() != expected[mem_id].size()) {
+            printf("FAIL seed:%lu run:%u %s %s segments:%lu expected:%lu\n", seed, run, label, names[mem_id],
+                segments[mem_id].size(), expected[mem_id].size());
+            ++errors;
+            continue;
+        }
+        for (uint32_t segment_id = 0; segment_id < segments[mem_id].size(); ++segment_id) {
+            const RefSegment &checkpoints = segments[mem_id][segment_id];
+            const RefSegment &segment = expected[mem_id][segment_id];
+            const size_t count = checkpoints.size();
+            if (count != segment.size() || memcmp(checkpoints.data(), segment.data(), count * sizeof(MemCheckPoint)) != 0) {
+                printf("FAIL seed:%lu run:%u %s %s segment:%u checkpoints:%lu expected:%lu\n", seed, run, label, names[mem_id],
+                    segment_id, count, segment.size());
+                for (uint32_t index = 0; index < std::min(count, segment.size()); ++index) {
+                    const MemCheckPoint &a = checkpoints[index];
+                    const MemCheckPoint &b = segment[index];
+                    if (memcmp(&a, &b, sizeof(MemCheckPoint)) == 0) continue;
+                    printf("  #%u {%u 0x%08X %u 0x%08X %u %u} expected {%u 0x%08X %u 0x%08X %u %u}\n", index,
+                        a.chunk_id, a.from_addr, a.from_skip, a.to_addr, a.to_count, a.count,
+                        b.chunk_id, b.from_addr, b.from_skip, b.to_addr, b.to_count, b.count);
+                    break;
+                }
+                ++errors;
+            }
+        }
+    }
+    return errors;
+}
+
+static uint32_t compare_segments(MemCountAndPlan *mcp, RefPlanner &reference, uint64_t seed, uint32_t run) {
+    std::vector<RefSegment> segments[MEM_TYPES];
+    collect_segments(mcp, segments);
+    return compare_segment_lists("single", segments, reference.segments, seed, run);
+}
+
+// Mem align checkpoints can't be compared with a simple reference planner (the number of
+// instances of each type depends on the strategy), instead every checkpoint is verified: rows
+// of each instance inside its limit, skip of each chunk and operation type equal to the
+// operations consumed by the previous instances, and all the operations of each chunk
+// consumed exactly once.
+static uint32_t compare_mem_align(MemCountAndPlan *mcp, RefPlanner &reference, uint64_t seed, uint32_t run) {
+    const char *names[MEM_ALIGN_INSTANCE_TYPES] = {"ReadByte", "WriteByte", "Byte", "Full"};
+    const uint32_t rows[MEM_ALIGN_INSTANCE_TYPES] = {MEM_ALIGN_READ_BYTE_ROWS, MEM_ALIGN_WRITE_BYTE_ROWS, MEM_ALIGN_BYTE_ROWS, MEM_ALIGN_ROWS};
+    const uint32_t costs[MEM_ALIGN_INSTANCE_TYPES][MEM_ALIGN_OP_TYPES] = {
+        {0, 0, 0, 1, 0}, {0, 0, 0, 0, 1}, {0, 0, 0, 1, 1}, {5, 3, 2, 2, 3}
+    };
+    std::map<uint32_t, std::array<uint32_t, MEM_ALIGN_OP_TYPES>> consumed;
+    uint32_t errors = 0;
+    // instances are filled chunk by chunk, in the order of instance types
+    for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+        const uint32_t segments = get_mem_align_segment_count(mcp, instance_type);
+        for (uint32_t segment_id = 0; segment_id < segments; ++segment_id) {
+            uint32_t count = 0;
+            const MemAlignCheckPoint *checkpoints = get_mem_align_segment_check_points(mcp, instance_type, segment_id, count);
+            uint64_t used_rows = 0;
+            for (uint32_t index = 0; index < count; ++index) {
+                const MemAlignCheckPoint &checkpoint = checkpoints[index];
+                if (index > 0 && checkpoint.chunk_id <= checkpoints[index - 1].chunk_id) {
+                    printf("FAIL seed:%lu run:%u %s segment:%u chunk:%u out of order\n", seed, run, names[instance_type], segment_id, checkpoint.chunk_id);
+                    ++errors;
+                }
+                auto &chunk_consumed = consumed[checkpoint.chunk_id];
+                for (uint32_t op = 0; op < MEM_ALIGN_OP_TYPES; ++op) {
+                    if (checkpoint.count[op] == 0) continue;
+                    if (costs[instance_type][op] == 0 || checkpoint.skip[op] != chunk_consumed[op]) {
+                        printf("FAIL seed:%lu run:%u %s segment:%u chunk:%u op:%u skip:%u count:%u expected skip:%u\n", seed, run,
+                            names[instance_type], segment_id, checkpoint.chunk_id, op, checkpoint.skip[op], checkpoint.count[op], chunk_consumed[op]);
+                        ++errors;
+                    }
+                    chunk_consumed[op] += checkpoint.count[op];
+                    used_rows += (uint64_t)costs[instance_type][op] * checkpoint.count[op];
+                }
+            }
+            if (count == 0 || used_rows > rows[instance_type]) {
+                printf("FAIL seed:%lu run:%u %s segment:%u checkpoints:%u rows:%lu/%u\n", seed, run, names[instance_type], segment_id, count, used_rows, rows[instance_type]);
+                ++errors;
+            }
+        }
+    }
+    for (auto &[chunk_id, ops]: consumed) {
+        if (reference.mem_align_ops.find(chunk_id) == reference.mem_align_ops.end()) {
+            printf("FAIL seed:%lu run:%u mem align chunk:%u has no mem align operations\n", seed, run, chunk_id);
+            ++errors;
+        }
+    }
+    for (auto &[chunk_id, ops]: reference.mem_align_ops) {
+        if (consumed[chunk_id] != ops) {
+            auto &c = consumed[chunk_id];
+            printf("FAIL seed:%lu run:%u mem align chunk:%u consumed:(%u,%u,%u,%u,%u) expected:(%u,%u,%u,%u,%u)\n", seed, run, chunk_id,
+                c[0], c[1], c[2], c[3], c[4], ops[0], ops[1], ops[2], ops[3], ops[4]);
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+// Sharded runs: shard windows cover the full address space, with boundaries exactly on
+// segment edges of each memory type when the trace has them, and empty shards (between two
+// used addresses and at the end of the address space).
+struct ShardWindow {
+    uint32_t from_addr;
+    uint32_t to_addr;
+};
+
+static uint32_t sharded_runs = 0;
+static uint32_t shard_edge_boundaries = 0;
+static uint32_t empty_shards = 0;
+
+static std::vector<ShardWindow> generate_shard_windows(RefPlanner &reference, uint64_t seed, uint32_t run) {
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + run + 1;
+    auto next = [&state](uint32_t max) -> uint32_t { return xorshift64(state) % max; };
+
+    const uint32_t regions[MEM_TYPES] = {ROM_ADDR, INPUT_ADDR, RAM_ADDR};
+    const uint32_t region_sizes[MEM_TYPES] = {128 << 20, 128 << 20, 512 << 20};
+    const uint32_t rows[MEM_TYPES] = {ROM_ROWS, INPUT_ROWS, RAM_ROWS};
+    std::set<uint32_t> splits = {0, RAM_ADDR, 0xC0000000};
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        auto edges = reference.segment_edges(regions[mem_id], regions[mem_id] + region_sizes[mem_id] - 1, rows[mem_id]);
+        if (!edges.empty()) {
+            splits.insert(edges[next(edges.size())] + 8);
+            ++shard_edge_boundaries;
+        }
+    }
+    auto gaps = reference.gaps(RAM_ADDR, 0xBFFFFFFF);
+    if (!gaps.empty()) {
+        auto &gap = gaps[next(gaps.size())];
+        splits.insert(gap.first + 8);
+        splits.insert(gap.second);
+    }
+    for (uint32_t i = 0; i < 3; ++i) {
+        uint32_t region = next(MEM_TYPES);
+        splits.insert(regions[region] + (next(1 << 20) & 0xFFFFFFF8));
+    }
+    std::vector<ShardWindow> windows;
+    for (auto it = splits.begin(); it != splits.end(); ++it) {
+        auto next_split = std::next(it);
+        windows.push_back({*it, next_split == splits.end() ? 0xFFFFFFFF : *next_split - 1});
+    }
+    return windows;
+}
+
+// port of MemShardBoundary::accumulate (mem_shard.rs), boundaries received by each shard
+static std::vector<std::array<MemShardBoundary, MEM_TYPES>> accumulate_boundaries(
+        const std::vector<std::array<MemShardBoundary, MEM_TYPES>> &shards) {
+    std::array<MemShardBoundary, MEM_TYPES> previous;
+    previous.fill({0, NO_CHUNK_ID, 0, 0});
+    std::vector<std::array<MemShardBoundary, MEM_TYPES>> result;
+    for (auto &boundaries: shards) {
+        result.push_back(previous);
+        for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+            previous[mem_id].rows += boundaries[mem_id].rows;
+            if (boundaries[mem_id].last_chunk_id != NO_CHUNK_ID) {
+                previous[mem_id].last_chunk_id = boundaries[mem_id].last_chunk_id;
+                previous[mem_id].last_addr = boundaries[mem_id].last_addr;
+                previous[mem_id].last_count = boundaries[mem_id].last_count;
+            }
+        }
+    }
+    return result;
+}
+
+// port of merge_shard_segments (mem_shard.rs), adds the segments of a shard to the merged
+// segments, checkpoints of the same chunk in the same segment are joined on first position
+static void merge_shard_segments(MemCountAndPlan *mcp, std::vector<RefSegment> *merged,
+                                 std::vector<std::vector<std::unordered_map<uint32_t, size_t>>> &positions) {
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        const uint32_t first_segment_id = get_mem_shard_first_segment_id(mcp, mem_id);
+        const uint32_t segments = get_mem_segment_count(mcp, mem_id);
+        for (uint32_t index = 0; index < segments; ++index) {
+            const uint32_t segment_id = first_segment_id + index;
+            if (merged[mem_id].size() <= segment_id) {
+                merged[mem_id].resize(segment_id + 1);
+                positions[mem_id].resize(segment_id + 1);
+            }
+            uint32_t count = 0;
+            const MemCheckPoint *checkpoints = get_mem_segment_check_points(mcp, mem_id, index, count);
+            for (uint32_t i = 0; i < count; ++i) {
+                auto it = positions[mem_id][segment_id].find(checkpoints[i].chunk_id);
+                if (it == positions[mem_id][segment_id].end()) {
+                    positions[mem_id][segment_id].emplace(checkpoints[i].chunk_id, merged[mem_id][segment_id].size());
+                    merged[mem_id][segment_id].push_back(checkpoints[i]);
+                    continue;
+                }
+                MemCheckPoint &joined = merged[mem_id][segment_id][it->second];
+                joined.to_addr = checkpoints[i].to_addr;
+                joined.to_count = checkpoints[i].to_count;
+                joined.count += checkpoints[i].count;
+            }
+        }
+    }
+}
+
+// mem align checkpoints of each instance, by instance type
+typedef std::vector<std::vector<MemAlignCheckPoint>> MemAlignSegments[MEM_ALIGN_INSTANCE_TYPES];
+
+static void collect_mem_align(MemCountAndPlan *mcp, MemAlignSegments &segments) {
+    for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+        segments[instance_type].clear();
+        const uint32_t count = get_mem_align_segment_count(mcp, instance_type);
+        for (uint32_t segment_id = 0; segment_id < count; ++segment_id) {
+            uint32_t size = 0;
+            const MemAlignCheckPoint *checkpoints = get_mem_align_segment_check_points(mcp, instance_type, segment_id, size);
+            segments[instance_type].emplace_back(checkpoints, checkpoints + size);
+        }
+    }
+}
+
+// mem align instances are planned only by the shard that counts them, they must be equal
+// to the instances of the single-process run
+static uint32_t compare_shard_mem_align(MemCountAndPlan *mcp, const MemAlignSegments &expected, bool count_mem_align,
+                                        uint64_t seed, uint32_t run, uint32_t shard) {
+    uint32_t errors = 0;
+    MemAlignSegments segments;
+    collect_mem_align(mcp, segments);
+    for (uint32_t instance_type = 0; instance_type < MEM_ALIGN_INSTANCE_TYPES; ++instance_type) {
+        const size_t expected_segments = count_mem_align ? expected[instance_type].size() : 0;
+        if (segments[instance_type].size() != expected_segments) {
+            printf("FAIL seed:%lu run:%u shard:%u mem align type:%u segments:%lu expected:%lu\n", seed, run, shard,
+                instance_type, segments[instance_type].size(), expected_segments);
+            ++errors;
+            continue;
+        }
+        for (uint32_t segment_id = 0; segment_id < expected_segments; ++segment_id) {
+            auto &checkpoints = segments[instance_type][segment_id];
+            auto &expected_checkpoints = expected[instance_type][segment_id];
+            if (checkpoints.size() != expected_checkpoints.size() || memcmp(checkpoints.data(), expected_checkpoints.data(),
+                    checkpoints.size() * sizeof(MemAlignCheckPoint)) != 0) {
+                printf("FAIL seed:%lu run:%u shard:%u mem align type:%u segment:%u checkpoints:%lu expected:%lu\n", seed, run,
+                    shard, instance_type, segment_id, checkpoints.size(), expected_checkpoints.size());
+                ++errors;
+            }
+        }
+    }
+    return errors;
+}
+
+// plans the trace shard by shard and compares the merged segments with the segments of the
+// single-process run, byte by byte. Each pipeline allocates its full counter tables, shards
+// are executed one at a time in address order, as each one only needs the boundaries of
+// the previous shards.
+static uint32_t run_shards(TestTrace &trace, RefPlanner &reference, const std::vector<RefSegment> *expected,
+                           const MemAlignSegments &expected_mem_align, uint64_t seed, uint32_t run) {
+    std::vector<ShardWindow> windows = generate_shard_windows(reference, seed, run);
+    std::vector<std::array<MemShardBoundary, MEM_TYPES>> boundaries;
+    std::vector<RefSegment> merged[MEM_TYPES];
+    std::vector<std::vector<std::unordered_map<uint32_t, size_t>>> positions(MEM_TYPES);
+    uint32_t errors = 0;
+    for (uint32_t index = 0; index < windows.size(); ++index) {
+        MemCountAndPlan *mcp = create_mem_count_and_plan();
+        set_mem_shard(mcp, windows[index].from_addr, windows[index].to_addr, index == 0);
+        execute_mem_count_and_plan(mcp);
+        for (auto &chunk: trace.chunks) {
+            add_chunk_mem_count_and_plan(mcp, chunk.data(), chunk.size());
+        }
+        set_completed_mem_count_and_plan(mcp);
+
+        const MemShardBoundary *counted = wait_mem_shard_counted(mcp);
+        std::array<MemShardBoundary, MEM_TYPES> shard_boundaries;
+        std::copy(counted, counted + MEM_TYPES, shard_boundaries.begin());
+        boundaries.push_back(shard_boundaries);
+        bool empty = true;
+        for (auto &boundary: shard_boundaries) {
+            empty = empty && boundary.rows == 0 && boundary.last_chunk_id == NO_CHUNK_ID;
+        }
+        empty_shards += empty;
+        set_mem_shard_previous(mcp, accumulate_boundaries(boundaries)[index].data());
+
+        wait_mem_count_and_plan(mcp);
+        merge_shard_segments(mcp, merged, positions);
+        errors += compare_shard_mem_align(mcp, expected_mem_align, index == 0, seed, run, index);
+        destroy_mem_count_and_plan(mcp);
+    }
+    errors += compare_segment_lists("sharded", merged, expected, seed, run);
+    if (errors) {
+        for (uint32_t index = 0; index < windows.size(); ++index) {
+            printf("  shard:%u [0x%08X, 0x%08X] rows ROM:%lu INPUT:%lu RAM:%lu\n", index, windows[index].from_addr,
+                windows[index].to_addr, boundaries[index][ROM_ID].rows, boundaries[index][INPUT_ID].rows,
+                boundaries[index][RAM_ID].rows);
+        }
+    }
+    ++sharded_runs;
+    return errors;
+}
+
+// Run modes, each seed cycles through them
+#define RUN_RANDOM 0           // random interleaving on every point
+#define RUN_PARKED_PLANNERS 1  // every locator, the last one included, is published while all the
+                               // planners are parked between an empty read and the completed check
+#define RUN_SHARDED 2          // random interleaving, the trace is also planned by shards
+#define RUN_MODES 3
+
+static const char *run_mode_name(uint32_t mode) {
+    switch (mode) {
+        case RUN_PARKED_PLANNERS: return "parked_planners";
+        case RUN_SHARDED: return "sharded";
+    }
+    return "random";
+}
+
+static void set_run_mode(uint32_t mode) {
+    parked_planners.store(0, std::memory_order_relaxed);
+    locators_completing.store(false, std::memory_order_relaxed);
+    park_planners.store(mode == RUN_PARKED_PLANNERS, std::memory_order_release);
+}
+
+static uint32_t run_pipeline(TestTrace &trace, RefPlanner &reference, uint64_t seed, uint32_t run) {
+    interleave_seed.store(seed * 131 + run, std::memory_order_relaxed);
+    const uint32_t mode = (seed + run) % RUN_MODES;
+    set_run_mode(mode);
+    uint64_t state = seed ^ ((uint64_t)run << 32) ^ 0x5DEECE66DULL;
+    MemCountAndPlan *mcp = create_mem_count_and_plan();
+    execute_mem_count_and_plan(mcp);
+    // producer adds chunks with random pauses
+    for (auto &chunk: trace.chunks) {
+        if (xorshift64(state) % 4 == 0) {
+            usleep(xorshift64(state) % 200);
+        }
+        add_chunk_mem_count_and_plan(mcp, chunk.data(), chunk.size());
+    }
+    set_completed_mem_count_and_plan(mcp);
+    wait_mem_count_and_plan(mcp);
+    uint32_t errors = compare_segments(mcp, reference, seed, run);
+    errors += compare_mem_align(mcp, reference, seed, run);
+    // not sharded, must return at once without boundaries
+    if (wait_mem_shard_counted(mcp) != nullptr) {
+        printf("ERROR seed:%lu run:%u wait_mem_shard_counted without shard\n", seed, run);
+        ++errors;
+    }
+    if (mode == RUN_SHARDED) {
+        std::vector<RefSegment> segments[MEM_TYPES];
+        MemAlignSegments mem_align;
+        collect_segments(mcp, segments);
+        collect_mem_align(mcp, mem_align);
+        destroy_mem_count_and_plan(mcp);
+        mcp = nullptr;
+        errors += run_shards(trace, reference, segments, mem_align, seed, run);
+    }
+    if (errors) {
+        printf("FAIL seed:%lu run:%u mode:%s\n", seed, run, run_mode_name(mode));
+    }
+    if (mcp != nullptr) {
+        destroy_mem_count_and_plan(mcp);
+    }
+    set_run_mode(RUN_RANDOM);
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    const uint32_t seeds = argc > 1 ? strtoul(argv[1], nullptr, 10) : 8;
+    const uint64_t first_seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    const uint32_t runs = argc > 3 ? strtoul(argv[3], nullptr, 10) : 2;
+
+    printf("mem_oracle_test threads:%d planners:%d ram_rows:%d rom_rows:%d input_rows:%d seeds:%u first_seed:%lu runs:%u\n",
+        MAX_THREADS, MAX_MEM_PLANNERS, RAM_ROWS, ROM_ROWS, INPUT_ROWS, seeds, first_seed, runs);
+
+    uint32_t failed = 0;
+    for (uint64_t seed = first_seed; seed < first_seed + seeds; ++seed) {
+        TestTrace trace;
+        generate_trace(seed, trace);
+        RefPlanner reference;
+        uint32_t chunk_id = 0;
+        for (auto &chunk: trace.chunks) {
+            reference.count(chunk_id++, chunk.data(), chunk.size());
+        }
+        reference.plan_immutable(ROM_ID, ROM_ROWS, ROM_ADDR);
+        reference.plan_immutable(INPUT_ID, INPUT_ROWS, INPUT_ADDR);
+        reference.plan_ram(RAM_ROWS);
+
+        uint32_t errors = 0;
+        for (uint32_t run = 0; run < runs; ++run) {
+            errors += run_pipeline(trace, reference, seed, run);
+        }
+        printf("%s seed:%lu chunks:%lu segments ROM:%lu INPUT:%lu RAM:%lu\n", errors ? "FAIL" : "OK", seed,
+            trace.chunks.size(), reference.segments[ROM_ID].size(), reference.segments[INPUT_ID].size(),
+            reference.segments[RAM_ID].size());
+        if (errors) ++failed;
+    }
+    printf("sharded runs:%u segment edge boundaries:%u empty shards:%u\n", sharded_runs, shard_edge_boundaries, empty_shards);
+    if (sharded_runs > 0 && shard_edge_boundaries == 0) {
+        printf("FAIL no shard boundary on a segment edge\n");
+        ++failed;
+    }
+    printf("mem_oracle_test %s (%u/%u seeds failed)\n", failed ? "FAILED" : "PASSED", failed, seeds);
+    return failed ? 1 : 0;
+}
@@ -1,4 +1,5 @@
 #include "mem_planner.hpp"
+#include "mem_telemetry.hpp"
 
 MemPlanner::MemPlanner(uint32_t id, uint32_t rows, uint32_t from_addr, uint32_t mb_size)
 #ifdef MEM_CHECK_POINT_MAP
@@ -11,6 +12,8 @@ MemPlanner::MemPlanner(uint32_t id, uint32_t rows, uint32_t from_addr, uint32_t
     reference_addr = 0;
     reference_skip = 0;
     locators_done = 0;
+    rows_offset = 0;
+    current_segment_id = 0;
     #ifdef MEM_PLANNER_STATS
     locators_time_count = 0;
     #endif
@@ -50,19 +53,26 @@ MemPlanner::~MemPlanner() {
 
 const MemLocator *MemPlanner::get_next_locator(MemLocators &locators, uint32_t &segment_id, uint32_t us_timeout) {
     const MemLocator *plocator = locators.get_locator(segment_id);
-    bool completed = false;
-    while (plocator == nullptr) {
-        if (completed && locators.is_completed()) {
-            return nullptr;
+    if (plocator != nullptr) {
+        return plocator;
+    }
+    mem_telemetry_event(MEM_EVENT_WAIT_START);
+    while (true) {
+        MEM_INTERLEAVE_AT(MEM_POINT_LOCATOR_WAIT);
+        if (locators.is_completed()) {
+            // last locators could be pushed after the previous empty read, once completed is
+            // observed (acquire) all of them are visible, read again before giving up. This
+            // window is forced by the parked_planners mode of mem_oracle_test.
+            plocator = locators.get_locator(segment_id);
+            break;
         }
         plocator = locators.get_locator(segment_id);
         if (plocator != nullptr) {
-            return plocator;
+            break;
         }
-        completed = true;
         usleep(us_timeout);
-        continue;
     }
+    mem_telemetry_event(MEM_EVENT_WAIT_END, plocator ? segment_id : NO_CHUNK_ID);
     return plocator;
 }
 
@@ -74,9 +84,11 @@ void MemPlanner::execute_from_locators(const std::vector<MemCounter *> &workers,
         if ((locator = get_next_locator(locators, segment_id)) == nullptr) {
             break;
         }
+        MEM_INTERLEAVE();
         execute_from_locator(workers, segment_id, locator);
         segments.set(segment_id, current_segment);
         current_segment = nullptr;
+        mem_telemetry_event(MEM_EVENT_SEGMENT_CLOSED, segment_id);
     }
     elapsed = get_usec() - init;
 }
@@ -85,6 +97,7 @@ void MemPlanner::execute_from_locator(const std::vector<MemCounter *> &workers,
     uint32_t addr = 0;
 
     ++locators_done;
+    current_segment_id = segment_id;
     #ifdef MEM_PLANNER_STATS
     uint32_t addr_count = 0;
     uint32_t offset_count = 0;
@@ -154,7 +167,7 @@ void MemPlanner::update_segment_stats(uint32_t addr_count, uint32_t offset_count
 
 void MemPlanner::generate_locators(const std::vector<MemCounter *> &workers, MemLocators &locators) {
     uint64_t init = get_usec();
-    rows_available = rows;
+    rows_available = rows - rows_offset;
     uint32_t count;
     uint32_t offset, max_offset;
     bool inserted_first_locator = false;
@@ -202,6 +215,7 @@ void MemPlanner::generate_locators(const std::vector<MemCounter *> &workers, Mem
             }
         }
     }
+    MEM_INTERLEAVE_AT(MEM_POINT_LOCATORS_COMPLETED);
     locators.set_completed();
     elapsed = get_usec() - init;
 }
@@ -225,14 +239,15 @@ uint32_t MemPlanner::get_max_offset(const std::vector<MemCounter *> &workers, ui
 
 bool MemPlanner::add_chunk(uint32_t chunk_id, uint32_t addr, uint32_t count, uint32_t skip) {
     if (current_segment == nullptr) {
-        // include first chunk
-        uint32_t consumed = std::min(count, rows);
+        // include first chunk, first segment could be partially used by previous shards
+        uint32_t segment_rows = current_segment_id == 0 ? rows - rows_offset : rows;
+        uint32_t consumed = std::min(count, segment_rows);
         #ifdef MEM_CHECK_POINT_MAP
         current_segment = new MemSegment(chunk_id, addr, skip, consumed);
         #else
         current_segment = new MemSegment(hash_table, chunk_id, addr, skip, consumed);
         #endif
-        rows_available = rows - consumed;
+        rows_available = segment_rows - consumed;
         return (rows_available != 0);
     }
     if (rows_available <= count) {
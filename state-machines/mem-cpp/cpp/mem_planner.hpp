@@ -50,6 +50,8 @@ private:
     uint32_t current_chunk;
     uint32_t last_addr;
     uint32_t locators_done;
+    uint32_t rows_offset;
+    uint32_t current_segment_id;
     #ifndef MEM_CHECK_POINT_MAP
     uint32_t *chunk_table;
     uint32_t limit_pos;
@@ -93,6 +95,10 @@ public:
     bool add_chunk(uint32_t chunk_id, uint32_t addr, uint32_t count, uint32_t skip = 0);
     void current_segment_add(uint32_t chunk_id, uint32_t addr, uint32_t count);
     void stats();
+    void set_rows_offset(uint32_t offset) {
+        // rows of first segment used by previous shards
+        rows_offset = offset;
+    }
     inline uint64_t *get_locators_times(uint32_t &count);
 };
 
@@ -20,6 +20,7 @@ public:
         clear();
     }
     void set(uint32_t segment_id, MemSegment *value) {
+        MEM_INTERLEAVE();
         std::lock_guard<std::mutex> lock(mtx);
         segments[segment_id] = value;
     }
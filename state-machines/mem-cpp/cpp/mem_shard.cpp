@@ -0,0 +1,72 @@
+#include <thread>
+#include <algorithm>
+
+#include "mem_shard.hpp"
+
+MemShard::MemShard(uint32_t from_addr, uint32_t to_addr, bool count_mem_align)
+: from_addr(from_addr), to_addr(to_addr), count_mem_align(count_mem_align) {
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        boundaries[mem_id] = {0, NO_CHUNK_ID, 0, 0};
+        previous[mem_id] = {0, NO_CHUNK_ID, 0, 0};
+    }
+}
+
+void MemShard::calculate_boundaries(const std::vector<MemCounter *> &workers) {
+    // same address ranges used by planners
+    const uint32_t ranges[MEM_TYPES][2] = {
+        {ROM_ADDR, 128},    // ROM_ID
+        {INPUT_ADDR, 128},  // INPUT_ID
+        {RAM_ADDR, 512}     // RAM_ID
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t mem_id = 0; mem_id < MEM_TYPES; ++mem_id) {
+        uint32_t from_page = MemCounter::addr_to_page(ranges[mem_id][0]);
+        uint32_t to_page = MemCounter::addr_to_page(ranges[mem_id][0] + (ranges[mem_id][1] * 1024 * 1024) - 1);
+        threads.emplace_back([this, &workers, mem_id, from_page, to_page](){
+            calculate_boundary(workers, from_page, to_page, boundaries[mem_id]);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void MemShard::calculate_boundary(const std::vector<MemCounter *> &workers, uint32_t from_page, uint32_t to_page, MemShardBoundary &boundary) {
+    boundary = {0, NO_CHUNK_ID, 0, 0};
+    for (uint32_t page = from_page; page <= to_page; ++page) {
+        uint32_t offset = workers[0]->first_offset[page];
+        uint32_t last_offset = workers[0]->last_offset[page];
+        for (int i = 1; i < MAX_THREADS; ++i) {
+            offset = std::min(offset, workers[i]->first_offset[page]);
+            last_offset = std::max(last_offset, workers[i]->last_offset[page]);
+        }
+        for (;offset <= last_offset; ++offset) {
+            for (uint32_t thread_index = 0; thread_index < MAX_THREADS; ++thread_index) {
+                uint32_t pos = workers[thread_index]->get_addr_table(offset);
+                if (pos == 0) continue;
+                boundary.rows += workers[thread_index]->get_count_table(offset);
+                // addresses are visited in ascending order, last visited is the last address
+                boundary.last_chunk_id = workers[thread_index]->get_pos_value(pos);
+                boundary.last_count = workers[thread_index]->get_pos_count(pos + 1);
+                boundary.last_addr = MemCounter::offset_to_addr(offset, thread_index);
+            }
+        }
+    }
+}
+
+uint32_t MemShard::get_rows_by_segment(uint32_t mem_id) {
+    switch (mem_id) {
+        case ROM_ID: return ROM_ROWS;
+        case INPUT_ID: return INPUT_ROWS;
+        case RAM_ID: return RAM_ROWS;
+    }
+    return 0;
+}
+
+uint32_t MemShard::get_first_segment_id(uint32_t mem_id) const {
+    return previous[mem_id].rows / get_rows_by_segment(mem_id);
+}
+
+uint32_t MemShard::get_rows_offset(uint32_t mem_id) const {
+    return previous[mem_id].rows % get_rows_by_segment(mem_id);
+}
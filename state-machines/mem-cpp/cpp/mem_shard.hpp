@@ -0,0 +1,42 @@
+#ifndef __MEM_SHARD_HPP__
+#define __MEM_SHARD_HPP__
+
+#include <stdint.h>
+#include <vector>
+
+#include "mem_config.hpp"
+#include "mem_counter.hpp"
+
+// Sharded mode: each process counts and plans only the addresses inside its window
+// [from_addr, to_addr] of the same memory-op trace. Segments depend on the rows of all
+// previous addresses, for this reason after count phase each shard publishes its boundary
+// (rows and last address reference) by memory type, and waits the accumulated boundary of
+// all previous shards before start plan phase. Segments of each shard are numbered from
+// the first global segment id, the first and last segments of a shard could be partial,
+// and they must be merged with the partial segments of neighbour shards.
+
+struct MemShardBoundary {
+    // rows of the shard (published) or rows of all previous shards (received)
+    uint64_t rows;
+    // reference of last address: last chunk and its rows, NO_CHUNK_ID if shard is empty
+    uint32_t last_chunk_id;
+    uint32_t last_addr;
+    uint32_t last_count;
+};
+
+class MemShard {
+public:
+    uint32_t from_addr;
+    uint32_t to_addr;
+    bool count_mem_align;
+    MemShardBoundary boundaries[MEM_TYPES];
+    MemShardBoundary previous[MEM_TYPES];
+    MemShard(uint32_t from_addr, uint32_t to_addr, bool count_mem_align);
+    void calculate_boundaries(const std::vector<MemCounter *> &workers);
+    uint32_t get_first_segment_id(uint32_t mem_id) const;
+    uint32_t get_rows_offset(uint32_t mem_id) const;
+    static uint32_t get_rows_by_segment(uint32_t mem_id);
+    static void calculate_boundary(const std::vector<MemCounter *> &workers, uint32_t from_page, uint32_t to_page, MemShardBoundary &boundary);
+};
+
+#endif
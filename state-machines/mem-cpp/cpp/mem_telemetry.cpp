@@ -0,0 +1,93 @@
+#include <algorithm>
+#include "mem_telemetry.hpp"
+
+thread_local MemTelemetryRing *mem_telemetry_ring = nullptr;
+
+MemTelemetry::MemTelemetry() : next_ring(0), backlog_pos(0) {
+    for (uint32_t slot = 0; slot < MEM_SLOTS; ++slot) {
+        rings[slot] = new MemTelemetryRing();
+        rings[slot]->slot = slot;
+    }
+}
+
+MemTelemetry::~MemTelemetry() {
+    for (uint32_t slot = 0; slot < MEM_SLOTS; ++slot) {
+        delete rings[slot];
+    }
+}
+
+void MemTelemetry::attach(uint32_t slot) {
+    mem_telemetry_ring = rings[slot];
+}
+
+void MemTelemetry::detach() {
+    mem_telemetry_ring = nullptr;
+}
+
+uint32_t MemTelemetry::pop_rings(MemTelemetryEvent *events, uint32_t max_events) {
+    uint32_t count = 0;
+    uint32_t empty_rings = 0;
+
+    // round-robin between rings, to avoid starvation of last rings when max_events is
+    // smaller than pending events.
+    while (count < max_events && empty_rings < MEM_SLOTS) {
+        if (rings[next_ring]->queue.pop(events[count])) {
+            ++count;
+            empty_rings = 0;
+        } else {
+            ++empty_rings;
+        }
+        next_ring = (next_ring + 1) % MEM_SLOTS;
+    }
+    return count;
+}
+
+void MemTelemetry::collect() {
+    // only one consumer by ring is allowed
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    MemTelemetryEvent events[256];
+    uint32_t count;
+    while ((count = pop_rings(events, 256)) > 0) {
+        backlog.insert(backlog.end(), events, events + count);
+    }
+}
+
+uint32_t MemTelemetry::drain(MemTelemetryEvent *events, uint32_t max_events) {
+    // only one consumer by ring is allowed
+    std::lock_guard<std::mutex> lock(drain_mutex);
+
+    // collected events first, they are older than the events still on the rings
+    uint32_t count = std::min((size_t)max_events, backlog.size() - backlog_pos);
+    std::copy(backlog.begin() + backlog_pos, backlog.begin() + backlog_pos + count, events);
+    backlog_pos += count;
+    if (backlog_pos == backlog.size()) {
+        backlog.clear();
+        backlog_pos = 0;
+    }
+    return count + pop_rings(events + count, max_events - count);
+}
+
+uint64_t MemTelemetry::get_dropped() {
+    uint64_t dropped = 0;
+    for (uint32_t slot = 0; slot < MEM_SLOTS; ++slot) {
+        dropped += rings[slot]->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void MemTelemetryPhase::done() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--running == 0) {
+        cv.notify_one();
+    }
+}
+
+void MemTelemetryPhase::collect_until_done(MemTelemetry &telemetry) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!cv.wait_for(lock, std::chrono::microseconds(MEM_TELEMETRY_COLLECT_US),
+            [this]() { return running == 0; })) {
+        lock.unlock();
+        telemetry.collect();
+        lock.lock();
+    }
+}
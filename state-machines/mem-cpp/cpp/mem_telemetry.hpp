@@ -0,0 +1,99 @@
+#ifndef __MEM_TELEMETRY_HPP__
+#define __MEM_TELEMETRY_HPP__
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "mem_config.hpp"
+#include "circular_queue.hpp"
+
+// Always-on telemetry: each thread writes timestamped events on its own lock-free ring
+// (single producer, single consumer). Producers never block, when ring is full the event
+// is discarded and counted as dropped. While the pipeline runs, the main thread collects the
+// rings periodically in a backlog, so a ring only has to hold the events of one period.
+// Backlog and rings are drained through C API.
+
+#ifndef MEM_TELEMETRY_RING_SIZE
+#define MEM_TELEMETRY_RING_SIZE (1 << 15)
+#endif
+#define MEM_TELEMETRY_COLLECT_US 10000
+
+#define MEM_EVENT_COUNT_PHASE_BEGIN 1
+#define MEM_EVENT_COUNT_PHASE_END 2
+#define MEM_EVENT_PLAN_PHASE_BEGIN 3
+#define MEM_EVENT_PLAN_PHASE_END 4
+#define MEM_EVENT_CHUNK_COUNTED 5
+#define MEM_EVENT_LOCATOR_EMITTED 6
+#define MEM_EVENT_SEGMENT_CLOSED 7
+#define MEM_EVENT_WAIT_START 8
+#define MEM_EVENT_WAIT_END 9
+#define MEM_EVENT_THREAD_CPU 10  // value is the cpu where the thread starts, after pinning
+
+struct MemTelemetryEvent {
+    uint64_t timestamp_ns;
+    uint32_t value;
+    uint16_t event;
+    uint16_t slot;
+};
+
+typedef CircularQueue<MemTelemetryEvent, MEM_TELEMETRY_RING_SIZE> MemTelemetryQueue;
+
+class MemTelemetryRing {
+public:
+    MemTelemetryQueue queue;
+    std::atomic<uint64_t> dropped{0};
+    uint16_t slot;
+    inline void push(uint16_t event, uint32_t value) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        if (!queue.push({(uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec, value, event, slot})) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+class MemTelemetry {
+private:
+    MemTelemetryRing *rings[MEM_SLOTS];
+    std::mutex drain_mutex;
+    uint32_t next_ring;
+    std::vector<MemTelemetryEvent> backlog;
+    size_t backlog_pos;
+    uint32_t pop_rings(MemTelemetryEvent *events, uint32_t max_events);
+public:
+    MemTelemetry();
+    ~MemTelemetry();
+    void attach(uint32_t slot);
+    static void detach();
+    void collect();
+    uint32_t drain(MemTelemetryEvent *events, uint32_t max_events);
+    uint64_t get_dropped();
+};
+
+// Threads still running on a phase. The main thread collects the rings while they run and
+// returns as soon as the last one calls done().
+class MemTelemetryPhase {
+private:
+    uint32_t running;
+    std::mutex mutex;
+    std::condition_variable cv;
+public:
+    MemTelemetryPhase(uint32_t running) : running(running) {}
+    void done();
+    void collect_until_done(MemTelemetry &telemetry);
+};
+
+// ring of current thread, nullptr if thread isn't attached
+extern thread_local MemTelemetryRing *mem_telemetry_ring;
+
+inline void mem_telemetry_event(uint16_t event, uint32_t value = 0) {
+    if (mem_telemetry_ring != nullptr) {
+        mem_telemetry_ring->push(event, value);
+    }
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <stdexcept>
 #include <mutex>
 #include <atomic>
+#include <algorithm>
 
 #include "api.hpp"
 #include "mem_types.hpp"
@@ -26,6 +27,8 @@
 #include "mem_context.hpp"
 #include "tools.hpp"
 #include "mem_count_and_plan.hpp"
+#include "mem_affinity.hpp"
+#include "mem_telemetry.hpp"
 
 class MemTestChunk {
 public:
@@ -46,6 +49,13 @@ public:
         chunks.reserve(MAX_CHUNKS);
     }
     void load(const char *path) {
+        // this thread acts as producer, chunks are loaded (first touch) on the same
+        // numa node used by counters.
+        MemAffinity affinity;
+        affinity.configure_from_env();
+        if (affinity.pin_node()) {
+            printf("Producer pinned on %s\n", affinity.to_string().c_str());
+        }
         printf("Loading compact data...\n");
         uint32_t tot_chunks = 0;
         uint32_t tot_ops = 0;
@@ -106,6 +116,37 @@ public:
         }
         printf("chunks: %ld  tot_chunks: %d tot_ops: %d tot_time:%ld (ms) Speed(Mhz): %04.2f\n", chunks.size(), tot_chunks, tot_ops, (chunks.size() * TIME_US_BY_CHUNK)/1000, (double)(CHUNK_SIZE) / TIME_US_BY_CHUNK);
     }
+    void telemetry_stats(MemCountAndPlan *cp) {
+        std::vector<MemTelemetryEvent> events(4096);
+        uint32_t counts[MEM_SLOTS][MEM_EVENT_THREAD_CPU + 1] = {};
+        int cpus[MEM_SLOTS];
+        std::fill(cpus, cpus + MEM_SLOTS, MEM_AFFINITY_NO_CPU);
+        uint64_t wait_ns[MEM_SLOTS] = {};
+        uint64_t wait_start_ns[MEM_SLOTS] = {};
+        uint32_t count;
+        while ((count = drain_mem_telemetry(cp, events.data(), events.size())) > 0) {
+            for (uint32_t index = 0; index < count; ++index) {
+                const MemTelemetryEvent &event = events[index];
+                counts[event.slot][event.event] += 1;
+                if (event.event == MEM_EVENT_WAIT_START) {
+                    wait_start_ns[event.slot] = event.timestamp_ns;
+                } else if (event.event == MEM_EVENT_WAIT_END) {
+                    wait_ns[event.slot] += event.timestamp_ns - wait_start_ns[event.slot];
+                } else if (event.event == MEM_EVENT_THREAD_CPU) {
+                    cpus[event.slot] = event.value;
+                }
+            }
+        }
+        // cpu and node where each thread started, to check the placement of MEM_CPP_AFFINITY
+        // policies on multi-node hosts
+        for (uint32_t slot = 0; slot < MEM_SLOTS; ++slot) {
+            const int node = cpus[slot] == MEM_AFFINITY_NO_CPU ? MEM_AFFINITY_NO_NODE : MemAffinity::get_cpu_node(cpus[slot]);
+            printf("TELEMETRY|S: %2d|CPU: %3d|NODE: %2d|CHUNKS: %5d|LOCATORS: %4d|SEGMENTS: %4d|WAITS: %5d|WAIT: %7.2f ms\n", slot,
+                cpus[slot], node, counts[slot][MEM_EVENT_CHUNK_COUNTED], counts[slot][MEM_EVENT_LOCATOR_EMITTED],
+                counts[slot][MEM_EVENT_SEGMENT_CLOSED], counts[slot][MEM_EVENT_WAIT_END], wait_ns[slot] / 1000000.0);
+        }
+        printf("TELEMETRY|DROPPED: %ld\n", get_mem_telemetry_dropped(cp));
+    }
     void execute(void) {
         printf("Starting...\n");
         auto cp = create_mem_count_and_plan();
@@ -141,6 +182,7 @@ public:
         set_completed_mem_count_and_plan(cp);
         wait_mem_count_and_plan(cp);
         stats_mem_count_and_plan(cp);
+        telemetry_stats(cp);
         destroy_mem_count_and_plan(cp);
     }
 };
@@ -259,6 +259,21 @@ pub struct MemCheckPoint {
 pub struct MemAlignChunkCounters {
     _unused: [u8; 0],
 }
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MemAlignCheckPoint {
+    _unused: [u8; 0],
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MemTelemetryEvent {
+    _unused: [u8; 0],
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MemShardBoundary {
+    _unused: [u8; 0],
+}
 unsafe extern "C" {
     pub fn create_mem_count_and_plan() -> *mut MemCountAndPlan;
 }
@@ -310,6 +325,44 @@ unsafe extern "C" {
 unsafe extern "C" {
     pub fn get_mem_align_total_counters(mcp: *mut MemCountAndPlan) -> *const MemAlignChunkCounters;
 }
+unsafe extern "C" {
+    pub fn get_mem_align_segment_count(mcp: *mut MemCountAndPlan, instance_type: u32) -> u32;
+}
+unsafe extern "C" {
+    pub fn get_mem_align_segment_check_points(
+        mcp: *mut MemCountAndPlan,
+        instance_type: u32,
+        segment_id: u32,
+        count: *mut u32,
+    ) -> *const MemAlignCheckPoint;
+}
+unsafe extern "C" {
+    pub fn drain_mem_telemetry(
+        mcp: *mut MemCountAndPlan,
+        events: *mut MemTelemetryEvent,
+        max_events: u32,
+    ) -> u32;
+}
+unsafe extern "C" {
+    pub fn get_mem_telemetry_dropped(mcp: *mut MemCountAndPlan) -> u64;
+}
+unsafe extern "C" {
+    pub fn set_mem_shard(
+        mcp: *mut MemCountAndPlan,
+        from_addr: u32,
+        to_addr: u32,
+        count_mem_align: bool,
+    );
+}
+unsafe extern "C" {
+    pub fn wait_mem_shard_counted(mcp: *mut MemCountAndPlan) -> *const MemShardBoundary;
+}
+unsafe extern "C" {
+    pub fn set_mem_shard_previous(mcp: *mut MemCountAndPlan, previous: *const MemShardBoundary);
+}
+unsafe extern "C" {
+    pub fn get_mem_shard_first_segment_id(mcp: *mut MemCountAndPlan, mem_id: u32) -> u32;
+}
 unsafe extern "C" {
     pub fn get_mem_stats_len(mcp: *mut MemCountAndPlan) -> u64;
 }
@@ -5,6 +5,10 @@
 mod bindings;
 mod mem_checkpoints;
 mod mem_planner;
+mod mem_shard;
+mod mem_telemetry;
 
 pub use mem_checkpoints::*;
 pub use mem_planner::*;
+pub use mem_shard::*;
+pub use mem_telemetry::*;
@@ -1,7 +1,7 @@
 use crate::{bindings, MemPlanner};
 /// Represents a memory checkpoint
 #[repr(C)]
-#[derive(Debug)]
+#[derive(Debug, Clone, Copy)]
 pub struct CppMemCheckPoint {
     pub chunk_id: u32,
     pub from_addr: u32,
@@ -37,3 +37,45 @@ impl CppMemCheckPoint {
         unsafe { std::slice::from_raw_parts(ptr, count as usize) }
     }
 }
+
+/// Represents a mem align checkpoint, for each operation type (full_5, full_3, full_2,
+/// read_byte, write_byte) the operations to skip and the operations to collect.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct CppMemAlignCheckPoint {
+    pub chunk_id: u32,
+    pub skip: [u32; 5],
+    pub count: [u32; 5],
+}
+
+impl CppMemAlignCheckPoint {
+    /// Retrieves a array pointer of MemAlignCheckPoint from C++ given a valid instance type
+    /// (read_byte, write_byte, byte, full) and segment ID.
+    ///
+    /// # Safety
+    /// This function assumes the underlying C++ memory is valid and the pointer returned
+    /// is safe to read for `count` elements. The ownership of array remains with C++.
+    pub fn from_cpp(
+        mem_planner: &MemPlanner,
+        instance_type: u32,
+        segment_id: u32,
+    ) -> &[CppMemAlignCheckPoint] {
+        let mut count: u32 = 0;
+
+        let ptr = unsafe {
+            bindings::get_mem_align_segment_check_points(
+                mem_planner.inner(),
+                instance_type,
+                segment_id,
+                &mut count as *mut u32,
+            )
+        } as *mut CppMemAlignCheckPoint;
+
+        if ptr.is_null() || count == 0 {
+            return &[];
+        }
+
+        // SAFETY: assumes pointer is valid for `count` elements
+        unsafe { std::slice::from_raw_parts(ptr, count as usize) }
+    }
+}
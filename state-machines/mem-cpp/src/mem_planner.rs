@@ -1,16 +1,17 @@
 use proofman_util::{timer_start_info, timer_stop_and_log_info};
-use std::{os::raw::c_void, sync::Arc};
+use std::{collections::HashMap, os::raw::c_void};
 
 use crate::*;
 
 #[cfg(feature = "save_mem_plans")]
 use mem_common::save_plans;
-use mem_common::{
-    MemAlignCounters, MemAlignPlanner, MemModuleCheckPoint, MemModuleSegmentCheckPoint,
-};
+use mem_common::{MemAlignCheckPoint, MemModuleCheckPoint, MemModuleSegmentCheckPoint};
 
-use zisk_common::{CheckPoint, ChunkId, InstanceType, Plan, SegmentId};
-use zisk_pil::{INPUT_DATA_AIR_IDS, MEM_AIR_IDS, ROM_DATA_AIR_IDS, ZISK_AIRGROUP_ID};
+use zisk_common::{CheckPoint, ChunkId, CollectCounter, InstanceType, Plan, SegmentId};
+use zisk_pil::{
+    INPUT_DATA_AIR_IDS, MEM_AIR_IDS, MEM_ALIGN_AIR_IDS, MEM_ALIGN_BYTE_AIR_IDS,
+    MEM_ALIGN_READ_BYTE_AIR_IDS, MEM_ALIGN_WRITE_BYTE_AIR_IDS, ROM_DATA_AIR_IDS, ZISK_AIRGROUP_ID,
+};
 
 pub struct MemPlanner {
     inner: *mut bindings::MemCountAndPlan,
@@ -37,11 +38,9 @@ impl Default for MemPlanner {
 /// - `add_chunk(&self, len, data)`: Adds a chunk of memory data to the planner.
 /// - `stats(&self)`: Prints or collects statistics from the planner.
 /// - `set_completed(&self)`: Signals that all chunks have been added and processing can complete.
-/// - `wait_mem_align_plans(&self)`: Waits for internal processing to finish and retrieves memory alignment plans.
 /// - `wait(&self)`: Waits for all background processing to complete.
-/// - `collect_plans(&self, mem_align_plans)`: Collects memory plans, incorporating provided alignment plans.
-/// - `get_mem_align_counters(&self)`: Retrieves a slice of memory alignment counters (internal use).
-/// - `get_total_mem_align_counters(&self)`: Retrieves the total memory alignment counters (internal use).
+/// - `collect_mem_align_plans(&self)`: Retrieves memory alignment plans, planned in C++.
+/// - `collect_plans(&self)`: Collects memory plans, including memory alignment plans.
 ///
 /// # Safety
 /// Many methods interact with raw pointers and FFI bindings to C++ code. It is assumed that the underlying
@@ -83,51 +82,58 @@ impl MemPlanner {
         unsafe { bindings::set_completed_mem_count_and_plan(self.inner) };
     }
 
-    fn get_mem_align_counters(&self) -> &[MemAlignCounters] {
-        let mut count: u32 = 0;
-
-        let ptr = unsafe { bindings::get_mem_align_counters(self.inner(), &mut count as *mut u32) }
-            as *mut MemAlignCounters;
-
-        if ptr.is_null() || count == 0 {
-            return &[];
-        }
-
-        // SAFETY: assumes pointer is valid for `count` elements
-        unsafe { std::slice::from_raw_parts(ptr, count as usize) }
-    }
-
-    fn get_total_mem_align_counters(&self) -> MemAlignCounters {
-        let ptr = unsafe { bindings::get_mem_align_total_counters(self.inner()) }
-            as *mut MemAlignCounters;
-        if ptr.is_null() {
-            return MemAlignCounters::default();
-        }
-        unsafe { *ptr }
-    }
-    /// Retrieves a Vec of mem_align plans. This method first waits for the internal processing to complete and
-    /// after that retrieves the plans.
+    /// Retrieves a Vec of mem_align plans. The mem align instances are planned in C++ during
+    /// the plan phase, in parallel with the memory planners. Must be called after `wait`.
     ///
     /// # Returns
     /// A vector of memory alignment plans.
-    pub fn wait_mem_align_plans(&self) -> Vec<Plan> {
-        unsafe {
-            bindings::wait_mem_align_counters(self.inner);
-        };
-        let counters = self.get_mem_align_counters();
-        let mut mem_align_planner = MemAlignPlanner::new(Arc::new(vec![]));
-
-        // It is not necessary to calculate the totals; they have been accumulated as the counters were added
-        let tot_counters = self.get_total_mem_align_counters();
-
-        let full_rows = tot_counters.full_2 * 2 + tot_counters.full_3 * 3 + tot_counters.full_5 * 5;
-        mem_align_planner.align_plan_from_counters(
-            full_rows,
-            tot_counters.read_byte,
-            tot_counters.write_byte,
-            counters,
-        );
-        mem_align_planner.collect_plans()
+    pub fn collect_mem_align_plans(&self) -> Vec<Plan> {
+        let mut plans = Vec::new();
+        for (instance_type, air_id) in [
+            MEM_ALIGN_READ_BYTE_AIR_IDS[0],
+            MEM_ALIGN_WRITE_BYTE_AIR_IDS[0],
+            MEM_ALIGN_BYTE_AIR_IDS[0],
+            MEM_ALIGN_AIR_IDS[0],
+        ]
+        .iter()
+        .enumerate()
+        {
+            let segments_count =
+                unsafe { bindings::get_mem_align_segment_count(self.inner, instance_type as u32) };
+            for segment_id in 0..segments_count {
+                let mut chunks: Vec<ChunkId> = Vec::new();
+                let mut checkpoints: HashMap<ChunkId, MemAlignCheckPoint> = HashMap::new();
+                for checkpoint in
+                    CppMemAlignCheckPoint::from_cpp(self, instance_type as u32, segment_id)
+                {
+                    let chunk_id = ChunkId(checkpoint.chunk_id as usize);
+                    let counter =
+                        |i: usize| CollectCounter::new(checkpoint.skip[i], checkpoint.count[i]);
+                    chunks.push(chunk_id);
+                    checkpoints.insert(
+                        chunk_id,
+                        MemAlignCheckPoint {
+                            air_id: *air_id,
+                            chunk_id,
+                            full_5: counter(0),
+                            full_3: counter(1),
+                            full_2: counter(2),
+                            read_byte: counter(3),
+                            write_byte: counter(4),
+                        },
+                    );
+                }
+                plans.push(Plan::new(
+                    ZISK_AIRGROUP_ID,
+                    *air_id,
+                    Some(SegmentId(segment_id as usize)),
+                    InstanceType::Instance,
+                    CheckPoint::Multiple(chunks),
+                    Some(Box::new(checkpoints)),
+                ));
+            }
+        }
+        plans
     }
 
     /// Waits for all background processing to complete
@@ -135,52 +141,26 @@ impl MemPlanner {
         unsafe { bindings::wait_mem_count_and_plan(self.inner) };
     }
 
-    /// Retrieves a Vec of memory plans, adding to this result plans the mem_align_plans provided as argument.
-    ///
-    /// # Parameters
-    /// - `mem_align_plans`: A mutable reference to a vector of memory alignment plans to be moved to the result.
+    /// Retrieves a Vec of memory plans, mem_align plans first. Must be called after `wait`.
     ///
     /// # Safety
     /// This function assumes the underlying C++ memory is valid and the pointer returned
     /// is safe to read for `count` elements.
-    pub fn collect_plans(&self, mem_align_plans: &mut Vec<Plan>) -> Vec<Plan> {
-        let mut plans = std::mem::take(mem_align_plans);
+    pub fn collect_plans(&self) -> Vec<Plan> {
         timer_start_info!(COLLECT_MEM_PLANS);
+        let mut plans = self.collect_mem_align_plans();
         for (mem_id, air_id) in
             [ROM_DATA_AIR_IDS[0], INPUT_DATA_AIR_IDS[0], MEM_AIR_IDS[0]].iter().enumerate()
         {
             let mem_segments_count: u32 =
                 unsafe { bindings::get_mem_segment_count(self.inner, mem_id as u32) };
             for segment_id in 0..mem_segments_count {
-                let mut chunks: Vec<ChunkId> = Vec::new();
-                let mut segment = MemModuleSegmentCheckPoint::new();
-                segment.is_last_segment = segment_id == mem_segments_count - 1;
                 let checkpoints = CppMemCheckPoint::from_cpp(self, mem_id as u32, segment_id);
-                for checkpoint in checkpoints {
-                    let chunk_id = ChunkId(checkpoint.chunk_id as usize);
-                    chunks.push(chunk_id);
-                    if segment.chunks.is_empty() {
-                        segment.first_chunk_id = Some(chunk_id);
-                    }
-
-                    segment.chunks.insert(
-                        chunk_id,
-                        MemModuleCheckPoint {
-                            from_addr: checkpoint.from_addr >> 3,
-                            from_skip: checkpoint.from_skip,
-                            to_addr: checkpoint.to_addr >> 3,
-                            to_count: checkpoint.to_count,
-                            count: checkpoint.count,
-                        },
-                    );
-                }
-                plans.push(Plan::new(
-                    ZISK_AIRGROUP_ID,
+                plans.push(Self::segment_plan(
                     *air_id,
-                    Some(SegmentId(segment_id as usize)),
-                    InstanceType::Instance,
-                    CheckPoint::Multiple(chunks),
-                    Some(Box::new(segment)),
+                    segment_id,
+                    segment_id == mem_segments_count - 1,
+                    checkpoints,
                 ));
             }
         }
@@ -192,6 +172,69 @@ impl MemPlanner {
         plans
     }
 
+    /// Collects the memory plans of a sharded execution from the segments merged with
+    /// `merge_shard_segments`, the result is the same as `collect_plans` of a single-process
+    /// execution. `mem_align_plans` are the plans of the shard that counted mem align operations
+    /// (see `collect_mem_align_plans`).
+    pub fn collect_merged_plans(
+        merged: &[Vec<Vec<CppMemCheckPoint>>],
+        mem_align_plans: &mut Vec<Plan>,
+    ) -> Vec<Plan> {
+        let mut plans = std::mem::take(mem_align_plans);
+        for (mem_id, air_id) in
+            [ROM_DATA_AIR_IDS[0], INPUT_DATA_AIR_IDS[0], MEM_AIR_IDS[0]].iter().enumerate()
+        {
+            let mem_segments_count = merged[mem_id].len() as u32;
+            for (segment_id, checkpoints) in merged[mem_id].iter().enumerate() {
+                let segment_id = segment_id as u32;
+                plans.push(Self::segment_plan(
+                    *air_id,
+                    segment_id,
+                    segment_id == mem_segments_count - 1,
+                    checkpoints,
+                ));
+            }
+        }
+        plans
+    }
+
+    fn segment_plan(
+        air_id: usize,
+        segment_id: u32,
+        is_last_segment: bool,
+        checkpoints: &[CppMemCheckPoint],
+    ) -> Plan {
+        let mut chunks: Vec<ChunkId> = Vec::new();
+        let mut segment = MemModuleSegmentCheckPoint::new();
+        segment.is_last_segment = is_last_segment;
+        for checkpoint in checkpoints {
+            let chunk_id = ChunkId(checkpoint.chunk_id as usize);
+            chunks.push(chunk_id);
+            if segment.chunks.is_empty() {
+                segment.first_chunk_id = Some(chunk_id);
+            }
+
+            segment.chunks.insert(
+                chunk_id,
+                MemModuleCheckPoint {
+                    from_addr: checkpoint.from_addr >> 3,
+                    from_skip: checkpoint.from_skip,
+                    to_addr: checkpoint.to_addr >> 3,
+                    to_count: checkpoint.to_count,
+                    count: checkpoint.count,
+                },
+            );
+        }
+        Plan::new(
+            ZISK_AIRGROUP_ID,
+            air_id,
+            Some(SegmentId(segment_id as usize)),
+            InstanceType::Instance,
+            CheckPoint::Multiple(chunks),
+            Some(Box::new(segment)),
+        )
+    }
+
     // Collects memory statistics from the planner.
     // pub fn get_mem_stats(&self) -> Vec<ExecutorStatsEnum> {
     //     let mem_stats_len = unsafe { bindings::get_mem_stats_len(self.inner) };
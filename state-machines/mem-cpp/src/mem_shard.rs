@@ -0,0 +1,155 @@
+//! Sharded mode of the memory planner: each process counts and plans a window of addresses,
+//! exchanging the boundaries of its window with the other shards between both phases.
+//!
+//! This is a library API, the MO runner and the executor still plan with a single
+//! `MemPlanner`. Distributing the windows and the boundary exchange between processes is left
+//! to the caller.
+
+use std::collections::HashMap;
+
+use crate::{bindings, CppMemCheckPoint, MemPlanner};
+
+/// Number of memory types planned by C++ (ROM_ID, INPUT_ID, RAM_ID)
+pub const MEM_TYPES: usize = 3;
+
+/// Value of `last_chunk_id` when a shard has no addresses of a memory type
+pub const NO_CHUNK_ID: u32 = 0xFFFF_FFFF;
+
+/// Boundary of a shard for one memory type, with the same layout as C++ `MemShardBoundary`.
+///
+/// After the count phase each shard publishes its own boundaries (rows of the shard and
+/// reference of its last address). Before the plan phase each shard receives the boundaries
+/// accumulated over all previous shards (see [`MemShardBoundary::accumulate`]).
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct MemShardBoundary {
+    pub rows: u64,
+    pub last_chunk_id: u32,
+    pub last_addr: u32,
+    pub last_count: u32,
+}
+
+impl Default for MemShardBoundary {
+    fn default() -> Self {
+        Self { rows: 0, last_chunk_id: NO_CHUNK_ID, last_addr: 0, last_count: 0 }
+    }
+}
+
+impl MemShardBoundary {
+    /// Given the boundaries published by all shards, sorted by address window, returns the
+    /// previous boundaries that must be sent to each shard: accumulated rows and the last
+    /// address reference of the nearest previous non-empty shard.
+    pub fn accumulate(
+        shards: &[[MemShardBoundary; MEM_TYPES]],
+    ) -> Vec<[MemShardBoundary; MEM_TYPES]> {
+        let mut previous = [MemShardBoundary::default(); MEM_TYPES];
+        let mut result = Vec::with_capacity(shards.len());
+        for boundaries in shards {
+            result.push(previous);
+            for (mem_id, boundary) in boundaries.iter().enumerate() {
+                previous[mem_id].rows += boundary.rows;
+                if boundary.last_chunk_id != NO_CHUNK_ID {
+                    previous[mem_id].last_chunk_id = boundary.last_chunk_id;
+                    previous[mem_id].last_addr = boundary.last_addr;
+                    previous[mem_id].last_count = boundary.last_count;
+                }
+            }
+        }
+        result
+    }
+}
+
+/// Segment planned by a shard, `segment_id` is the global segment id. First and last
+/// segments of a shard could be partial, the rest of the segment is on neighbour shards.
+#[derive(Debug, Clone)]
+pub struct MemShardSegment {
+    pub mem_id: u32,
+    pub segment_id: u32,
+    pub checkpoints: Vec<CppMemCheckPoint>,
+}
+
+/// Merges the segments of all shards, sorted by address window, in the segments of a
+/// single-process execution: for each memory type, the list of segments ordered by id with
+/// its checkpoints. Checkpoints of the same chunk in the same segment are joined keeping
+/// the first position, as the C++ planner does when an existing chunk is updated.
+pub fn merge_shard_segments(shards: &[Vec<MemShardSegment>]) -> Vec<Vec<Vec<CppMemCheckPoint>>> {
+    let mut merged: Vec<Vec<Vec<CppMemCheckPoint>>> = vec![Vec::new(); MEM_TYPES];
+    let mut positions: Vec<Vec<HashMap<u32, usize>>> = vec![Vec::new(); MEM_TYPES];
+
+    for segments in shards {
+        for segment in segments {
+            let mem_id = segment.mem_id as usize;
+            let segment_id = segment.segment_id as usize;
+            if merged[mem_id].len() <= segment_id {
+                merged[mem_id].resize_with(segment_id + 1, Vec::new);
+                positions[mem_id].resize_with(segment_id + 1, HashMap::new);
+            }
+            let checkpoints = &mut merged[mem_id][segment_id];
+            let chunk_positions = &mut positions[mem_id][segment_id];
+            for checkpoint in &segment.checkpoints {
+                match chunk_positions.get(&checkpoint.chunk_id) {
+                    Some(&index) => {
+                        // addresses of later shards are always greater
+                        let joined = &mut checkpoints[index];
+                        joined.to_addr = checkpoint.to_addr;
+                        joined.to_count = checkpoint.to_count;
+                        joined.count += checkpoint.count;
+                    }
+                    None => {
+                        chunk_positions.insert(checkpoint.chunk_id, checkpoints.len());
+                        checkpoints.push(*checkpoint);
+                    }
+                }
+            }
+        }
+    }
+    merged
+}
+
+impl MemPlanner {
+    /// Configures sharded mode, only addresses in `[from_addr, to_addr]` are counted and
+    /// planned. Only one shard must count mem align operations. Must be called before
+    /// `execute`.
+    pub fn set_shard(&self, from_addr: u32, to_addr: u32, count_mem_align: bool) {
+        unsafe { bindings::set_mem_shard(self.inner(), from_addr, to_addr, count_mem_align) };
+    }
+
+    /// Waits for the end of the count phase and returns the boundaries of this shard. Panics
+    /// if `set_shard` wasn't called.
+    pub fn wait_shard_counted(&self) -> [MemShardBoundary; MEM_TYPES] {
+        let ptr =
+            unsafe { bindings::wait_mem_shard_counted(self.inner()) } as *const MemShardBoundary;
+        assert!(!ptr.is_null(), "MemPlanner isn't in sharded mode");
+        unsafe { *(ptr as *const [MemShardBoundary; MEM_TYPES]) }
+    }
+
+    /// Sends the boundaries accumulated over all previous shards, the plan phase starts
+    /// after this call. The C++ side throws if `set_shard` wasn't called.
+    pub fn set_shard_previous(&self, previous: &[MemShardBoundary; MEM_TYPES]) {
+        unsafe {
+            bindings::set_mem_shard_previous(
+                self.inner(),
+                previous.as_ptr() as *const bindings::MemShardBoundary,
+            )
+        };
+    }
+
+    /// Retrieves the segments planned by this shard with global segment ids. Must be called
+    /// after `wait`.
+    pub fn collect_shard_segments(&self) -> Vec<MemShardSegment> {
+        let mut segments = Vec::new();
+        for mem_id in 0..MEM_TYPES as u32 {
+            let first_segment_id =
+                unsafe { bindings::get_mem_shard_first_segment_id(self.inner(), mem_id) };
+            let count = unsafe { bindings::get_mem_segment_count(self.inner(), mem_id) };
+            for segment_id in 0..count {
+                segments.push(MemShardSegment {
+                    mem_id,
+                    segment_id: first_segment_id + segment_id,
+                    checkpoints: CppMemCheckPoint::from_cpp(self, mem_id, segment_id).to_vec(),
+                });
+            }
+        }
+        segments
+    }
+}
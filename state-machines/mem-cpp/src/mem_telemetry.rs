@@ -0,0 +1,221 @@
+use std::fmt::Write;
+
+use crate::{bindings, MemPlanner};
+
+/// Telemetry events emitted by the C++ count and plan threads (see `mem_telemetry.hpp`).
+pub const MEM_EVENT_COUNT_PHASE_BEGIN: u16 = 1;
+pub const MEM_EVENT_COUNT_PHASE_END: u16 = 2;
+pub const MEM_EVENT_PLAN_PHASE_BEGIN: u16 = 3;
+pub const MEM_EVENT_PLAN_PHASE_END: u16 = 4;
+pub const MEM_EVENT_CHUNK_COUNTED: u16 = 5;
+pub const MEM_EVENT_LOCATOR_EMITTED: u16 = 6;
+pub const MEM_EVENT_SEGMENT_CLOSED: u16 = 7;
+pub const MEM_EVENT_WAIT_START: u16 = 8;
+pub const MEM_EVENT_WAIT_END: u16 = 9;
+pub const MEM_EVENT_THREAD_CPU: u16 = 10;
+
+/// Environment variable with the path where the Chrome trace is saved by `report_telemetry`
+const MEM_TRACE_FILE_ENV: &str = "MEM_CPP_TRACE_FILE";
+
+/// Number of drained events requested on each call to C++
+const DRAIN_BATCH_SIZE: usize = 4096;
+
+/// Represents a telemetry event, with the same layout as C++ `MemTelemetryEvent`
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct MemTelemetryEvent {
+    /// Monotonic clock timestamp in nanoseconds
+    pub timestamp_ns: u64,
+    /// Event argument: chunk id, locator index, segment id or cpu
+    pub value: u32,
+    pub event: u16,
+    /// Thread slot that emitted the event
+    pub slot: u16,
+}
+
+/// Per-thread aggregation of telemetry events
+#[derive(Debug, Clone, Default)]
+pub struct MemTelemetrySlotSummary {
+    pub slot: u16,
+    /// Cpu where the thread started, after pinning
+    pub cpu: Option<u32>,
+    pub chunks_counted: u32,
+    pub locators_emitted: u32,
+    pub segments_closed: u32,
+    pub waits: u32,
+    pub wait_ns: u64,
+    pub first_ns: u64,
+    pub last_ns: u64,
+}
+
+/// Structured summary of a count and plan execution
+#[derive(Debug, Clone, Default)]
+pub struct MemTelemetrySummary {
+    pub count_phase_ns: u64,
+    pub plan_phase_ns: u64,
+    pub dropped: u64,
+    pub slots: Vec<MemTelemetrySlotSummary>,
+}
+
+impl MemTelemetryEvent {
+    pub fn name(&self) -> &'static str {
+        match self.event {
+            MEM_EVENT_COUNT_PHASE_BEGIN | MEM_EVENT_COUNT_PHASE_END => "count_phase",
+            MEM_EVENT_PLAN_PHASE_BEGIN | MEM_EVENT_PLAN_PHASE_END => "plan_phase",
+            MEM_EVENT_CHUNK_COUNTED => "chunk_counted",
+            MEM_EVENT_LOCATOR_EMITTED => "locator_emitted",
+            MEM_EVENT_SEGMENT_CLOSED => "segment_closed",
+            MEM_EVENT_WAIT_START | MEM_EVENT_WAIT_END => "wait",
+            MEM_EVENT_THREAD_CPU => "thread_cpu",
+            _ => "unknown",
+        }
+    }
+}
+
+impl MemPlanner {
+    /// Drains all pending telemetry events of all C++ threads, sorted by timestamp.
+    ///
+    /// Telemetry is always active; events not drained are released with the planner.
+    pub fn drain_telemetry(&self) -> Vec<MemTelemetryEvent> {
+        let mut events: Vec<MemTelemetryEvent> = Vec::new();
+        loop {
+            let len = events.len();
+            events.resize(len + DRAIN_BATCH_SIZE, MemTelemetryEvent::default());
+            let count = unsafe {
+                bindings::drain_mem_telemetry(
+                    self.inner(),
+                    events.as_mut_ptr().add(len) as *mut bindings::MemTelemetryEvent,
+                    DRAIN_BATCH_SIZE as u32,
+                )
+            } as usize;
+            events.truncate(len + count);
+            if count < DRAIN_BATCH_SIZE {
+                break;
+            }
+        }
+        events.sort_by_key(|event| event.timestamp_ns);
+        events
+    }
+
+    /// Number of telemetry events discarded because a thread ring was full.
+    pub fn telemetry_dropped(&self) -> u64 {
+        unsafe { bindings::get_mem_telemetry_dropped(self.inner()) }
+    }
+
+    /// Drains telemetry events and aggregates them in a summary by thread slot.
+    pub fn telemetry_summary(&self) -> MemTelemetrySummary {
+        let events = self.drain_telemetry();
+        MemTelemetrySummary::from_events(&events, self.telemetry_dropped())
+    }
+
+    /// Drains telemetry events and reports them: the summary is logged at debug level and,
+    /// when `MEM_CPP_TRACE_FILE` is defined, the events are saved there as Chrome trace.
+    pub fn report_telemetry(&self) {
+        let events = self.drain_telemetry();
+        if let Ok(path) = std::env::var(MEM_TRACE_FILE_ENV) {
+            if let Err(e) = std::fs::write(&path, to_chrome_trace(&events)) {
+                tracing::warn!("Failed to write mem telemetry trace {}: {}", path, e);
+            }
+        }
+        let summary = MemTelemetrySummary::from_events(&events, self.telemetry_dropped());
+        tracing::debug!(
+            "MemCountAndPlan count_phase:{:.2}ms plan_phase:{:.2}ms dropped:{}",
+            summary.count_phase_ns as f64 / 1e6,
+            summary.plan_phase_ns as f64 / 1e6,
+            summary.dropped
+        );
+        for slot in summary.slots.iter().filter(|slot| slot.first_ns != 0) {
+            tracing::debug!(
+                "MemCountAndPlan slot:{} cpu:{:?} chunks:{} locators:{} segments:{} waits:{} wait:{:.2}ms",
+                slot.slot,
+                slot.cpu,
+                slot.chunks_counted,
+                slot.locators_emitted,
+                slot.segments_closed,
+                slot.waits,
+                slot.wait_ns as f64 / 1e6
+            );
+        }
+    }
+
+    /// Drains telemetry events and returns them in Chrome trace format (JSON), ready to be
+    /// loaded on `chrome://tracing` or Perfetto.
+    pub fn telemetry_chrome_trace(&self) -> String {
+        to_chrome_trace(&self.drain_telemetry())
+    }
+}
+
+impl MemTelemetrySummary {
+    pub fn from_events(events: &[MemTelemetryEvent], dropped: u64) -> Self {
+        let mut summary = MemTelemetrySummary { dropped, ..Default::default() };
+        let mut wait_start: Vec<Option<u64>> = Vec::new();
+        let mut phase_start = [0u64; 2];
+
+        for event in events {
+            let slot = event.slot as usize;
+            if summary.slots.len() <= slot {
+                summary.slots.resize_with(slot + 1, Default::default);
+                wait_start.resize(slot + 1, None);
+            }
+            let stats = &mut summary.slots[slot];
+            stats.slot = event.slot;
+            if stats.first_ns == 0 {
+                stats.first_ns = event.timestamp_ns;
+            }
+            stats.last_ns = event.timestamp_ns;
+            match event.event {
+                MEM_EVENT_COUNT_PHASE_BEGIN => phase_start[0] = event.timestamp_ns,
+                MEM_EVENT_COUNT_PHASE_END => {
+                    summary.count_phase_ns = event.timestamp_ns.saturating_sub(phase_start[0])
+                }
+                MEM_EVENT_PLAN_PHASE_BEGIN => phase_start[1] = event.timestamp_ns,
+                MEM_EVENT_PLAN_PHASE_END => {
+                    summary.plan_phase_ns = event.timestamp_ns.saturating_sub(phase_start[1])
+                }
+                MEM_EVENT_CHUNK_COUNTED => stats.chunks_counted += 1,
+                MEM_EVENT_LOCATOR_EMITTED => stats.locators_emitted += 1,
+                MEM_EVENT_SEGMENT_CLOSED => stats.segments_closed += 1,
+                MEM_EVENT_THREAD_CPU => stats.cpu = Some(event.value),
+                MEM_EVENT_WAIT_START => wait_start[slot] = Some(event.timestamp_ns),
+                MEM_EVENT_WAIT_END => {
+                    if let Some(start) = wait_start[slot].take() {
+                        stats.waits += 1;
+                        stats.wait_ns += event.timestamp_ns.saturating_sub(start);
+                    }
+                }
+                _ => {}
+            }
+        }
+        summary
+    }
+}
+
+/// Converts a list of events, sorted by timestamp, to Chrome trace format (JSON). Phases and
+/// waits are emitted as duration events, the rest as instant events.
+pub fn to_chrome_trace(events: &[MemTelemetryEvent]) -> String {
+    let origin_ns = events.first().map(|event| event.timestamp_ns).unwrap_or(0);
+    let mut out = String::from("{\"traceEvents\":[");
+    for (index, event) in events.iter().enumerate() {
+        let ph = match event.event {
+            MEM_EVENT_COUNT_PHASE_BEGIN | MEM_EVENT_PLAN_PHASE_BEGIN | MEM_EVENT_WAIT_START => "B",
+            MEM_EVENT_COUNT_PHASE_END | MEM_EVENT_PLAN_PHASE_END | MEM_EVENT_WAIT_END => "E",
+            _ => "i",
+        };
+        let ts_us = (event.timestamp_ns - origin_ns) as f64 / 1000.0;
+        if index > 0 {
+            out.push(',');
+        }
+        let _ = write!(
+            out,
+            "{{\"name\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3},\"pid\":1,\"tid\":{},\"args\":{{\"value\":{}}}{}}}",
+            event.name(),
+            ph,
+            ts_us,
+            event.slot,
+            event.value,
+            if ph == "i" { ",\"s\":\"t\"" } else { "" }
+        );
+    }
+    out.push_str("]}");
+    out
+}
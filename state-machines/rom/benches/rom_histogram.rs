@@ -0,0 +1,143 @@
+#[macro_use]
+extern crate criterion;
+
+use asm_runner::AsmRHData;
+use criterion::{BatchSize, BenchmarkId, Criterion};
+use fields::{Field, Goldilocks, PrimeField64};
+use itertools::Itertools;
+use sm_rom::RomSM;
+use zisk_core::{ZiskInstBuilder, ZiskRom, ROM_ADDR, ROM_ENTRY, ROM_EXIT};
+use zisk_pil::{MainTrace, RomTrace};
+
+type F = Goldilocks;
+
+const BIOS_INSTRUCTIONS: usize = 1 << 12;
+const PROG_INSTRUCTIONS: usize = (1 << 22) - BIOS_INSTRUCTIONS;
+const STEPS: u64 = 1 << 30;
+
+// ROM with consecutive BIOS and program instructions, with the lookup tables and sorted pc list
+// built as elf2rom does
+fn synthetic_rom() -> ZiskRom {
+    let mut rom = ZiskRom::default();
+    let bios_pcs = (0..BIOS_INSTRUCTIONS as u64).map(|i| ROM_ENTRY + (i << 2));
+    let prog_pcs = (0..PROG_INSTRUCTIONS as u64).map(|i| ROM_ADDR + (i << 2));
+    rom.sorted_pc_list = bios_pcs.chain(prog_pcs).collect();
+    rom.min_program_pc = ROM_ADDR;
+    rom.max_bios_pc = ROM_ENTRY + ((BIOS_INSTRUCTIONS as u64 - 1) << 2);
+    rom.max_program_pc = ROM_ADDR + ((PROG_INSTRUCTIONS as u64 - 1) << 2);
+
+    for (row, &pc) in rom.sorted_pc_list.iter().enumerate() {
+        let mut inst = ZiskInstBuilder::new(pc);
+        inst.i.sorted_pc_list_index = row;
+        if pc < ROM_ADDR {
+            rom.rom_entry_instructions.push(inst.i.clone());
+        } else {
+            rom.rom_instructions.push(inst.i.clone());
+        }
+        rom.insts.insert(pc, inst);
+    }
+    rom
+}
+
+// Histogram with one in `stride` instructions executed, as a guest that only runs a small part of
+// a large ROM. The program counters are indexed by byte offset, the BIOS ones by instruction
+fn synthetic_histogram(stride: usize) -> AsmRHData {
+    let mut seed: u64 = 0x2545_f491_4f6c_dd1d;
+    let mut count = || {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        1 + (seed & 0xffff)
+    };
+
+    let mut bios_inst_count = vec![0u64; BIOS_INSTRUCTIONS];
+    for idx in (0..BIOS_INSTRUCTIONS).step_by(stride) {
+        bios_inst_count[idx] = count();
+    }
+    bios_inst_count[((ROM_EXIT - ROM_ENTRY) >> 2) as usize] = 1;
+
+    let mut prog_inst_count = vec![0u64; PROG_INSTRUCTIONS << 2];
+    for idx in (0..PROG_INSTRUCTIONS).step_by(stride) {
+        prog_inst_count[idx << 2] = count();
+    }
+
+    AsmRHData::new(STEPS, bios_inst_count, prog_inst_count)
+}
+
+fn zeroed_trace() -> RomTrace<F> {
+    let trace_buffer = vec![F::ZERO; RomTrace::<F>::NUM_ROWS * RomTrace::<F>::ROW_SIZE];
+    RomTrace::new_from_vec_zeroes(trace_buffer).unwrap()
+}
+
+// Previous witness computation, walking every ROM instruction in pc order and looking up its
+// counter in the dense histograms
+fn dense_walk(rom: &ZiskRom, asm_romh: &AsmRHData, rom_trace: &mut RomTrace<F>) {
+    let main_trace_len = MainTrace::<F>::NUM_ROWS as u64;
+
+    for (i, key) in rom.insts.keys().sorted().enumerate() {
+        let inst = &rom.insts[key].i;
+        let mut multiplicity: u64;
+        if inst.paddr < ROM_ADDR {
+            if asm_romh.bios_inst_count.is_empty() {
+                multiplicity = 1;
+            } else {
+                multiplicity = asm_romh.bios_inst_count[((inst.paddr - ROM_ENTRY) as usize) >> 2];
+                if multiplicity == 0 {
+                    continue;
+                }
+                if inst.paddr == ROM_EXIT {
+                    multiplicity += main_trace_len - asm_romh.steps % main_trace_len;
+                }
+            }
+        } else {
+            multiplicity = asm_romh.prog_inst_count[(inst.paddr - ROM_ADDR) as usize];
+            if multiplicity == 0 {
+                continue;
+            }
+        }
+        rom_trace[i].multiplicity = F::from_u64(multiplicity);
+    }
+}
+
+fn bench_rom_histogram(c: &mut Criterion) {
+    let rom = synthetic_rom();
+
+    let mut group = c.benchmark_group("RomHistogramWitness");
+    for stride in [1usize, 16, 256] {
+        let asm_romh = synthetic_histogram(stride);
+
+        // Both must give the same multiplicities
+        let mut expected = zeroed_trace();
+        dense_walk(&rom, &asm_romh, &mut expected);
+        let mut found = zeroed_trace();
+        RomSM::set_multiplicities_from_asm(&rom, &asm_romh, &mut found).unwrap();
+        assert!(expected
+            .buffer
+            .iter()
+            .zip(found.buffer.iter())
+            .all(|(expected, found)| expected.multiplicity == found.multiplicity));
+
+        group.bench_with_input(BenchmarkId::new("dense_walk", stride), &stride, |b, _| {
+            b.iter_batched_ref(
+                zeroed_trace,
+                |rom_trace| dense_walk(&rom, &asm_romh, rom_trace),
+                BatchSize::LargeInput,
+            )
+        });
+        group.bench_with_input(BenchmarkId::new("sparse_scatter", stride), &stride, |b, _| {
+            b.iter_batched_ref(
+                zeroed_trace,
+                |rom_trace| RomSM::set_multiplicities_from_asm(&rom, &asm_romh, rom_trace).unwrap(),
+                BatchSize::LargeInput,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group! {
+    name = benches;
+    config = Criterion::default().sample_size(10);
+    targets = bench_rom_histogram
+}
+criterion_main!(benches);
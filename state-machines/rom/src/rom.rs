@@ -21,7 +21,8 @@ use crate::{RomInstance, RomPlanner};
 use asm_runner::{AsmRHData, AsmRunnerRH};
 use fields::PrimeField64;
 use itertools::Itertools;
-use proofman_common::{AirInstance, FromTrace, ProofmanResult};
+use proofman_common::{AirInstance, FromTrace, ProofmanError, ProofmanResult};
+use rayon::prelude::*;
 use zisk_common::{
     create_atomic_vec, BusDeviceMetrics, ComponentBuilder, CounterStats, Instance, InstanceCtx,
     Planner,
@@ -31,6 +32,10 @@ use zisk_core::{
 };
 use zisk_pil::{MainTrace, RomRomTrace, RomRomTraceRow, RomTrace};
 
+/// Number of trace rows filled by each task when scattering the multiplicities of the executed
+/// instructions.
+const SCATTER_BLOCK_ROWS: usize = 1 << 14;
+
 /// The `RomSM` struct represents the ROM State Machine
 pub struct RomSM {
     /// Zisk Rom
@@ -157,6 +162,15 @@ impl RomSM {
         Ok(AirInstance::new_from_trace(FromTrace::new(&mut rom_trace)))
     }
 
+    /// Computes the witness from the ROM histogram of the assembly emulator.
+    ///
+    /// # Arguments
+    /// * `rom` - Reference to the Zisk ROM.
+    /// * `asm_romh` - The ROM histogram.
+    /// * `trace_buffer` - Buffer of the ROM trace.
+    ///
+    /// # Returns
+    /// An `AirInstance` containing the computed witness trace data.
     pub fn compute_witness_from_asm<F: PrimeField64>(
         rom: &ZiskRom,
         asm_romh: &AsmRHData,
@@ -166,44 +180,91 @@ impl RomSM {
 
         tracing::debug!("··· Creating Rom instance [{} rows]", RomTrace::<F>::NUM_ROWS);
 
-        let main_trace_len = MainTrace::<F>::NUM_ROWS as u64;
-
-        for (i, key) in rom.insts.keys().sorted().enumerate() {
-            // Get the Zisk instruction
-            let inst = &rom.insts[key].i;
+        Self::set_multiplicities_from_asm(rom, asm_romh, &mut rom_trace)?;
 
-            // Calculate the multiplicity, i.e. the number of times this pc is used in this
-            // execution
-            let mut multiplicity: u64;
-            if inst.paddr < ROM_ADDR {
-                if asm_romh.bios_inst_count.is_empty() {
-                    multiplicity = 1; // If the histogram is empty, we use 1 for all pc's
-                } else {
-                    let idx = ((inst.paddr - ROM_ENTRY) as usize) >> 2;
-
-                    multiplicity = asm_romh.bios_inst_count[idx];
+        Ok(AirInstance::new_from_trace(FromTrace::new(&mut rom_trace)))
+    }
 
-                    if multiplicity == 0 {
-                        continue;
-                    }
+    /// Sets the multiplicities of a zeroed ROM trace from the ROM histogram of the assembly
+    /// emulator.
+    ///
+    /// Only the executed instructions are visited: their trace rows are resolved in parallel from
+    /// the sparse histogram, and the multiplicities are scattered into the trace by blocks of rows.
+    ///
+    /// # Arguments
+    /// * `rom` - Reference to the Zisk ROM.
+    /// * `asm_romh` - The ROM histogram.
+    /// * `rom_trace` - The ROM trace, with all the multiplicities set to zero.
+    pub fn set_multiplicities_from_asm<F: PrimeField64>(
+        rom: &ZiskRom,
+        asm_romh: &AsmRHData,
+        rom_trace: &mut RomTrace<F>,
+    ) -> ProofmanResult<()> {
+        let main_trace_len = MainTrace::<F>::NUM_ROWS as u64;
+        let exit_padding = main_trace_len - asm_romh.steps % main_trace_len;
+
+        // Trace row and multiplicity of every executed instruction, sorted by row. The rows follow
+        // the pc order, so the BIOS instructions come first
+        let mut multiplicities: Vec<(usize, u64)> = if asm_romh.bios_inst_count.is_empty() {
+            // If the histogram is empty, we use 1 for all the BIOS pc's
+            let bios_rows = rom.sorted_pc_list.partition_point(|&pc| pc < ROM_ADDR);
+            (0..bios_rows).map(|row| (row, 1)).collect()
+        } else {
+            asm_romh
+                .bios_executed
+                .par_iter()
+                .map(|&(idx, count)| {
+                    let pc = ROM_ENTRY + ((idx as u64) << 2);
+                    let multiplicity = if pc == ROM_EXIT { count + exit_padding } else { count };
+                    Ok((Self::trace_row(rom, pc)?, multiplicity))
+                })
+                .collect::<ProofmanResult<_>>()?
+        };
+        let prog_multiplicities: Vec<(usize, u64)> = asm_romh
+            .prog_executed
+            .par_iter()
+            .map(|&(idx, count)| Ok((Self::trace_row(rom, ROM_ADDR + idx as u64)?, count)))
+            .collect::<ProofmanResult<_>>()?;
+        multiplicities.extend(prog_multiplicities);
+
+        // The scatter looks up the rows of each block with a binary search
+        if !multiplicities.par_windows(2).all(|pair| pair[0].0 < pair[1].0) {
+            return Err(ProofmanError::ProofmanError(
+                "ROM histogram instructions are not sorted by trace row".into(),
+            ));
+        }
 
-                    if inst.paddr == ROM_EXIT {
-                        multiplicity += main_trace_len - asm_romh.steps % main_trace_len;
-                    }
+        rom_trace.buffer.par_chunks_mut(SCATTER_BLOCK_ROWS).enumerate().for_each(
+            |(block, rows)| {
+                let first_row = block * SCATTER_BLOCK_ROWS;
+                let end_row = first_row + rows.len();
+                let from = multiplicities.partition_point(|&(row, _)| row < first_row);
+                for &(row, multiplicity) in
+                    multiplicities[from..].iter().take_while(|&&(row, _)| row < end_row)
+                {
+                    rows[row - first_row].multiplicity = F::from_u64(multiplicity);
                 }
-            } else {
-                let idx = (inst.paddr - ROM_ADDR) as usize;
-                multiplicity = asm_romh.prog_inst_count[idx];
+            },
+        );
 
-                if multiplicity == 0 {
-                    continue;
-                }
-            }
+        Ok(())
+    }
 
-            rom_trace[i].multiplicity = F::from_u64(multiplicity);
+    /// Returns the row of the ROM trace of the instruction at `pc`, its position in the sorted
+    /// list of pc's.
+    ///
+    /// The row is checked against the sorted list of pc's: the lookup tables of the ROM have
+    /// default instructions (row 0) in the gaps between instructions, so a histogram that doesn't
+    /// match the ROM would silently count its pc's in the wrong rows.
+    #[inline(always)]
+    fn trace_row(rom: &ZiskRom, pc: u64) -> ProofmanResult<usize> {
+        let row = rom.get_instruction(pc).sorted_pc_list_index;
+        if rom.sorted_pc_list.get(row) != Some(&pc) {
+            return Err(ProofmanError::ProofmanError(format!(
+                "ROM histogram pc 0x{pc:X} isn't an instruction of the ROM"
+            )));
         }
-
-        Ok(AirInstance::new_from_trace(FromTrace::new(&mut rom_trace)))
+        Ok(row)
     }
 
     /// Computes the ROM trace based on the ROM instructions.
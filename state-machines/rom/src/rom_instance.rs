@@ -9,6 +9,7 @@ use std::{
         Arc,
     },
     thread::JoinHandle,
+    time::Instant,
 };
 
 use crate::{rom_counter::RomCounter, RomSM};
@@ -142,11 +143,22 @@ impl<F: PrimeField64> Instance<F> for RomInstance {
             *self.prog_inst_count.lock().unwrap() =
                 Arc::new(create_atomic_vec(result_rh.asm_rowh_output.prog_inst_count.len()));
 
-            return Ok(Some(RomSM::compute_witness_from_asm(
+            let witness_start = Instant::now();
+            let air_instance = RomSM::compute_witness_from_asm(
                 &self.zisk_rom,
                 &result_rh.asm_rowh_output,
                 trace_buffer,
-            )?));
+            )?;
+            tracing::info!(
+                "··· ROM witness of {} executed instructions computed in {} ms, {} ms after the end of the execution ({} ms building the histogram)",
+                result_rh.asm_rowh_output.bios_executed.len()
+                    + result_rh.asm_rowh_output.prog_executed.len(),
+                witness_start.elapsed().as_millis(),
+                result_rh.execution_end.elapsed().as_millis(),
+                result_rh.ready_time.duration_since(result_rh.execution_end).as_millis(),
+            );
+
+            return Ok(Some(air_instance));
         }
 
         // Case 2: Fallback to counter stats when not using assembly
@@ -0,0 +1,70 @@
+//! fcall_secp256k1_scalar_mul, fcall_bn254_scalar_mul and fcall_bls12_381_scalar_mul free calls
+use cfg_if::cfg_if;
+cfg_if! {
+    if #[cfg(all(target_os = "zkvm", target_vendor = "zisk"))] {
+        use core::arch::asm;
+        use crate::{ziskos_fcall, ziskos_fcall_get, ziskos_fcall_param};
+        use super::{
+            FCALL_BLS12_381_SCALAR_MUL_ID, FCALL_BN254_SCALAR_MUL_ID, FCALL_SECP256K1_SCALAR_MUL_ID,
+        };
+    }
+}
+
+/// Computes the scalar multiplication `k·p` of a point `p` on the `secp256k1` curve.
+///
+/// The point is given in affine coordinates as `[x, y]` and the result is returned in the same
+/// format, with the point at infinity represented as `(0, 1)`. The host computes the whole
+/// multiplication in Jacobian coordinates, with a single inversion at the end.
+///
+/// Note that this is a *free-input call*, meaning the Zisk VM does not automatically verify the correctness
+/// of the result. It is the caller's responsibility to ensure it.
+#[allow(unused_variables)]
+pub fn fcall_secp256k1_scalar_mul(p_value: &[u64; 8], k_value: &[u64; 4]) -> [u64; 8] {
+    #[cfg(not(all(target_os = "zkvm", target_vendor = "zisk")))]
+    unreachable!();
+    #[cfg(all(target_os = "zkvm", target_vendor = "zisk"))]
+    {
+        ziskos_fcall_param!(p_value, 8);
+        ziskos_fcall_param!(k_value, 4);
+        ziskos_fcall!(FCALL_SECP256K1_SCALAR_MUL_ID);
+        core::array::from_fn(|_| ziskos_fcall_get())
+    }
+}
+
+/// Computes the scalar multiplication `k·p` of a point `p` on the `bn254` curve.
+///
+/// Same format as [`fcall_secp256k1_scalar_mul`].
+///
+/// Note that this is a *free-input call*, meaning the Zisk VM does not automatically verify the correctness
+/// of the result. It is the caller's responsibility to ensure it.
+#[allow(unused_variables)]
+pub fn fcall_bn254_scalar_mul(p_value: &[u64; 8], k_value: &[u64; 4]) -> [u64; 8] {
+    #[cfg(not(all(target_os = "zkvm", target_vendor = "zisk")))]
+    unreachable!();
+    #[cfg(all(target_os = "zkvm", target_vendor = "zisk"))]
+    {
+        ziskos_fcall_param!(p_value, 8);
+        ziskos_fcall_param!(k_value, 4);
+        ziskos_fcall!(FCALL_BN254_SCALAR_MUL_ID);
+        core::array::from_fn(|_| ziskos_fcall_get())
+    }
+}
+
+/// Computes the scalar multiplication `k·p` of a point `p` on the `bls12_381` curve.
+///
+/// Same format as [`fcall_secp256k1_scalar_mul`], with 6 u64 per coordinate.
+///
+/// Note that this is a *free-input call*, meaning the Zisk VM does not automatically verify the correctness
+/// of the result. It is the caller's responsibility to ensure it.
+#[allow(unused_variables)]
+pub fn fcall_bls12_381_scalar_mul(p_value: &[u64; 12], k_value: &[u64; 4]) -> [u64; 12] {
+    #[cfg(not(all(target_os = "zkvm", target_vendor = "zisk")))]
+    unreachable!();
+    #[cfg(all(target_os = "zkvm", target_vendor = "zisk"))]
+    {
+        ziskos_fcall_param!(p_value, 12);
+        ziskos_fcall_param!(k_value, 4);
+        ziskos_fcall!(FCALL_BLS12_381_SCALAR_MUL_ID);
+        core::array::from_fn(|_| ziskos_fcall_get())
+    }
+}
@@ -18,6 +18,12 @@ pub const FCALL_MSB_POS_384_ID: u16 = 15;
 pub const FCALL_BIG_INT256_DIV_ID: u16 = 16;
 pub const FCALL_BIG_INT_DIV_ID: u16 = 17;
 pub const FCALL_BIN_DECOMP_ID: u16 = 18;
+pub const FCALL_SECP256K1_SCALAR_MUL_ID: u16 = 19;
+pub const FCALL_BN254_SCALAR_MUL_ID: u16 = 20;
+pub const FCALL_BLS12_381_SCALAR_MUL_ID: u16 = 21;
+pub const FCALL_SECP256R1_FP_INV_ID: u16 = 22;
+pub const FCALL_SECP256R1_FN_INV_ID: u16 = 23;
+pub const FCALL_SECP256R1_FP_SQRT_ID: u16 = 24;
 
 mod big_int256_div;
 mod big_int_div;
@@ -29,11 +35,15 @@ mod bls12_381_twist;
 mod bn254_fp;
 mod bn254_fp2;
 mod bn254_twist;
+mod curve_scalar_mul;
 mod msb_pos_256;
 mod msb_pos_384;
 mod secp256k1_fn_inv;
 mod secp256k1_fp_inv;
 mod secp256k1_fp_sqrt;
+mod secp256r1_fn_inv;
+mod secp256r1_fp_inv;
+mod secp256r1_fp_sqrt;
 
 pub use big_int256_div::*;
 pub use big_int_div::*;
@@ -45,8 +55,12 @@ pub use bls12_381_twist::*;
 pub use bn254_fp::*;
 pub use bn254_fp2::*;
 pub use bn254_twist::*;
+pub use curve_scalar_mul::*;
 pub use msb_pos_256::*;
 pub use msb_pos_384::*;
 pub use secp256k1_fn_inv::*;
 pub use secp256k1_fp_inv::*;
 pub use secp256k1_fp_sqrt::*;
+pub use secp256r1_fn_inv::*;
+pub use secp256r1_fp_inv::*;
+pub use secp256r1_fp_sqrt::*;
@@ -0,0 +1,135 @@
+use lazy_static::lazy_static;
+use num_bigint::BigUint;
+use num_traits::{One, Zero};
+
+use super::utils::{biguint_from_u64_digits, n_u64_digits_from_biguint};
+
+lazy_static! {
+    static ref SECP256K1_P: BigUint = BigUint::parse_bytes(
+        b"fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f",
+        16
+    )
+    .unwrap();
+    static ref BN254_P: BigUint = BigUint::parse_bytes(
+        b"30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47",
+        16
+    )
+    .unwrap();
+    static ref BLS12_381_P: BigUint = BigUint::parse_bytes(
+        b"1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab",
+        16
+    )
+    .unwrap();
+}
+
+/// Computes k·P on the `secp256k1` curve, P as 8 u64 followed by k as 4 u64
+pub fn fcall_secp256k1_scalar_mul(params: &[u64], results: &mut [u64]) -> i64 {
+    curve_scalar_mul::<4>(&SECP256K1_P, params, results)
+}
+
+/// Computes k·P on the `bn254` curve, P as 8 u64 followed by k as 4 u64
+pub fn fcall_bn254_scalar_mul(params: &[u64], results: &mut [u64]) -> i64 {
+    curve_scalar_mul::<4>(&BN254_P, params, results)
+}
+
+/// Computes k·P on the `bls12_381` curve, P as 12 u64 followed by k as 4 u64
+pub fn fcall_bls12_381_scalar_mul(params: &[u64], results: &mut [u64]) -> i64 {
+    curve_scalar_mul::<6>(&BLS12_381_P, params, results)
+}
+
+/// Point in Jacobian coordinates (X/Z², Y/Z³), the point at infinity has Z = 0
+struct JacobianPoint {
+    x: BigUint,
+    y: BigUint,
+    z: BigUint,
+}
+
+fn sub_mod(a: &BigUint, b: &BigUint, p: &BigUint) -> BigUint {
+    (a + p - b) % p
+}
+
+/// Doubling on y² = x³ + b (dbl-2009-l)
+fn jacobian_dbl(pt: &JacobianPoint, p: &BigUint) -> JacobianPoint {
+    let a = (&pt.x * &pt.x) % p;
+    let b = (&pt.y * &pt.y) % p;
+    let c = (&b * &b) % p;
+    let xb = (&pt.x + &b) % p;
+    let d = (sub_mod(&sub_mod(&((&xb * &xb) % p), &a, p), &c, p) * 2u64) % p;
+    let e = (&a * 3u64) % p;
+    let f = (&e * &e) % p;
+    let x = sub_mod(&f, &((&d * 2u64) % p), p);
+    let y = sub_mod(&((&e * sub_mod(&d, &x, p)) % p), &((&c * 8u64) % p), p);
+    let z = (&pt.y * &pt.z * 2u64) % p;
+    JacobianPoint { x, y, z }
+}
+
+/// Mixed addition of an affine point (qx, qy) different from infinity (madd-2007-bl)
+fn jacobian_add_affine(
+    pt: &JacobianPoint,
+    qx: &BigUint,
+    qy: &BigUint,
+    p: &BigUint,
+) -> JacobianPoint {
+    if pt.z.is_zero() {
+        return JacobianPoint { x: qx.clone(), y: qy.clone(), z: BigUint::one() };
+    }
+    let z1z1 = (&pt.z * &pt.z) % p;
+    let u2 = (qx * &z1z1) % p;
+    let s2 = (qy * &pt.z * &z1z1) % p;
+    let h = sub_mod(&u2, &pt.x, p);
+    let r = sub_mod(&s2, &pt.y, p);
+    if h.is_zero() {
+        if r.is_zero() {
+            return jacobian_dbl(pt, p);
+        }
+        return JacobianPoint { x: BigUint::one(), y: BigUint::one(), z: BigUint::zero() };
+    }
+    let r = (r * 2u64) % p;
+    let hh = (&h * &h) % p;
+    let i = (&hh * 4u64) % p;
+    let j = (&h * &i) % p;
+    let v = (&pt.x * &i) % p;
+    let x = sub_mod(&sub_mod(&((&r * &r) % p), &j, p), &((&v * 2u64) % p), p);
+    let y = sub_mod(&((&r * sub_mod(&v, &x, p)) % p), &((&pt.y * &j * 2u64) % p), p);
+    let zh = (&pt.z + &h) % p;
+    let z = sub_mod(&sub_mod(&((&zh * &zh) % p), &z1z1, p), &hh, p);
+    JacobianPoint { x, y, z }
+}
+
+/// Double and add over Jacobian coordinates with a single inversion at the end, the point at
+/// infinity is (0, 1) both as input and as output
+fn curve_scalar_mul<const N: usize>(p: &BigUint, params: &[u64], results: &mut [u64]) -> i64 {
+    let px = biguint_from_u64_digits(&params[0..N]) % p;
+    let py = biguint_from_u64_digits(&params[N..2 * N]) % p;
+    let k = &params[2 * N..2 * N + 4];
+
+    let mut acc = JacobianPoint { x: BigUint::one(), y: BigUint::one(), z: BigUint::zero() };
+    if !(px.is_zero() && py.is_one()) {
+        let mut started = false;
+        for limb in (0..4).rev() {
+            for bit in (0..64).rev() {
+                if started {
+                    acc = jacobian_dbl(&acc, p);
+                }
+                if (k[limb] >> bit) & 1 == 1 {
+                    acc = jacobian_add_affine(&acc, &px, &py, p);
+                    started = true;
+                }
+            }
+        }
+    }
+
+    let (x, y) = if acc.z.is_zero() {
+        (BigUint::zero(), BigUint::one())
+    } else {
+        let z_inv = acc.z.modinv(p).unwrap();
+        let z_inv2 = (&z_inv * &z_inv) % p;
+        let x = (&acc.x * &z_inv2) % p;
+        let y = (&acc.y * &z_inv2 * &z_inv) % p;
+        (x, y)
+    };
+    results[0..N].copy_from_slice(&n_u64_digits_from_biguint::<N>(&x));
+    results[N..2 * N].copy_from_slice(&n_u64_digits_from_biguint::<N>(&y));
+
+    (2 * N) as i64
+}
@@ -8,12 +8,16 @@ mod bls12_381_twist;
 mod bn254_fp;
 mod bn254_fp2;
 mod bn254_twist;
+mod curve_scalar_mul;
 mod msb_pos_256;
 mod msb_pos_384;
 mod proxy;
 mod secp256k1_fn_inv;
 mod secp256k1_fp_inv;
 mod secp256k1_fp_sqrt;
+mod secp256r1_fn_inv;
+mod secp256r1_fp_inv;
+mod secp256r1_fp_sqrt;
 mod utils;
 
 pub use proxy::*;
@@ -1,16 +1,19 @@
 use crate::zisklib::{
     FCALL_BIG_INT256_DIV_ID, FCALL_BIG_INT_DIV_ID, FCALL_BIN_DECOMP_ID, FCALL_BLS12_381_FP2_INV_ID,
-    FCALL_BLS12_381_FP_INV_ID, FCALL_BLS12_381_FP_SQRT_ID,
+    FCALL_BLS12_381_FP_INV_ID, FCALL_BLS12_381_FP_SQRT_ID, FCALL_BLS12_381_SCALAR_MUL_ID,
     FCALL_BLS12_381_TWIST_ADD_LINE_COEFFS_ID, FCALL_BLS12_381_TWIST_DBL_LINE_COEFFS_ID,
-    FCALL_BN254_FP2_INV_ID, FCALL_BN254_FP_INV_ID, FCALL_BN254_TWIST_ADD_LINE_COEFFS_ID,
-    FCALL_BN254_TWIST_DBL_LINE_COEFFS_ID, FCALL_MSB_POS_256_ID, FCALL_MSB_POS_384_ID,
-    FCALL_SECP256K1_FN_INV_ID, FCALL_SECP256K1_FP_INV_ID, FCALL_SECP256K1_FP_SQRT_ID,
+    FCALL_BN254_FP2_INV_ID, FCALL_BN254_FP_INV_ID, FCALL_BN254_SCALAR_MUL_ID,
+    FCALL_BN254_TWIST_ADD_LINE_COEFFS_ID, FCALL_BN254_TWIST_DBL_LINE_COEFFS_ID,
+    FCALL_MSB_POS_256_ID, FCALL_MSB_POS_384_ID, FCALL_SECP256K1_FN_INV_ID,
+    FCALL_SECP256K1_FP_INV_ID, FCALL_SECP256K1_FP_SQRT_ID, FCALL_SECP256K1_SCALAR_MUL_ID,
+    FCALL_SECP256R1_FN_INV_ID, FCALL_SECP256R1_FP_INV_ID, FCALL_SECP256R1_FP_SQRT_ID,
 };
 
 use super::{
     big_int256_div::*, big_int_div::*, bin_decomp::*, bls12_381_fp2_inv::*, bls12_381_fp_inv::*,
     bls12_381_fp_sqrt::*, bls12_381_twist::*, bn254_fp::*, bn254_fp2::*, bn254_twist::*,
-    msb_pos_256::*, msb_pos_384::*, secp256k1_fn_inv::*, secp256k1_fp_inv::*, secp256k1_fp_sqrt::*,
+    curve_scalar_mul::*, msb_pos_256::*, msb_pos_384::*, secp256k1_fn_inv::*, secp256k1_fp_inv::*,
+    secp256k1_fp_sqrt::*, secp256r1_fn_inv::*, secp256r1_fp_inv::*, secp256r1_fp_sqrt::*,
 };
 
 pub fn fcall_proxy(id: u64, params: &[u64], results: &mut [u64]) -> i64 {
@@ -36,6 +39,12 @@ pub fn fcall_proxy(id: u64, params: &[u64], results: &mut [u64]) -> i64 {
         FCALL_BIG_INT256_DIV_ID => fcall_big_int256_div(params, results),
         FCALL_BIG_INT_DIV_ID => fcall_big_int_div(params, results),
         FCALL_BIN_DECOMP_ID => fcall_bin_decomp(params, results),
+        FCALL_SECP256K1_SCALAR_MUL_ID => fcall_secp256k1_scalar_mul(params, results),
+        FCALL_BN254_SCALAR_MUL_ID => fcall_bn254_scalar_mul(params, results),
+        FCALL_BLS12_381_SCALAR_MUL_ID => fcall_bls12_381_scalar_mul(params, results),
+        FCALL_SECP256R1_FP_INV_ID => fcall_secp256r1_fp_inv(params, results),
+        FCALL_SECP256R1_FN_INV_ID => fcall_secp256r1_fn_inv(params, results),
+        FCALL_SECP256R1_FP_SQRT_ID => fcall_secp256r1_fp_sqrt(params, results),
         _ => panic!("Unsupported fcall ID {id}"),
     }
 }
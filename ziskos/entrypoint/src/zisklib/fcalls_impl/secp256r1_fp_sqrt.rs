@@ -0,0 +1,111 @@
+use lazy_static::lazy_static;
+use num_bigint::BigUint;
+
+use super::utils::{biguint_from_u64_digits, n_u64_digits_from_biguint};
+
+lazy_static! {
+    pub static ref P: BigUint = BigUint::parse_bytes(
+        b"ffffffff00000001000000000000000000000000ffffffffffffffffffffffff",
+        16
+    )
+    .unwrap();
+
+    pub static ref P_DIV_4: BigUint = BigUint::parse_bytes(
+        b"3fffffffc0000000400000000000000000000000400000000000000000000000",
+        16
+    )
+    .unwrap();
+
+    pub static ref NQR: BigUint = BigUint::from(3u64); // First non-quadratic residue in Fp
+}
+
+pub fn fcall_secp256r1_fp_sqrt(params: &[u64], results: &mut [u64]) -> i64 {
+    // Get the input
+    let a: &[u64; 4] = &params[0..4].try_into().unwrap();
+    let parity = params[4];
+
+    // Perform the square root
+    secp256r1_fp_sqrt(a, parity, results);
+
+    5
+}
+
+fn secp256r1_fp_sqrt(a: &[u64; 4], parity: u64, results: &mut [u64]) {
+    let a_big = biguint_from_u64_digits(a);
+
+    // Attempt to compute the square root of a
+    let mut sqrt = a_big.modpow(&P_DIV_4, &P);
+
+    // Check if a is a quadratic residue
+    let square = (&sqrt * &sqrt) % &*P;
+    let a_is_qr = square == a_big;
+    results[0] = a_is_qr as u64;
+    if !a_is_qr {
+        // Compute the square root of a * NQR instead, which is a quadratic residue
+        let a_nqr = (a_big * &*NQR) % &*P;
+        sqrt = a_nqr.modpow(&P_DIV_4, &P);
+    }
+
+    // Flip the sqrt if needed to match the requested parity, as lib-c does
+    let sqrt_r = n_u64_digits_from_biguint::<4>(&sqrt);
+    let sqrt_parity = (sqrt_r[0] & 1) as u64;
+    if parity != sqrt_parity {
+        sqrt = (&*P - &sqrt) % &*P;
+    }
+
+    results[1..5].copy_from_slice(&n_u64_digits_from_biguint::<4>(&sqrt));
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_sqrt() {
+        let x = [0xc2f3df097baaf5a6, 0x0a50154955562148, 0x7e32c04a9156819e, 0xd854d4578b59b65f];
+        let parity = 1;
+        let params = [x[0], x[1], x[2], x[3], parity];
+        let expected_sqrt =
+            [0xf9ee4256a589409f, 0xa21a3985f17502d0, 0xb3eb393d00dc480c, 0x142def02c537eced];
+
+        let mut results = [0; 5];
+        fcall_secp256r1_fp_sqrt(&params, &mut results);
+        assert_eq!(results[0], 1);
+        assert_eq!(results[1..5], expected_sqrt);
+
+        let parity = 0;
+        let params = [x[0], x[1], x[2], x[3], parity];
+        let expected_sqrt =
+            [0x0611bda95a76bf60, 0x5de5c67b0e8afd2f, 0x4c14c6c2ff23b7f3, 0xebd210fc3ac81313];
+
+        let mut results = [0; 5];
+        fcall_secp256r1_fp_sqrt(&params, &mut results);
+        assert_eq!(results[0], 1);
+        assert_eq!(results[1..5], expected_sqrt);
+    }
+
+    #[test]
+    fn test_no_sqrt() {
+        // p - 1 is not a quadratic residue since p = 3 mod 4, the result is sqrt(-3)
+        let x = [0xfffffffffffffffe, 0x00000000ffffffff, 0x0000000000000000, 0xffffffff00000001];
+        let parity = 1;
+        let params = [x[0], x[1], x[2], x[3], parity];
+        let expected_sqrt =
+            [0xb2c8b31d7033599d, 0x5cd18b37bde7ca7f, 0xc471151c1dec4662, 0x9add512515b70d9e];
+
+        let mut results = [0; 5];
+        fcall_secp256r1_fp_sqrt(&params, &mut results);
+        assert_eq!(results[0], 0);
+        assert_eq!(results[1..5], expected_sqrt);
+
+        let parity = 0;
+        let params = [x[0], x[1], x[2], x[3], parity];
+        let expected_sqrt =
+            [0x4d374ce28fcca662, 0xa32e74c942183580, 0x3b8eeae3e213b99d, 0x6522aed9ea48f262];
+
+        let mut results = [0; 5];
+        fcall_secp256r1_fp_sqrt(&params, &mut results);
+        assert_eq!(results[0], 0);
+        assert_eq!(results[1..5], expected_sqrt);
+    }
+}